@@ -2,26 +2,83 @@
 * Developer: Purnima Naik
 * Summary: Program to implement a custom shell and scheduler.
 * The shell will be supporting following commands:
-* 1. c #: Create # child processes
+* 1. c # [name]: Create # child processes, optionally as a gang called 'name'
+*    c # [name] [as=MB] [nofile=#] [cpu=secs]: Create # child processes, with limits of their address space, open files and cpu time
 * 2. l: Display the child process information
+*    l state: Display the child processes in the given state (running, ready, suspended or terminated)
+*    l [--state=state] [--sort=number|pid|state|cpu|iterations] [--top=#] [--page=#]: Filter, sort and page the child processes
+*    l --watch[=secs]: Redraw the rows that changed every secs, till Enter is pressed
+*    l --json: Display the child process information as JSON, written with a single write call
 * 3. q #: Set the quantum time to be # secs
-* 4. b #: Set the burst time to be # secs for FCFS
+*    q #ms: Set the quantum time to be # milliseconds
+*    q auto: Let the scheduler tune the quantum time of every process on the basis of its observed behavior
+* 4. b #: Set the burst time to be # secs of cpu time for FCFS
 * 5. t rr: Set the scheduling algorithm to be round robin
 * 6. t fcfs: Set the scheduling algorithm to be first come first serve
 * 7. k #: Terminate the process, having the process number #
 * 8. r #: Resume the process, having the process number #
 * 9. r all: Resume to run all the processes in ready state
 * 10. s all: Suspend all the processes
+* The 'k', 'r' and 's' commands also accept a selection of processes, for example 'k 10-500', 's 1,4,9' or 'r group:name'.
+* Every gang, and all the other child processes together, are created in their own process group, so that a selection covering
+* a whole group is signalled with one killpg() call regardless of the number of processes in it.
 * 11. x or X: Exit the shell & all child processes
 * 12. clear: Clear the console
 * 13. help: Displays list of commands supported by the shell
+* 14. stats: Display the scheduler statistics, including the quantum time adjustments made by 'q auto'
+* 15. m #: Set the memory budget of the child processes to be # MB (0 removes the budget)
+* 16. tail #: Display the recent output of the process, having the process number #
+* 17. lat: Display the latency histograms of the scheduler (lat reset clears them)
+* 18. y #: Ask the running process, having the process number #, to yield the cpu
+* 19. replay trace.csv [Nx]: Replay the jobs of a trace, compressing its time N times (replay stop ends it, replay shows its progress)
+* Memory Admission Control - When a memory budget is set, a child process is created only if the projected memory usage of the
+* child processes fits in the budget, else its creation is queued until enough memory gets freed. If the child processes exceed the
+* budget, the one having the largest memory usage is suspended, and the scheduler skips it till the usage drops below the budget.
+* Output Capture - The output of every child process goes to its own pipe instead of the terminal. The shell drains all the pipes
+* from its input loop, and moves the output into JOB_LOG_DIRECTORY/process-#.log using tee() and splice(), so the output is never
+* copied through the shell's memory. The recent output of every process is also kept in a second pipe that acts as a ring buffer.
+* Crash Recovery - Every change of the process table and of the scheduler settings is appended to STATE_JOURNAL_FILE before the
+* shell moves on, and the journal is periodically compacted into STATE_SNAPSHOT_FILE. If the shell dies, the next shell replays the
+* snapshot and the journal, and re-adopts the child processes that are still alive through a pidfd, instead of the workload having
+* to be created again. The output of a re-adopted process is not captured anymore, as its pipe was owned by the previous shell.
 * The scheduler will be running processes using the following algorithms:
 * 1) FCFS - In this algorithm, the process that got created first will complete its execution and then only it will move to the next process.
 * For simulation purpose, have also given the provision to enter the burst time. So that every process, will run for the given burst time and will then get terminated.
+* The burst time is measured on the cpu time clock of the process, so the time it spends sleeping or blocked does not use up its burst.
 * If the user does not provide a burst time, only the first non-terminated process will run; to run the subsequent process, the 'k #' command must be used to terminate the current one,
 * and the control c command must be used to pause its execution.
 * 2) Round Robin - Each process in this algorithm will execute one at a time for the specified quantum time.
+* Scheduler Log - The state transitions made by the scheduler, mostly from the signal handlers, are queued in a lock-free log queue
+* instead of being printed right away. The input loop drains the queue with one writev() per batch, so a slow terminal does not
+* stretch the context switches. The shell accepts the following options:
+* --quiet: Only display the scheduler warnings, same as --log-level=warning
+* --no-color: Do not use ANSI colors
+* --log-level=warning|info|debug: Display the scheduler messages up to this level (debug by default)
+* Latency Histograms - The lateness of every alarm, the time from an alarm until SIGCONT is sent, and the time from SIGCONT until the
+* child process is running are recorded in log-linear (HDR style) histograms, displayed with the 'lat' command. A child process reports
+* when it is running again by writing the time it received SIGCONT into a handshake pipe shared by all the child processes.
+* Metrics Export - The scheduler keeps counters of its dispatches, preemptions, alarms, dispatch latency and timer overshoot.
+* Every METRICS_EXPORT_INTERVAL_IN_MILLISECS, they are written in the Prometheus text format into METRICS_FILE, together with the
+* number of processes per state and the cpu time of every process. The file is replaced atomically, so it can be read at any time,
+* for example by the textfile collector of the node exporter.
+* Resource Limits - The limits given to 'c #' are applied with setrlimit() in the child process before it is loaded. A process that
+* exceeds its cpu time limit gets SIGXCPU from the kernel; such a process, like any other process that exits on its own, is reaped
+* when its output pipe gets closed, and the scheduler moves on to the next process if it was running.
+* Control Page - Every child process shares a page of memory (a memfd) with the shell, where it publishes when it started, its
+* iteration count and a heartbeat, which the 'l' command displays. The shell asks a process to yield the cpu by setting the futex word
+* of the page; the process acknowledges it and parks itself on the futex, so it gives up the cpu without being sent a signal.
+* Job Placement - The shell reads the packages, L3 caches and NUMA nodes of its cpus from CPU_TOPOLOGY_DIRECTORY when it starts.
+* Every child process is placed in an L3 cache domain, the members of a gang in the same one, and the others in the least loaded
+* one. Its cpu affinity keeps its migrations within the domain, and set_mempolicy() binds its memory to the NUMA node of the domain.
+* The migrations of the running processes are sampled, and the ones crossing a domain or a node are reported by the 'stats' command.
+* Trace Replay - The 'replay' command reads a trace of jobs, one per line as arrival_secs,command,cpu_secs,rss_mb, and creates
+* a synthetic child process for every job at its arrival offset. The child process allocates the memory of the job, burns its cpu
+* time and exits, so a recorded workload can be run against each scheduling algorithm. The trace is read one job ahead, so a trace
+* of any length is replayed in constant memory. Once all the jobs have exited, the turnaround times and the mean slowdown are displayed.
+* Gang Scheduling - Child processes created together with 'c # name' form a gang. Both the algorithms treat a gang as a single
+* scheduling unit, so all of its members are dispatched, preempted and terminated together, with one batch of signals per switch.
 */
+#define _GNU_SOURCE
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -30,12 +87,73 @@
 #include <signal.h>
 #include <sys/wait.h>
 #include <stdbool.h>
+#include <time.h>
+#include <sys/time.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <sys/stat.h>
+#include <stdarg.h>
+#include <sys/pidfd.h>
+#include <sys/uio.h>
+#include <sys/resource.h>
+#include <limits.h>
+#include <stdint.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#include <sched.h>
+#include <dirent.h>
+#include <linux/mempolicy.h>
 
 #define DELIMITERS " \t\r\n\a"
 #define BUFFER_SIZE 200
-#define MAXIMUM_NUMBER_OF_CHILD_PROCESSES 25 /* Only upto 25 child processes can be created in this shell.*/
+#define MAXIMUM_NUMBER_OF_CHILD_PROCESSES 1024 /* Only upto 1024 child processes can be created in this shell.*/
+#define DESCRIPTORS_PER_CHILD_PROCESS 4 /* Output pipe, both ends of the output ring and the log file, a re-adopted process only has a pidfd */
+#define RESERVED_FILE_DESCRIPTORS 32 /* Descriptors kept free for the shell itself, e.g. stdio, the handshake pipe and /proc files */
+#define NUMBER_OF_BITMAP_WORDS ((MAXIMUM_NUMBER_OF_CHILD_PROCESSES + 63) / 64) /* 64 bit words in a bitmap of child processes */
 #define MAXIMUM_ROUND_ROBIN_QUANTUM_TIME_IN_SECS 180 /* Maximum round robin quantum time in secs */
 #define MINIMUM_FCFS_BURST_TIME_IN_SECS 10 /* Minumum fcfs burst time in secs */
+#define MAXIMUM_NUMBER_OF_GANGS 10 /* Maximum number of gangs (cooperating process groups) */
+#define MAXIMUM_GANG_NAME_LENGTH 20 /* Maximum length of a gang name, including the null terminator */
+#define MINIMUM_AUTO_QUANTUM_TIME_IN_MILLISECS 100 /* Lower bound of the quantum time tuned by 'q auto' */
+#define MAXIMUM_AUTO_QUANTUM_TIME_IN_MILLISECS (MAXIMUM_ROUND_ROBIN_QUANTUM_TIME_IN_SECS * 1000) /* Upper bound of the quantum time tuned by 'q auto' */
+#define TARGET_SWITCH_OVERHEAD_IN_PERCENT 2 /* 'q auto' keeps the context switch overhead of a time slice below this */
+#define TARGET_P99_RESPONSE_TIME_IN_MILLISECS 5000 /* 'q auto' keeps the p99 time a preempted process waits for the cpu below this */
+#define NUMBER_OF_RESPONSE_TIME_SAMPLES 128 /* Recent response times used to compute the p99 */
+#define NUMBER_OF_LOGGED_QUANTUM_ADJUSTMENTS 16 /* Recent quantum time adjustments shown by the 'stats' command */
+#define MAXIMUM_NUMBER_OF_QUEUED_CREATIONS 10 /* Maximum number of 'c #' requests waiting for memory */
+#define DEFAULT_MEMORY_ESTIMATE_IN_KB 1024 /* Projected memory of a new child process, when there is no child process to measure */
+#define JOB_LOG_DIRECTORY "job-logs" /* Directory holding the captured output of the child processes */
+#define JOB_OUTPUT_RING_SIZE 16384 /* Bytes of recent output kept for the 'tail #' command */
+#define STATE_DIRECTORY "scheduler-state" /* Directory holding the state used to recover from a crash of the shell */
+#define STATE_JOURNAL_FILE STATE_DIRECTORY "/journal" /* Changes made since the last snapshot */
+#define STATE_SNAPSHOT_FILE STATE_DIRECTORY "/snapshot" /* Compact copy of the process table and the scheduler settings */
+#define JOURNAL_RECORDS_PER_SNAPSHOT 256 /* The journal is compacted into a snapshot after these many records */
+#define MAXIMUM_STATE_RECORD_LENGTH 128 /* Maximum length of a journal or snapshot record */
+#define LOG_QUEUE_SIZE 256 /* Scheduler messages that can wait in the log queue, a power of 2 */
+#define MAXIMUM_LOG_MESSAGE_LENGTH 192 /* Maximum length of a scheduler message, including the colors */
+#define LATENCY_SUB_BUCKET_BITS 4 /* Every power of 2 is split into 2^4 buckets, so a latency is recorded within 6.25% */
+#define LATENCY_SUB_BUCKET_COUNT (1 << LATENCY_SUB_BUCKET_BITS)
+#define LATENCY_HISTOGRAM_BUCKETS (LATENCY_SUB_BUCKET_COUNT * 29) /* Latencies upto 2^32 microsecs (over an hour) */
+#define HANDSHAKE_DESCRIPTOR 3 /* File descriptor of the handshake pipe in the child processes */
+#define CONTROL_PAGE_DESCRIPTOR 4 /* File descriptor of the control page in the child processes */
+#define HEARTBEAT_TIMEOUT_IN_MILLISECS 3000 /* A running process that has not completed an iteration for this long is not responding */
+#define YIELD_TIMEOUT_IN_MILLISECS 2000 /* Time the 'y #' command waits for the process to yield the cpu */
+#define CPU_TOPOLOGY_DIRECTORY "/sys/devices/system/cpu" /* Directory describing the packages, caches and NUMA nodes of the cpus */
+#define MAXIMUM_NUMBER_OF_CACHE_DOMAINS 64 /* Maximum number of groups of cpus sharing an L3 cache */
+#define MAXIMUM_NUMBER_OF_NUMA_NODES 64 /* Maximum number of NUMA nodes, the size of the node mask given to set_mempolicy */
+#define LIST_ROW_LENGTH 256 /* Maximum length of a row displayed by the 'l' command */
+#define LIST_PAGE_SIZE 50 /* Rows per page of 'l --page=#', when --top=# is not given */
+#define LIST_OUTPUT_BUFFER_SIZE 65536 /* Output of the 'l' command is written out in chunks of this size */
+#define MAXIMUM_TRACE_LINE_LENGTH 512 /* Maximum length of a line of a trace replayed by the 'replay' command */
+#define MAXIMUM_TRACE_JOB_NAME_LENGTH 32 /* Maximum length of a job name displayed while replaying a trace, including the null terminator */
+#define MAXIMUM_REPLAY_SPEEDUP 1000 /* Maximum factor by which the 'replay' command compresses the time of a trace */
+#define METRICS_FILE "scheduler-metrics.prom" /* File holding the scheduler metrics in the Prometheus text format */
+#define METRICS_EXPORT_INTERVAL_IN_MILLISECS 1000 /* Time between two exports of the scheduler metrics */
+#define MEMORY_SAMPLING_INTERVAL_IN_MILLISECS 250 /* Time between two checks of the memory budget, while a budget is set */
+#define MEMORY_RELEASE_HEADROOM_IN_PERCENT 10 /* Throttled processes are made schedulable again once they fit this far below the memory budget */
 
 /*
 * Enum Process States
@@ -51,36 +169,450 @@ enum processStates
     Suspended = 3,
     Terminated = 4
 };
+#define NUMBER_OF_PROCESS_STATES 4
+
+/*
+* Enum Log Levels
+* LogWarning - Scheduler decisions that the user did not ask for, like suspending a process due to memory pressure
+* LogInfo - Alarms, and processes being started, preempted or terminated
+* LogDebug - Every intermediate state transition
+*/
+enum logLevels
+{
+    LogWarning = 1,
+    LogInfo = 2,
+    LogDebug = 3
+};
 
 /*
 * Struct processTable
+* The table is laid out as a structure of arrays, indexed by the process number, so that the scheduler's queries only touch
+* the fields they need. Every process state has a bitmap with one bit per process, so that finding the running process,
+* the next suspended process, or counting the live processes is a scan of 64 processes per word.
 * processNumber - Unique Identifier
 * processId - Child process id
-* state - Process state
+* state - Process state, to be changed only with setProcessState, so that the state bitmaps stay in sync
 * processAdded - Tracker used to fill this struct with data
+* gangNumber - 1 based index of the gang in the gangs struct, 0 if the process is not a part of any gang
+* quantumTimeInMillis - Quantum time tuned by 'q auto', 0 if the process uses the quantum time set by 'q #'
+* sliceStartTimeInMicros - Time at which the current time slice of the process started
+* sliceStartCpuTimeInNanos - CPU time consumed by the process when its current time slice started, -1 till it is read
+* sliceStartRunDelayInNanos - Time the process had spent waiting on a run queue when its current time slice started
+* sliceEndTimeInMicros - Time at which the last time slice of the process ended, 0 once the slice is accounted by 'q auto'
+* preemptionTimeInMicros - Time at which the process was last preempted by RR, 0 if it was not preempted yet
+* continueTimeInMicros - Time at which SIGCONT was last sent to the process, 0 once the process has reported that it is running
+* memoryUsageInKB - Proportional set size (or resident set size) of the process, when it was last sampled
+* outputPipe - Read end of the pipe connected to the standard output of the process, -1 once the process has closed it
+* outputRing - Pipe holding the recent output of the process
+* outputLogFile - Log file capturing the output of the process, -1 once the process has closed its output
+* processGroupId - Process group of the process, shared by the members of a gang, and by the processes that are not a part of any gang
+* processFileDescriptor - pidfd of a process re-adopted from a previous shell, -1 for the processes created by this shell
+* startTime - Start time of the process in clock ticks since boot, used to tell the process apart from a later process reusing its pid
+* stateBitmaps - One bitmap per process state, indexed by the enum processStates value
+* memoryThrottledBitmap - Processes that are suspended because the memory budget is exceeded, the scheduler skips such processes
+* controlPage - Page of shared memory, where the process publishes its progress and gets asked to yield, NULL if it is not mapped
+* cacheDomain - L3 cache domain the process is placed in, -1 if it is not placed
+* lastCpu - Cpu on which the process was last seen running, -1 if it was not seen running yet
+* arrivalTimeInMicros - Time at which the job of a replayed trace arrived, 0 for the processes created by 'c #'
+* cpuDemandInMillis - Cpu time the process burns before it exits, 0 for the processes that loop forever
 */
 struct processTable
 {
-    int processNumber;
-	int processId;
-	enum processStates state;
-	int processAdded;
+    int processNumber[MAXIMUM_NUMBER_OF_CHILD_PROCESSES];
+	int processId[MAXIMUM_NUMBER_OF_CHILD_PROCESSES];
+	enum processStates state[MAXIMUM_NUMBER_OF_CHILD_PROCESSES];
+	int processAdded[MAXIMUM_NUMBER_OF_CHILD_PROCESSES];
+	int gangNumber[MAXIMUM_NUMBER_OF_CHILD_PROCESSES];
+	int quantumTimeInMillis[MAXIMUM_NUMBER_OF_CHILD_PROCESSES];
+	long long sliceStartTimeInMicros[MAXIMUM_NUMBER_OF_CHILD_PROCESSES];
+	long long sliceStartCpuTimeInNanos[MAXIMUM_NUMBER_OF_CHILD_PROCESSES];
+	long long sliceStartRunDelayInNanos[MAXIMUM_NUMBER_OF_CHILD_PROCESSES];
+	long long sliceEndTimeInMicros[MAXIMUM_NUMBER_OF_CHILD_PROCESSES];
+	long long preemptionTimeInMicros[MAXIMUM_NUMBER_OF_CHILD_PROCESSES];
+	long long continueTimeInMicros[MAXIMUM_NUMBER_OF_CHILD_PROCESSES];
+	long memoryUsageInKB[MAXIMUM_NUMBER_OF_CHILD_PROCESSES];
+	int outputPipe[MAXIMUM_NUMBER_OF_CHILD_PROCESSES];
+	int outputRing[MAXIMUM_NUMBER_OF_CHILD_PROCESSES][2];
+	int outputLogFile[MAXIMUM_NUMBER_OF_CHILD_PROCESSES];
+	int processGroupId[MAXIMUM_NUMBER_OF_CHILD_PROCESSES];
+	int processFileDescriptor[MAXIMUM_NUMBER_OF_CHILD_PROCESSES];
+	unsigned long long startTime[MAXIMUM_NUMBER_OF_CHILD_PROCESSES];
+	unsigned long long stateBitmaps[NUMBER_OF_PROCESS_STATES + 1][NUMBER_OF_BITMAP_WORDS];
+	unsigned long long memoryThrottledBitmap[NUMBER_OF_BITMAP_WORDS];
+	struct controlPage *controlPage[MAXIMUM_NUMBER_OF_CHILD_PROCESSES];
+	int cacheDomain[MAXIMUM_NUMBER_OF_CHILD_PROCESSES];
+	int lastCpu[MAXIMUM_NUMBER_OF_CHILD_PROCESSES];
+	long long arrivalTimeInMicros[MAXIMUM_NUMBER_OF_CHILD_PROCESSES];
+	long long cpuDemandInMillis[MAXIMUM_NUMBER_OF_CHILD_PROCESSES];
+};
+
+/*
+* Struct resourceLimits
+* Limits applied to a child process with setrlimit() before it is loaded, 0 leaves the limit as it is.
+* addressSpaceInMB - Size of the virtual memory (RLIMIT_AS)
+* openFileCount - Number of open file descriptors (RLIMIT_NOFILE)
+* cpuTimeInSecs - Cpu time, after which the process gets SIGXCPU and then SIGKILL (RLIMIT_CPU)
+*/
+struct resourceLimits
+{
+    long addressSpaceInMB;
+    long openFileCount;
+    long cpuTimeInSecs;
+};
+
+/*
+* Struct jobWorkload
+* Work done by a synthetic child process, which is passed to it as its arguments. All 0 for the processes created by 'c #'.
+* cpuTimeInMillis - Cpu time the process burns before it exits, 0 to loop forever
+* memoryInMB - Memory the process allocates and touches once it runs
+* arrivalTimeInMicros - Time of the monotonic clock at which the job of a replayed trace arrived
+*/
+struct jobWorkload
+{
+    long long cpuTimeInMillis;
+    long memoryInMB;
+    long long arrivalTimeInMicros;
+};
+
+/*
+* Struct queuedCreationRequest
+* childProcessCount - Number of child processes that are yet to be created
+* gangNumber - the gang of the child processes, 0 if they are not a part of any gang
+* limits - the resource limits of the child processes
+* workload - the work done by the child processes
+*/
+struct queuedCreationRequest
+{
+    int childProcessCount;
+    int gangNumber;
+    struct resourceLimits limits;
+    struct jobWorkload workload;
+};
+
+/*
+* Struct gangTable
+* gangName - Name given to the gang with the 'c # name' command
+* gangAdded - Tracker used to fill this struct with data
+* processGroupId - Process group of the gang members, 0 until the first member is created
+*/
+struct gangTable
+{
+    char gangName[MAXIMUM_GANG_NAME_LENGTH];
+    int gangAdded;
+    int processGroupId;
+};
+
+/*
+* Enum List Sort Keys
+* Columns that the rows of the 'l' command can be sorted on, in the order of the names accepted by --sort.
+*/
+enum listSortKeys
+{
+    SortByNumber,
+    SortByPid,
+    SortByState,
+    SortByCpu,
+    SortByIterations
+};
+
+/*
+* Struct listOptions
+* Options of the 'l' command.
+* state - Only list the processes in this state, 0 for all the states
+* sortKey - Column the rows are sorted on
+* topCount - Number of rows to list, 0 for all the rows
+* pageNumber - 1 based page of rows to list
+* paged - true if --page=# was given, so the rows are cut into pages of LIST_PAGE_SIZE (or --top=#) rows
+* watchIntervalInSecs - Redraw the changed rows every these many secs, 0 if not watching
+* json - List the rows as JSON
+*/
+struct listOptions
+{
+    enum processStates state;
+    enum listSortKeys sortKey;
+    int topCount;
+    int pageNumber;
+    bool paged;
+    int watchIntervalInSecs;
+    bool json;
+};
+
+/*
+* Struct listOutput
+* Buffer into which the output of the 'l' command is formatted.
+* data - The formatted output
+* length - Bytes of output in the buffer
+* capacity - Size of the buffer
+* streaming - true if the buffer is written out whenever it gets full, false if it grows to hold the whole output
+*/
+struct listOutput
+{
+    char *data;
+    size_t length;
+    size_t capacity;
+    bool streaming;
 };
 
 /* Declarations - Variables, Methods */
-static struct processTable childProcesses[MAXIMUM_NUMBER_OF_CHILD_PROCESSES];
+static struct processTable childProcesses;
+static struct gangTable gangs[MAXIMUM_NUMBER_OF_GANGS];
+
+/*
+* Struct quantumAdjustment
+* processId - Child process id
+* oldQuantumTimeInMillis - Quantum time before the adjustment
+* newQuantumTimeInMillis - Quantum time after the adjustment
+* cpuUsageInPercent - Share of the last time slice the process spent on the cpu
+* switchOverheadInPermille - Share of the last time slice that was lost to the context switch
+* reason - Why the quantum time was adjusted
+*/
+struct quantumAdjustment
+{
+    int processId;
+    int oldQuantumTimeInMillis;
+    int newQuantumTimeInMillis;
+    int cpuUsageInPercent;
+    int switchOverheadInPermille;
+    char *reason;
+};
+
+static struct quantumAdjustment quantumAdjustments[NUMBER_OF_LOGGED_QUANTUM_ADJUSTMENTS];
+static long long responseTimeSamplesInMicros[NUMBER_OF_RESPONSE_TIME_SAMPLES];
+int quantumAdjustmentCount = 0;
+int responseTimeSampleCount = 0;
+bool autoQuantumEnabled = false;
+long long lastSwitchOverheadInMicros = 0;
+bool timeSliceStatsPending = false;
+static struct queuedCreationRequest queuedCreations[MAXIMUM_NUMBER_OF_QUEUED_CREATIONS];
+int queuedCreationCount = 0;
+long memoryBudgetInKB = 0;
+int nullDevice = -1;
+int defaultProcessGroupId = 0;
+int stateJournal = -1;
+int journalRecordCount = 0;
+
+/*
+* Struct logQueueEntry
+* A message is written by whoever reserved the entry (the main loop, or a signal handler that interrupted it), and is published by
+* setting the sequence to the reserved position + 1. The main loop only drains the entries that have been published, in order.
+* sequence - Reserved position + 1, once the message is complete
+* length - Length of the message
+* message - The message, including the colors
+*/
+struct logQueueEntry
+{
+    unsigned long sequence;
+    int length;
+    char message[MAXIMUM_LOG_MESSAGE_LENGTH];
+};
+
+static struct logQueueEntry logQueue[LOG_QUEUE_SIZE];
+unsigned long logQueueHead = 0;
+unsigned long logQueueTail = 0;
+unsigned long droppedLogMessages = 0;
+enum logLevels logLevel = LogDebug;
+bool colorEnabled = true;
+
+/*
+* Struct schedulerMetrics
+* The counters are updated from the signal handlers as well, so they are only changed with relaxed atomic additions,
+* which cost about as much as a plain increment. The shell is single threaded, so per-cpu counters are not needed.
+* dispatchCount - Scheduling units started by the scheduler
+* preemptionCount - Scheduling units preempted by RR
+* terminationCount - Scheduling units terminated by FCFS, once their burst time elapsed
+* alarmCount - Alarms handled by the scheduler
+* dispatchLatencyInMicros - Total time from an alarm until the next scheduling unit was started
+* dispatchLatencyCount - Number of dispatches included in dispatchLatencyInMicros
+* timerOvershootInMicros - Total time by which the alarms fired later than they were set for
+* timerOvershootCount - Number of alarms included in timerOvershootInMicros
+* maximumTimerOvershootInMicros - Largest overshoot of an alarm
+* timerDeadlineInMicros - Time at which the pending alarm is due, 0 if it is not measured
+* migrationCount - Moves of a running process to another cpu of the same L3 cache domain
+* crossCacheDomainMigrationCount - Moves of a running process to a cpu of another L3 cache domain on the same NUMA node
+* crossNodeMigrationCount - Moves of a running process to a cpu of another NUMA node
+*/
+struct schedulerMetrics
+{
+    unsigned long dispatchCount;
+    unsigned long preemptionCount;
+    unsigned long terminationCount;
+    unsigned long alarmCount;
+    unsigned long long dispatchLatencyInMicros;
+    unsigned long dispatchLatencyCount;
+    unsigned long long timerOvershootInMicros;
+    unsigned long timerOvershootCount;
+    long long maximumTimerOvershootInMicros;
+    long long timerDeadlineInMicros;
+    unsigned long migrationCount;
+    unsigned long crossCacheDomainMigrationCount;
+    unsigned long crossNodeMigrationCount;
+};
+
+static struct schedulerMetrics metrics;
+
+/*
+* Struct cpuTopology
+* The cpus the shell may run on, grouped by the L3 cache they share, read from CPU_TOPOLOGY_DIRECTORY when the shell starts.
+* A cpu without an L3 cache is grouped with the other cpus of its package.
+* cpuCount - Number of cpus the shell may run on
+* packageCount - Number of packages (sockets) of those cpus
+* numaNodeCount - Number of NUMA nodes of those cpus, 1 on a machine without NUMA
+* cacheDomainCount - Number of L3 cache domains of those cpus
+* numaNodeOfCpu - NUMA node of every cpu
+* cacheDomainOfCpu - L3 cache domain of every cpu, -1 for a cpu the shell may not run on
+* cacheDomainCpus - Cpus of every L3 cache domain
+* numaNodeOfCacheDomain - NUMA node of every L3 cache domain
+*/
+struct cpuTopology
+{
+    int cpuCount;
+    int packageCount;
+    int numaNodeCount;
+    int cacheDomainCount;
+    short numaNodeOfCpu[CPU_SETSIZE];
+    short cacheDomainOfCpu[CPU_SETSIZE];
+    cpu_set_t cacheDomainCpus[MAXIMUM_NUMBER_OF_CACHE_DOMAINS];
+    int numaNodeOfCacheDomain[MAXIMUM_NUMBER_OF_CACHE_DOMAINS];
+};
+
+static struct cpuTopology topology;
+
+/*
+* Struct latencyHistogram
+* Latencies below LATENCY_SUB_BUCKET_COUNT microsecs have a bucket each. Every following power of 2 is split into
+* LATENCY_SUB_BUCKET_COUNT buckets, so the buckets grow with the latency and the relative error stays the same.
+* name - Name displayed by the 'lat' command
+* bucketCounts - Number of latencies recorded in every bucket
+* totalCount - Number of latencies recorded
+* minimumInMicros - Smallest latency recorded
+* maximumInMicros - Largest latency recorded
+*/
+struct latencyHistogram
+{
+    char *name;
+    unsigned long bucketCounts[LATENCY_HISTOGRAM_BUCKETS];
+    unsigned long totalCount;
+    long long minimumInMicros;
+    long long maximumInMicros;
+};
+
+/*
+* Enum Yield States
+* The futex word of the control page, the same enum is declared in proce.c.
+* YieldNone - The process runs normally
+* YieldRequested - The shell has asked the process to yield the cpu
+* YieldParked - The process has yielded, and waits on the futex till the shell wakes it
+*/
+enum yieldStates
+{
+    YieldNone = 0,
+    YieldRequested = 1,
+    YieldParked = 2
+};
+
+/*
+* Struct controlPage
+* Page of shared memory between the shell and a child process, created with memfd_create(), the same struct is declared in proce.c.
+* yieldState - Futex word, holding a value of enum yieldStates
+* processId - The child process id, published once the process has started
+* startTimeInMicros - Time of the monotonic clock at which the child process started, 0 until then
+* heartbeatTimeInMicros - Time of the monotonic clock at which the child process last completed an iteration
+* iterationCount - Number of iterations completed by the child process
+*/
+struct controlPage
+{
+    int yieldState;
+    int processId;
+    long long startTimeInMicros;
+    long long heartbeatTimeInMicros;
+    unsigned long long iterationCount;
+};
+
+/*
+* Struct continueHandshake
+* Record written by a child process into the handshake pipe, when it is running after receiving SIGCONT.
+* The same struct is declared in proce.c.
+* processId - The child process id
+* continuedTimeInMicros - Time of the monotonic clock at which the child process was running again
+*/
+struct continueHandshake
+{
+    int processId;
+    long long continuedTimeInMicros;
+};
+
+static struct latencyHistogram timerOvershootHistogram = { .name = "Alarm overshoot" };
+static struct latencyHistogram dispatchLatencyHistogram = { .name = "Alarm to SIGCONT" };
+static struct latencyHistogram continueLatencyHistogram = { .name = "SIGCONT to running" };
+
+/*
+* Struct traceReplay
+* State of the 'replay' command. The trace is read one job ahead of the replay, so it is never loaded as a whole.
+* active - The replay is in progress, till all the jobs of the trace have exited or 'replay stop' is entered
+* traceFile - The trace being read, NULL once all its jobs have arrived
+* tracePath - Path of the trace
+* speedup - Factor by which the arrival offsets and the cpu times of the trace are compressed
+* startTimeInMicros - Time of the monotonic clock at which the replay started
+* lineNumber - Number of the lines read from the trace
+* nextJobName - Command of the next job, as recorded in the trace
+* nextJob - Workload of the next job, valid while traceFile is not NULL
+* arrivedCount - Jobs that have arrived, and were handed over for creation
+* skippedCount - Lines of the trace that could not be parsed
+* completedCount - Jobs that exited after burning their cpu time
+* totalSlowdown - Sum of the turnaround time divided by the cpu time, over the completed jobs
+* turnaroundHistogram - Time from the arrival of a job until it exited, over the completed jobs
+*/
+struct traceReplay
+{
+    bool active;
+    FILE *traceFile;
+    char tracePath[BUFFER_SIZE];
+    int speedup;
+    long long startTimeInMicros;
+    int lineNumber;
+    char nextJobName[MAXIMUM_TRACE_JOB_NAME_LENGTH];
+    struct jobWorkload nextJob;
+    int arrivedCount;
+    int skippedCount;
+    int completedCount;
+    double totalSlowdown;
+    struct latencyHistogram turnaroundHistogram;
+};
+
+static struct traceReplay replay;
+int handshakePipe[2] = {-1, -1};
+timer_t burstTimer;
+bool burstTimerCreated = false;
+long long lastMetricsExportTimeInMicros = 0;
+long long lastMemorySampleTimeInMicros = 0;
+int childProcessLimit = MAXIMUM_NUMBER_OF_CHILD_PROCESSES;
+struct rlimit inheritedFileDescriptorLimit;
+unsigned long lastExportedDispatchCount = 0;
+unsigned long lastExportedPreemptionCount = 0;
 char schedulingAlgo[10];
-int roundRobinQuantumTimeInSecs;
+int roundRobinQuantumTimeInMillis;
 int createChildProcesses(char **cmdArguments);
 int setQuantumTime(char **cmdArguments);
 int setSchedulingAlgorithm(char **cmdArguments);
 int clearConsole(char **cmdArguments);
 int terminateChildProcess(char **cmdArguments);
 int displayChildProcessInformation(char **cmdArguments);
+long long getHeartbeatAgeInMillis(int processNumber);
+int formatChildProcessInformation(int processNumber, char *row, int rowSize);
+void formatChildProcessJson(int processNumber, struct listOutput *output);
+void writeListOutput(struct listOutput *output);
+void appendListOutput(struct listOutput *output, const char *format, ...);
+int parseListOptions(char **cmdArguments, struct listOptions *options);
+int collectListRows(struct listOptions *options, int *rowProcesses, int *matchingCount);
+void watchChildProcessInformation(struct listOptions *options);
 int resumeChildProcesses(char **cmdArguments);
 int suspendAll(char **cmdArguments);
 int supportedCommandsMessage();
-int forkParentProcess(int processCount);
+int forkParentProcess(int processCount, int gangNumber, struct resourceLimits *limits, struct jobWorkload *workload);
+int parseResourceLimit(char *argument, struct resourceLimits *limits);
+int applyResourceLimits(struct resourceLimits *limits);
+void reapExitedChildProcess(int processNumber);
+void armBurstTimer(int processNumber, int timeInMillis);
 char* getProcessState(int processStateId);
 int exitApplication(char **cmdArguments);
 int creationOfChildProcessAllowed();
@@ -90,15 +622,101 @@ void runChildProcessUsingSchedulingAlgo(int processNumber);
 int runFirstProcessUsingSchedulingAlgorithm();
 int runChildProcess(int processNumber);
 void killProcess(int procNo);
+int getSchedulingUnit(int processNumber, int *unitMembers);
+int getThrottledUnit(int processNumber, int *unitMembers);
+void suspendSchedulingUnit(int processNumber);
+void terminateSchedulingUnit(int processNumber);
+int sendSignalToProcesses(int *processNumbers, int processCount, int signalNumber);
+int parseProcessSelection(char *selection, bool *selectedProcesses);
+int findGang(char *gangName);
+int getProcessGroupForNewChild(int gangNumber);
+int runSelectedChildProcesses(bool *selectedProcesses);
+int findOrAddGang(char *gangName);
+int countRunningProcesses();
+void blockSchedulerSignals(sigset_t *previousSignals);
+void unblockSchedulerSignals(sigset_t *previousSignals);
+void setProcessState(int processNumber, enum processStates state);
+void setMemoryThrottled(int processNumber, int memoryThrottled);
+bool isMemoryThrottled(int processNumber);
+int findNextProcessInState(enum processStates state, int startProcessNo);
+int findNextSchedulableProcess(int startProcessNo, int endProcessNo);
+int countProcessesInState(enum processStates state);
+unsigned long long readProcessStartTime(int processId);
+int readParentProcessId(int processId);
+void appendJournalRecord(const char *format, ...);
+void journalProcess(int processNumber);
+void journalGang(int gangNumber);
+void journalSettings();
+int writeStateRecords(int stateFile);
+void writeStateSnapshot();
+void replayStateRecord(char *record);
+void replayStateFile(char *path);
+void recoverSchedulerState();
+void recoverControlPage(int processNumber);
+void removeSchedulerState();
+void setOutputColor(const char *color);
+void logSchedulerEvent(enum logLevels level, const char *color, const char *format, ...);
+int flushLogQueue();
+void recordTimerOvershoot(long long alarmTimeInMicros);
+void exportSchedulerMetrics();
+int getLatencyBucket(long long latencyInMicros);
+long long getLatencyBucketUpperBound(int bucket);
+void recordLatency(struct latencyHistogram *histogram, long long latencyInMicros);
+long long getLatencyPercentile(struct latencyHistogram *histogram, double percentile);
+void recordContinueTime(int *processNumbers, int processCount);
+void readContinueHandshakes();
+int displayLatencyHistograms(char **cmdArguments);
+struct controlPage *mapControlPage(int controlPageDescriptor);
+int readTopologyValue(char *path);
+int parseCpuList(char *path, cpu_set_t *cpus);
+void readCpuTopology();
+void raiseFileDescriptorLimit();
+int pickCacheDomain(int gangNumber);
+void placeChildProcess(int cacheDomain);
+int findCacheDomainOfProcess(int processId);
+int readProcessCpu(int processId);
+void sampleProcessPlacement();
+void releaseYieldedProcesses(int *processNumbers, int processCount);
+int yieldChildProcess(char **cmdArguments);
+long long getMonotonicTimeInMicros();
+int readProcessSchedulingStats(int processId, long long *cpuTimeInNanos, long long *runDelayInNanos);
+int getQuantumTimeInMillis(int processNumber);
+void armSchedulerTimer(int timeInMillis);
+void startTimeSlice(int processNumber);
+void endTimeSlice(int processNumber);
+void accountTimeSlice(int processNumber, long long cpuTimeInNanos, long long runDelayInNanos);
+void readPendingTimeSliceStats();
+long long getP99ResponseTimeInMicros();
+int displaySchedulerStatistics(char **cmdArguments);
+int setMemoryBudget(char **cmdArguments);
+long readProcessMemoryUsage(int processId);
+long sampleMemoryUsage(int *liveProcessCount);
+int memoryAdmissionAllowed();
+void queueChildProcessCreation(int childProcessCount, int gangNumber, struct resourceLimits *limits, struct jobWorkload *workload);
+int replayTrace(char **cmdArguments);
+int parseTraceLine(char *line, struct jobWorkload *job, char *jobName);
+int readNextTraceJob();
+int advanceTraceReplay();
+void dispatchArrivedJobs();
+void recordReplayedJobCompletion(int processNumber);
+void finishTraceReplay(const char *reason);
+void admitQueuedChildProcesses();
+void relieveMemoryPressure();
+bool isProcessSchedulable(int processNumber);
+int setupOutputCapture(int processNumber, int outputPipe);
+void drainChildProcessOutput(int processNumber);
+void drainAllChildProcessOutput();
+int displayChildProcessOutput(char **cmdArguments);
 int childProcessCountTracker = 0;
 int fcfsBurstTimeInSecs = 0;
 int terminatedChildProcess = 0;
 int runningOneProcess = 0;
 
-char *shellCommands[] = {"c", "l", "q", "b", "t", "k", "r", "s", "x", "X", "clear", "help"};
+char *shellCommands[] = {"c", "l", "q", "b", "t", "k", "r", "s", "x", "X", "clear", "help", "stats", "m", "tail", "lat", "y", "replay"};
 int (*supportedShellCommands[]) (char **) = { &createChildProcesses, &displayChildProcessInformation,
 &setQuantumTime, &setBurstTimeForFCFS, &setSchedulingAlgorithm, &terminateChildProcess, &resumeChildProcesses, &suspendAll,
-&exitApplication, &exitApplication, &clearConsole, &supportedCommandsMessage};
+&exitApplication, &exitApplication, &clearConsole, &supportedCommandsMessage, &displaySchedulerStatistics, &setMemoryBudget,
+&displayChildProcessOutput, &displayLatencyHistograms, &yieldChildProcess, &replayTrace};
 
 /*
 * Summary - This method will exit the shell & all child processes, when the user
@@ -116,9 +734,9 @@ int exitApplication(char **cmdArguments)
         for(processInfoCounter = 0; processInfoCounter < childProcessCountTracker; processInfoCounter++)
         {
             // A process will be killed, if its status is not terminated.
-            if(childProcesses[processInfoCounter].state != Terminated)
+            if(childProcesses.state[processInfoCounter] != Terminated)
             {
-                kill(childProcesses[processInfoCounter].processId, SIGKILL);
+                kill(childProcesses.processId[processInfoCounter], SIGKILL);
                 // Make the parent wait for a successful child termination.
                 while(wait(&childStatus) > 0)
                 {
@@ -130,6 +748,9 @@ int exitApplication(char **cmdArguments)
                 }
             }
         }
+        // All the child processes are terminated, so there is nothing for the next shell to re-adopt.
+        removeSchedulerState();
+        flushLogQueue();
         exit(0);
     }
     puts("The command you entered to exit this shell appears to be incorrect.\n"
@@ -140,31 +761,208 @@ int exitApplication(char **cmdArguments)
 * Summary - This method will populate the 'childProcesses' struct
 * Param 1 - processId - the child process id
 * Param 2 - state - the process state
+* Param 3 - gangNumber - the gang of the process, 0 if the process is not a part of any gang
+* Param 4 - processGroupId - the process group of the process
 */
-void addChildProcess(int processId, enum processStates state)
+void addChildProcess(int processId, enum processStates state, int gangNumber, int processGroupId)
 {
     // Declarations
     int counter = 0;
 
     while(counter < MAXIMUM_NUMBER_OF_CHILD_PROCESSES)
     {
-        if(childProcesses[counter].processAdded == 0)
+        if(childProcesses.processAdded[counter] == 0)
         {
-            childProcesses[counter].processNumber = counter;
-            childProcesses[counter].processId = processId;
-            childProcesses[counter].state = state;
-            childProcesses[counter].processAdded = 1;
+            childProcesses.processNumber[counter] = counter;
+            childProcesses.processId[counter] = processId;
+            childProcesses.processAdded[counter] = 1;
+            childProcesses.gangNumber[counter] = gangNumber;
+            childProcesses.processGroupId[counter] = processGroupId;
+            childProcesses.processFileDescriptor[counter] = -1;
+            childProcesses.controlPage[counter] = NULL;
+            childProcesses.cacheDomain[counter] = -1;
+            childProcesses.lastCpu[counter] = -1;
+            childProcesses.startTime[counter] = readProcessStartTime(processId);
+            // The state is set last, as it journals the complete process record.
+            setProcessState(counter, state);
             break;
         }
         counter++;
     }
 }
 
+/*
+* Summary - This method will block the alarm and control-c signals, as their handlers change the process states.
+* The handlers block both signals as well, so that neither of them runs while the other one updates the process table.
+* Param 1 - previousSignals - receives the signal mask to be restored by unblockSchedulerSignals()
+*/
+void blockSchedulerSignals(sigset_t *previousSignals)
+{
+    // Declarations
+    sigset_t schedulerSignals;
+
+    sigemptyset(&schedulerSignals);
+    sigaddset(&schedulerSignals, SIGALRM);
+    sigaddset(&schedulerSignals, SIGINT);
+    sigprocmask(SIG_BLOCK, &schedulerSignals, previousSignals);
+}
+
+/*
+* Summary - This method will restore the signal mask saved by blockSchedulerSignals().
+* Param 1 - previousSignals - the signal mask to be restored
+*/
+void unblockSchedulerSignals(sigset_t *previousSignals)
+{
+    sigprocmask(SIG_SETMASK, previousSignals, NULL);
+}
+
+/*
+* Summary - Changes the state of a child process, moves the process to the bitmap of its new state, and journals the change.
+* The signals of the scheduler are blocked meanwhile, as a bitmap word is shared by 64 processes, and a handler changing
+* another process of the same word would otherwise lose the update of this one.
+* Param 1 - processNumber - the child process
+* Param 2 - state - the new state of the process
+*/
+void setProcessState(int processNumber, enum processStates state)
+{
+    // Declarations
+    int word = processNumber / 64;
+    unsigned long long bit = 1ULL << (processNumber % 64);
+    sigset_t previousSignals;
+
+    blockSchedulerSignals(&previousSignals);
+
+    childProcesses.stateBitmaps[childProcesses.state[processNumber]][word] &= ~bit;
+    childProcesses.stateBitmaps[state][word] |= bit;
+    childProcesses.state[processNumber] = state;
+
+    // A re-adopted process can not be waited for, so its pidfd is only needed till it is terminated.
+    if(state == Terminated && childProcesses.processFileDescriptor[processNumber] != -1)
+    {
+        close(childProcesses.processFileDescriptor[processNumber]);
+        childProcesses.processFileDescriptor[processNumber] = -1;
+    }
+
+    journalProcess(processNumber);
+
+    unblockSchedulerSignals(&previousSignals);
+}
+
+/*
+* Summary - Marks a child process as suspended (or no longer suspended) due to memory pressure.
+* The signals of the scheduler are blocked meanwhile, as for setProcessState().
+* Param 1 - processNumber - the child process
+* Param 2 - memoryThrottled - 1 if the process is suspended due to memory pressure, 0 otherwise
+*/
+void setMemoryThrottled(int processNumber, int memoryThrottled)
+{
+    // Declarations
+    int word = processNumber / 64;
+    unsigned long long bit = 1ULL << (processNumber % 64);
+    sigset_t previousSignals;
+
+    blockSchedulerSignals(&previousSignals);
+
+    if(memoryThrottled)
+        childProcesses.memoryThrottledBitmap[word] |= bit;
+    else
+        childProcesses.memoryThrottledBitmap[word] &= ~bit;
+
+    unblockSchedulerSignals(&previousSignals);
+}
+
+/*
+* Summary - Checks if a child process is suspended due to memory pressure.
+* Param 1 - processNumber - the child process
+* Returns true if the process is suspended due to memory pressure
+*/
+bool isMemoryThrottled(int processNumber)
+{
+    return (childProcesses.memoryThrottledBitmap[processNumber / 64] >> (processNumber % 64)) & 1;
+}
+
+/*
+* Summary - Finds the first child process in a given state, starting at a given process number.
+* Param 1 - state - the state to look for
+* Param 2 - startProcessNo - the first process number to consider
+* Returns the process number, -1 if no process from startProcessNo onwards is in the given state
+*/
+int findNextProcessInState(enum processStates state, int startProcessNo)
+{
+    // Declarations
+    int word = startProcessNo / 64;
+    unsigned long long bits;
+
+    if(startProcessNo >= MAXIMUM_NUMBER_OF_CHILD_PROCESSES)
+        return -1;
+
+    // Mask off the processes before startProcessNo in its word, then scan word by word
+    bits = childProcesses.stateBitmaps[state][word] & (~0ULL << (startProcessNo % 64));
+    while(1)
+    {
+        if(bits != 0)
+            return word * 64 + __builtin_ctzll(bits);
+        if(++word == NUMBER_OF_BITMAP_WORDS)
+            return -1;
+        bits = childProcesses.stateBitmaps[state][word];
+    }
+}
+
+/*
+* Summary - Finds the first schedulable child process (suspended, and not suspended due to memory pressure) in a range.
+* Param 1 - startProcessNo - the first process number to consider
+* Param 2 - endProcessNo - the process number after the last one to consider
+* Returns the process number, -1 if no process in the range is schedulable
+*/
+int findNextSchedulableProcess(int startProcessNo, int endProcessNo)
+{
+    // Declarations
+    int word;
+    int lastWord;
+    unsigned long long bits;
+
+    if(startProcessNo >= endProcessNo)
+        return -1;
+
+    word = startProcessNo / 64;
+    lastWord = (endProcessNo - 1) / 64;
+    bits = (childProcesses.stateBitmaps[Suspended][word] & ~childProcesses.memoryThrottledBitmap[word])
+        & (~0ULL << (startProcessNo % 64));
+    while(1)
+    {
+        if(bits != 0)
+        {
+            int processNumber = word * 64 + __builtin_ctzll(bits);
+            return processNumber < endProcessNo ? processNumber : -1;
+        }
+        if(++word > lastWord)
+            return -1;
+        bits = childProcesses.stateBitmaps[Suspended][word] & ~childProcesses.memoryThrottledBitmap[word];
+    }
+}
+
+/*
+* Summary - Counts the child processes in a given state.
+* Param 1 - state - the state to count
+* Returns the number of processes in the given state
+*/
+int countProcessesInState(enum processStates state)
+{
+    // Declarations
+    int word;
+    int count = 0;
+
+    for(word = 0; word < NUMBER_OF_BITMAP_WORDS; word++)
+        count += __builtin_popcountll(childProcesses.stateBitmaps[state][word]);
+
+    return count;
+}
+
 /*
 * Summary - To respond to a control-c command, this method will be used.
 * Steps:
 * 1. Check if any child process is running.
-* 2. Suspend the executing child process using SIGSTOP signal.
+* 2. Suspend the executing child processes using SIGSTOP signal. A running gang has more than one executing process.
 * 3. Update the status of child as 'Suspended' in the childProcesses struct.
 * 4. Control-c should suspend everything, so cancel the future alarm
 * 5. Return control to the parent.
@@ -173,80 +971,77 @@ void addChildProcess(int processId, enum processStates state)
 void controlCHandler()
 {
     // Declarations
-    int counter = 0, loopCounter = 0;
+    int counter = 0, runningProcessCount = 0;
+    int runningProcesses[MAXIMUM_NUMBER_OF_CHILD_PROCESSES];
 
-    for(counter = 0; counter < childProcessCountTracker; counter++)
+    for(counter = findNextProcessInState(Running, 0); counter != -1; counter = findNextProcessInState(Running, counter + 1))
     {
-        if(childProcesses[counter].state == Running)
-        {
-            kill(childProcesses[counter].processId, SIGSTOP);
-
-            childProcesses[counter].state = Suspended;
-
-            printf("\033[0;35m");
-            printf("\n\nChild Process %d -> Running -> Suspended\n", childProcesses[counter].processId);
-            printf("\033[0m");
+        runningProcesses[runningProcessCount] = counter;
+        runningProcessCount++;
+    }
 
-            alarm(0);
+    for(counter = 0; counter < runningProcessCount; counter++)
+    {
+        setProcessState(runningProcesses[counter], Suspended);
 
-            break;
-        }
+        logSchedulerEvent(LogInfo, "\033[0;35m", "\n\nChild Process %d -> Running -> Suspended\n",
+        childProcesses.processId[runningProcesses[counter]]);
     }
 
-    fflush(stdout);
+    if(runningProcessCount > 0)
+    {
+        sendSignalToProcesses(runningProcesses, runningProcessCount, SIGSTOP);
+        armSchedulerTimer(0);
+    }
 }
 
 /*
 * Summary - This method is invoked when a process's quantum time or burst time has elapsed.
 * It will first find the cuurent running process and will stop it in case of RR and will terminate it in case of FCFS.
 * Then it will start the next process using the configured scheduling algorithm.
+* If the running process is a gang member, the whole gang is stopped or terminated, and if the next process is a gang member,
+* the whole gang is started.
 */
 void alarmHandler()
 {
     // Declarations
-    int counter = 0, innerLoopCounter = 0, executingProcessNo = -1, nextProcessNo = -1;
-    bool foundExecutingProcess = false, foundNextProcess = false;
-
-    for(counter = 0; counter < childProcessCountTracker; counter++)
+    int counter = 0, executingProcessNo = -1, nextProcessNo = -1;
+    bool foundNextProcess = false;
+    long long alarmTimeInMicros = getMonotonicTimeInMicros();
+
+    recordTimerOvershoot(alarmTimeInMicros);
+
+    // Step 1 - Find the running process.
+    // The running process might also have been killed by the 'k #' command.
+    // If killed, the status of the process would be terminated,
+    // and the 'terminatedChildProcess' variable will have the process id of the running process that was terminated
+    executingProcessNo = findNextProcessInState(Running, 0);
+    if(executingProcessNo == -1 && terminatedChildProcess != 0)
     {
-        // Step 1 - Find the running process.
-        // The running process might also have been killed by the 'k #' command.
-        // If killed, the status of the process would be terminated,
-        // and the 'terminatedChildProcess' variable will have the process id of the running process that was terminated
-        if(childProcesses[counter].state == Running || terminatedChildProcess == childProcesses[counter].processId)
-        {
-            executingProcessNo = counter;
-            foundExecutingProcess = true;
-            continue;
-        }
-
-        // Step 2 - Once executing process is found, we need to find the next process to be executed
-        if(foundExecutingProcess)
+        for(counter = findNextProcessInState(Terminated, 0); counter != -1; counter = findNextProcessInState(Terminated, counter + 1))
         {
-            if(childProcesses[counter].state == Suspended)
+            if(childProcesses.processId[counter] == terminatedChildProcess)
             {
-                nextProcessNo = counter;
-                foundNextProcess = true;
+                executingProcessNo = counter;
                 break;
             }
         }
     }
 
-    // Step 3 - If next process is not found, then scan the childProcesses struct from 0 to executingProcessNo to find the next process.
-    if(!foundNextProcess)
+    // Nothing was executing (e.g. the running process was suspended by 's #' before the alarm fired), so there is nothing to preempt.
+    if(executingProcessNo == -1)
     {
-        int loopCounter;
-        for(loopCounter = 0; loopCounter < executingProcessNo; loopCounter++)
-        {
-            if(childProcesses[loopCounter].state == Suspended)
-            {
-                nextProcessNo = loopCounter;
-                foundNextProcess = true;
-                break;
-            }
-        }
+        terminatedChildProcess = 0;
+        return;
     }
 
+    // Step 2 - Once executing process is found, we need to find the next process to be executed
+    // Step 3 - If next process is not found, then scan the childProcesses struct from 0 to executingProcessNo to find the next process.
+    nextProcessNo = findNextSchedulableProcess(executingProcessNo + 1, childProcessCountTracker);
+    if(nextProcessNo == -1)
+        nextProcessNo = findNextSchedulableProcess(0, executingProcessNo);
+    foundNextProcess = nextProcessNo != -1;
+
     // Step 4 - Even after scanning the entire childProcesses struct, if the next child process to execute is not found,
     // it means there is only 1 process for execution (rest might be terminated), and that process is already running.
     // So, nextProNo = executingProNo
@@ -256,16 +1051,18 @@ void alarmHandler()
         // The following steps will be executed, only if the executing process was not terminated by the k # command.
         // If RR, then continue running the process, dont stop it.
         // If FCFS, the burst time of this process has elapsed, so kill the process.
-        if(childProcesses[executingProcessNo].state != Terminated)
+        if(childProcesses.state[executingProcessNo] != Terminated)
         {
             if(strcmp(schedulingAlgo, "rr") == 0)
             {
                 nextProcessNo = executingProcessNo;
-                alarm(roundRobinQuantumTimeInSecs);
+                endTimeSlice(executingProcessNo);
+                startTimeSlice(executingProcessNo);
+                armSchedulerTimer(getQuantumTimeInMillis(executingProcessNo));
             }
             if(strcmp(schedulingAlgo, "fcfs") == 0)
             {
-                killProcess(executingProcessNo);
+                terminateSchedulingUnit(executingProcessNo);
             }
         }
     }
@@ -274,29 +1071,29 @@ void alarmHandler()
         // Step 6 - We have found the executing process and the next process.
         // If the executing process is not terminated, then stop in RR or kill it in FCFS.
         // Run the next process.
-        printf("\033[0;31m");
-        printf("\nAn alarm has been triggered, proceed with the next process.\n");
-        printf("\033[0m");
+        logSchedulerEvent(LogInfo, "\033[0;31m", "\nAn alarm has been triggered, proceed with the next process.\n");
 
-        if(childProcesses[executingProcessNo].state != Terminated)
+        if(childProcesses.state[executingProcessNo] != Terminated)
         {
             if(strcmp(schedulingAlgo, "rr") == 0)
             {
-                kill(childProcesses[executingProcessNo].processId, SIGSTOP);
-                childProcesses[executingProcessNo].state = Suspended;
-                printf("\033[0;32m");
-                printf("Child %d -> Running -> Suspended\n\n", childProcesses[executingProcessNo].processId);
-                printf("\033[0m");
+                suspendSchedulingUnit(executingProcessNo);
             }
 
             if(strcmp(schedulingAlgo, "fcfs") == 0)
             {
-                killProcess(executingProcessNo);
+                terminateSchedulingUnit(executingProcessNo);
             }
         }
 
         // Run the next process
         runChildProcessUsingSchedulingAlgo(nextProcessNo);
+
+        // The time taken to switch between the processes is a part of the overhead of the next time slice.
+        lastSwitchOverheadInMicros = getMonotonicTimeInMicros() - alarmTimeInMicros;
+        __atomic_add_fetch(&metrics.dispatchLatencyInMicros, lastSwitchOverheadInMicros, __ATOMIC_RELAXED);
+        recordLatency(&dispatchLatencyHistogram, lastSwitchOverheadInMicros);
+        __atomic_add_fetch(&metrics.dispatchLatencyCount, 1, __ATOMIC_RELAXED);
     }
 
     // Reset data, and do a return
@@ -313,7 +1110,7 @@ void killProcess(int procNo)
     // Declarations
     int childStatus = 0;
 
-    kill(childProcesses[procNo].processId, SIGKILL);
+    kill(childProcesses.processId[procNo], SIGKILL);
     while(wait(&childStatus) > 0)
     {
         // SIGKILL is 9
@@ -323,697 +1120,4629 @@ void killProcess(int procNo)
         }
     }
 
-    childProcesses[procNo].state = Terminated;
-    printf("\033[0;32m");
-    printf("Child %d -> Running -> Terminated\n\n", childProcesses[procNo].processId);
-    printf("\033[0m");
+    setProcessState(procNo, Terminated);
+    logSchedulerEvent(LogInfo, "\033[0;32m", "Child %d -> Running -> Terminated\n\n", childProcesses.processId[procNo]);
 }
 
 /*
-* Summary - This method will suspend non-terminated child processes using SIGSTOP signal.
-* The childProcesses struct will also get updated with SUSPENDED process state.
-* Param 1 - cmdArguments - command line arguments
-* Returns 1, after a flawless execution
-* Answer to Question 11 (s all)
+* Summary - This method will collect the process numbers of the scheduling unit that the given process belongs to.
+* A process that is not a part of any gang is a scheduling unit on its own, whereas all the non-terminated members
+* of a gang are dispatched and preempted together. Members that are suspended due to memory pressure are left out.
+* Param 1 - processNumber - the process identifier
+* Param 2 - unitMembers - buffer of MAXIMUM_NUMBER_OF_CHILD_PROCESSES entries to hold the process numbers of the unit
+* Returns the number of processes in the scheduling unit
 */
-int suspendAll(char **cmdArguments)
+int getSchedulingUnit(int processNumber, int *unitMembers)
 {
     // Declarations
-    int processInfoCounter;
-    bool isAnyProcessSuspended = false;
+    int counter, memberCount = 0;
+    int gangNumber = childProcesses.gangNumber[processNumber];
 
-    if(cmdArguments[1] != NULL && cmdArguments[2] == NULL)
+    if(gangNumber == 0)
+    {
+        unitMembers[0] = processNumber;
+        return 1;
+    }
+
+    for(counter = 0; counter < childProcessCountTracker; counter++)
     {
-        if (strcmp(cmdArguments[1], "all") == 0)
+        if(childProcesses.gangNumber[counter] == gangNumber && childProcesses.state[counter] != Terminated
+        && !isMemoryThrottled(counter))
         {
-            // Cancel the future alarm
-            alarm(0);
+            unitMembers[memberCount] = counter;
+            memberCount++;
+        }
+    }
 
-            for(processInfoCounter = 0; processInfoCounter < childProcessCountTracker; processInfoCounter++)
-            {
-                if(childProcesses[processInfoCounter].state != Terminated)
-                {
-                    isAnyProcessSuspended = true;
-                    childProcesses[processInfoCounter].state = Suspended;
-                    kill(childProcesses[processInfoCounter].processId, SIGSTOP);
-                }
-            }
+    return memberCount;
+}
 
-            if(!isAnyProcessSuspended)
-            {
-                puts("There is nothing to suspend because all of the processes have either been terminated or not created at all.\n");
-            }
-            else
-            {
-                puts("The child processes are moved to a suspended state.\n");
-            }
-            return 1;
+/*
+* Summary - This method will collect the process numbers of the scheduling unit that the given process belongs to,
+* out of the processes that are suspended due to memory pressure, so that a gang is made schedulable again as a whole.
+* Param 1 - processNumber - the process identifier
+* Param 2 - unitMembers - buffer of MAXIMUM_NUMBER_OF_CHILD_PROCESSES entries to hold the process numbers of the unit
+* Returns the number of processes in the scheduling unit
+*/
+int getThrottledUnit(int processNumber, int *unitMembers)
+{
+    // Declarations
+    int counter, memberCount = 0;
+    int gangNumber = childProcesses.gangNumber[processNumber];
+
+    if(gangNumber == 0)
+    {
+        unitMembers[0] = processNumber;
+        return 1;
+    }
+
+    for(counter = 0; counter < childProcessCountTracker; counter++)
+    {
+        if(childProcesses.gangNumber[counter] == gangNumber && childProcesses.state[counter] != Terminated
+        && isMemoryThrottled(counter))
+        {
+            unitMembers[memberCount] = counter;
+            memberCount++;
         }
     }
-    puts("The command you entered to suspend all child processes appears to be incorrect.\n"
-    "If needed, use the 'help' command to see the command list.\n");
-    return 1;
+
+    return memberCount;
 }
 
 /*
-* Summary - This method will be used to terminate a child process by using SIGKILL command.
-* Param 1 - cmdArguments - command line arguments
-* Returns 1, after a flawless execution
-* Answer to Question 8 (k #)
+* Summary - This method will send a signal to a batch of child processes back to back,
+* so that the members of a gang get stopped or started as close together as possible.
+* If the batch covers all the non-terminated processes of a process group, the whole group is signalled with one killpg() call,
+* else the processes of that group are signalled one by one.
+* Param 1 - processNumbers - the process identifiers
+* Param 2 - processCount - number of entries in processNumbers
+* Param 3 - signalNumber - the signal to be sent
+* Returns the number of signal calls that were made
 */
-int terminateChildProcess(char **cmdArguments)
+int sendSignalToProcesses(int *processNumbers, int processCount, int signalNumber)
 {
-    if(cmdArguments[1] != NULL && cmdArguments[2] == NULL)
+    // Declarations
+    int counter, innerCounter, processGroupId, batchedProcesses, liveProcesses, signalCalls = 0;
+    bool alreadySignalled;
+
+    // A process that has yielded the cpu waits on its control page, so SIGCONT alone would not run it.
+    if(signalNumber == SIGCONT)
     {
-        // Declarations
-        int argDataLength = strlen(cmdArguments[1]);
-        int argCount, processInfoCounter, childStatus;
-        bool processFound = false, isProcessRunning = false;
+        releaseYieldedProcesses(processNumbers, processCount);
+    }
 
-        for(argCount = 0; argCount < argDataLength; argCount ++)
+    for(counter = 0; counter < processCount; counter++)
+    {
+        processGroupId = childProcesses.processGroupId[processNumbers[counter]];
+
+        // Skip the process, if its group was already handled for an earlier process of the batch.
+        alreadySignalled = false;
+        for(innerCounter = 0; innerCounter < counter; innerCounter++)
         {
-            if(isdigit(cmdArguments[1][argCount]) == 0)
+            if(childProcesses.processGroupId[processNumbers[innerCounter]] == processGroupId)
             {
-                puts("The entered process number appears to be incorrect.\n"
-                "Please use the 'l' command to display child processes information.\n");
-                return 1;
+                alreadySignalled = true;
+                break;
             }
         }
+        if(alreadySignalled)
+        {
+            continue;
+        }
 
-        int processNumber = atoi(cmdArguments[1]);
-
-        for(processInfoCounter = 0; processInfoCounter < childProcessCountTracker; processInfoCounter++)
+        batchedProcesses = 0;
+        for(innerCounter = counter; innerCounter < processCount; innerCounter++)
         {
-            if(childProcesses[processInfoCounter].processNumber == processNumber)
+            if(childProcesses.processGroupId[processNumbers[innerCounter]] == processGroupId)
             {
-                processFound = true;
-                // If the process is not terminated, then terminate it.
-                if(childProcesses[processInfoCounter].state != Terminated)
-                {
-                    if(childProcesses[processInfoCounter].state == Running)
-                    {
-                        isProcessRunning = true;
-                    }
+                batchedProcesses++;
+            }
+        }
 
-                    childProcesses[processInfoCounter].state = Terminated;
-                    kill(childProcesses[processInfoCounter].processId, SIGKILL);
+        liveProcesses = 0;
+        for(innerCounter = 0; innerCounter < childProcessCountTracker; innerCounter++)
+        {
+            if(childProcesses.processGroupId[innerCounter] == processGroupId && childProcesses.state[innerCounter] != Terminated)
+            {
+                liveProcesses++;
+            }
+        }
 
-                    while(wait(&childStatus) > 0)
-                    {
-                        if(childStatus == 9)
-                        {
-                            printf("The process with number %d has been terminated.\n", processNumber);
-                            break;
-                        }
-                    }
+        if(processGroupId > 0 && batchedProcesses == liveProcesses)
+        {
+            killpg(processGroupId, signalNumber);
+            signalCalls++;
+            continue;
+        }
 
-                    // If the terminated process was a running process,
-                    // then for rr or fcfs, the alarm should be called immediately to run the next process.
-                    // runningOneProcess will indicate if all processes are running (r all) or just 1 process (r #)
-                    // runningOneProcess is 1, then it means the process is running because of r # command, and it has nothing
-                    // to do with FCFS or RR
-                    if(runningOneProcess == 0 && isProcessRunning)
-                    {
-                        terminatedChildProcess = childProcesses[processInfoCounter].processId;
-                        // The need for immediate calling arises from the fact that, for instance if the quantum time is
-                        // set to 50 secs, the next process will start after that amount of time.
-                        ualarm(1, 0);
-                    }
+        for(innerCounter = counter; innerCounter < processCount; innerCounter++)
+        {
+            if(childProcesses.processGroupId[processNumbers[innerCounter]] == processGroupId)
+            {
+                // A re-adopted process is signalled through its pidfd, so that the signal can not reach a process reusing its pid.
+                if(childProcesses.processFileDescriptor[processNumbers[innerCounter]] != -1)
+                {
+                    pidfd_send_signal(childProcesses.processFileDescriptor[processNumbers[innerCounter]], signalNumber, NULL, 0);
                 }
                 else
                 {
-                    printf("Failed to terminate the process.\nThe process is already terminated.\n");
+                    kill(childProcesses.processId[processNumbers[innerCounter]], signalNumber);
                 }
-
-                return 1;
+                signalCalls++;
             }
         }
-
-        if(!processFound)
-        {
-            puts("The entered process number appears to be incorrect.\n"
-            "Please use the 'l' command to display child processes information.\n");
-
-            return 1;
-        }
     }
 
-    puts("The command you entered appears to be incorrect.\n"
-    "If needed, use the 'help' command to see the command list.\n");
-
-    return 1;
+    return signalCalls;
 }
 
 /*
-* Summary - This method will be used to run all child processes by using the configured scheduling algorithm.
-* Param 1 - cmdArguments - command line arguments
-* Returns 1, after a flawless execution
-* Answer to Question 9 (r #) & 10 (r all)
+* Summary - This method will parse a selection of child processes entered with the 'k', 'r' and 's' commands.
+* A selection is a comma separated list of process numbers (#), ranges (#-#), gangs (group:name) or 'all'.
+* Ranges are limited to the processes that exist, so 'k 10-500' selects the processes from 10 onwards.
+* Param 1 - selection - the entered selection
+* Param 2 - selectedProcesses - buffer of MAXIMUM_NUMBER_OF_CHILD_PROCESSES entries that is set to true for the selected processes
+* Returns the number of selected processes, -1 if the selection is invalid.
 */
-int resumeChildProcesses(char **cmdArguments)
+int parseProcessSelection(char *selection, bool *selectedProcesses)
 {
-    int childProcessNumber;
-    bool resumeAllChildProcesses = false, isInputValueADigit = true, isProcessRunning = false;
-
-    if(cmdArguments[1] != NULL && cmdArguments[2] == NULL)
-    {
-        // Declarations
-        int argDataLength = strlen(cmdArguments[1]);
-        int argCount;
-
-        // Step 1 - Validations
-        for(argCount = 0; argCount < argDataLength; argCount ++)
-        {
-            if(isdigit(cmdArguments[1][argCount]) == 0)
-            {
-                isInputValueADigit = false;
-                break;
-            }
-        }
+    // Declarations
+    char selectionCopy[BUFFER_SIZE], *selectionItem, *savePointer, *rangeSeparator;
+    int counter, firstProcessNo, lastProcessNo, gangNumber, selectedCount = 0;
 
-        if(strcmp(cmdArguments[1], "all") == 0)
-        {
-            resumeAllChildProcesses = true;
-        }
+    memset(selectedProcesses, 0, MAXIMUM_NUMBER_OF_CHILD_PROCESSES * sizeof(bool));
 
-        if(isInputValueADigit == false && resumeAllChildProcesses == false)
-        {
-            goto PrintError;
-        }
+    if(strlen(selection) >= sizeof(selectionCopy))
+    {
+        return -1;
+    }
+    strcpy(selectionCopy, selection);
 
-        if(childProcessCountTracker == 0)
+    for(selectionItem = strtok_r(selectionCopy, ",", &savePointer); selectionItem != NULL; selectionItem = strtok_r(NULL, ",", &savePointer))
+    {
+        if(strcmp(selectionItem, "all") == 0)
         {
-            printf("There aren't any child processes that have been created to resume their execution.\n");
-            return 1;
+            firstProcessNo = 0;
+            lastProcessNo = childProcessCountTracker - 1;
         }
-
-        int loopCounter;
-        bool isProcessAlive = false;
-
-        for(loopCounter = 0; loopCounter < childProcessCountTracker; loopCounter++)
+        else if(strncmp(selectionItem, "group:", 6) == 0)
         {
-            if(childProcesses[loopCounter].state != Terminated)
+            gangNumber = findGang(selectionItem + 6);
+            if(gangNumber == 0)
             {
-                isProcessAlive = true;
+                return -1;
+            }
 
-                if(childProcesses[loopCounter].state == Running)
+            for(counter = 0; counter < childProcessCountTracker; counter++)
+            {
+                if(childProcesses.gangNumber[counter] == gangNumber)
                 {
-                    isProcessRunning =  true;
-                    break;
+                    selectedProcesses[counter] = true;
                 }
             }
+            continue;
         }
-
-        if(!isProcessAlive)
-        {
-            printf("There is no process to run because all processes have been terminated.\n");
-            return 1;
-        }
-
-        if(isProcessRunning)
-        {
-            printf("There is an ongoing process execution. Please stop that first.\n");
-            return 1;
-        }
-
-        // Reset data
-        terminatedChildProcess = 0;
-
-        // Step 2 - Run a single process, as the user has entered r # command.
-        // This has nothing to do with the scheduling algorithm.
-        if(!resumeAllChildProcesses)
-        {
-            childProcessNumber = atoi(cmdArguments[1]);
-            int runChildProcessStatus = runChildProcess(childProcessNumber);
-            return runChildProcessStatus;
-        }
-        // Step 3 - Run all processes by using the scheduling algorithm
         else
         {
-            if(strcmp(schedulingAlgo, "") == 0)
+            rangeSeparator = strchr(selectionItem, '-');
+            if(rangeSeparator != NULL)
             {
-                printf("Please set the scheduling algorithm first in order to resume the process execution.\n");
-                return 1;
+                *rangeSeparator = '\0';
             }
 
-            if(strcmp(schedulingAlgo, "rr") == 0)
+            for(counter = 0; selectionItem[counter] != '\0'; counter++)
             {
-                if(roundRobinQuantumTimeInSecs <= 0)
+                if(isdigit(selectionItem[counter]) == 0)
                 {
-                    printf("Please set the quantum time for executing processes utilizing round robin scheduling.\n");
-                    return 1;
+                    return -1;
+                }
+            }
+            for(counter = 0; rangeSeparator != NULL && rangeSeparator[counter + 1] != '\0'; counter++)
+            {
+                if(isdigit(rangeSeparator[counter + 1]) == 0)
+                {
+                    return -1;
                 }
             }
 
-            int resumeStatus = runFirstProcessUsingSchedulingAlgorithm();
-            return resumeStatus;
+            if(selectionItem[0] == '\0' || (rangeSeparator != NULL && rangeSeparator[1] == '\0'))
+            {
+                return -1;
+            }
+
+            firstProcessNo = atoi(selectionItem);
+            lastProcessNo = rangeSeparator != NULL ? atoi(rangeSeparator + 1) : firstProcessNo;
+
+            if(firstProcessNo > lastProcessNo || (rangeSeparator == NULL && firstProcessNo >= childProcessCountTracker))
+            {
+                return -1;
+            }
+            if(lastProcessNo >= childProcessCountTracker)
+            {
+                lastProcessNo = childProcessCountTracker - 1;
+            }
+        }
+
+        for(counter = firstProcessNo; counter <= lastProcessNo; counter++)
+        {
+            selectedProcesses[counter] = true;
         }
     }
 
-    PrintError:puts("The entered value appears to be incorrect.\n"
-    "Please enter the process number or 'all' to resume the child process execution.\n"
-    "If needed, use the 'help' command to see the command list.\n");
+    for(counter = 0; counter < childProcessCountTracker; counter++)
+    {
+        if(selectedProcesses[counter])
+        {
+            selectedCount++;
+        }
+    }
 
-    return 1;
+    return selectedCount;
 }
 
 /*
-* Summary - This method will be called for running the first non-terminated process using the configured scheduling algorithm.
-* It will run the first process, and the rest will be executed by the alarm handler.
-* Returns 1, after a flawless execution
+* Summary - In case of RR, this method will be called to preempt the running scheduling unit using SIGSTOP signal.
+* Param 1 - processNumber - the process identifier of the running process
 */
-int runFirstProcessUsingSchedulingAlgorithm()
+void suspendSchedulingUnit(int processNumber)
 {
     // Declarations
-    int processInfoCounter;
+    int counter, memberCount, runningMemberCount = 0;
+    int unitMembers[MAXIMUM_NUMBER_OF_CHILD_PROCESSES];
 
-    for(processInfoCounter = 0; processInfoCounter < childProcessCountTracker; processInfoCounter++)
+    memberCount = getSchedulingUnit(processNumber, unitMembers);
+
+    for(counter = 0; counter < memberCount; counter++)
     {
-        if(childProcesses[processInfoCounter].state != Terminated)
+        if(childProcesses.state[unitMembers[counter]] == Running)
         {
-            // runningOneProcess is 0, as 'r all' command is executing
-            runningOneProcess = 0;
-
-            if(strcmp(schedulingAlgo, "rr") == 0)
-            {
-                printf("\033[0;34m");
-                printf("***Running all processes using Round Robin***\n\n");
-                printf("\033[0m");
-
-            }
-
-            if(strcmp(schedulingAlgo, "fcfs") == 0)
-            {
-                printf("\033[0;34m");
-                printf("***Running all processes using FCFS***\n\n");
-                printf("\033[0m");
-
-            }
-
-            runChildProcessUsingSchedulingAlgo(processInfoCounter);
-            return 1;
+            endTimeSlice(unitMembers[counter]);
+            childProcesses.preemptionTimeInMicros[unitMembers[counter]] = getMonotonicTimeInMicros();
+            setProcessState(unitMembers[counter], Suspended);
+            logSchedulerEvent(LogInfo, "\033[0;32m", "Child %d -> Running -> Suspended\n", childProcesses.processId[unitMembers[counter]]);
+            unitMembers[runningMemberCount] = unitMembers[counter];
+            runningMemberCount++;
         }
     }
+    logSchedulerEvent(LogInfo, NULL, "\n");
 
-    return 1;
+    sendSignalToProcesses(unitMembers, runningMemberCount, SIGSTOP);
+    if(runningMemberCount > 0)
+    {
+        __atomic_add_fetch(&metrics.preemptionCount, 1, __ATOMIC_RELAXED);
+    }
 }
 
 /*
-* Summary - This method will run the process for the entered process number (r # command).
-* It will just run the process by using SIGCONT. It will not use any scheduling algorithm.
-* Param 1 - childProcessNumber - Unique identifier for the process
-* Returns 1, after a flawless execution
+* Summary - If burst time is set in FCFS, this method will be called to kill the running scheduling unit.
+* All the members are sent SIGKILL first, and are then reaped one by one.
+* Param 1 - processNumber - the process identifier of the running process
 */
-int runChildProcess(int processNumber)
+void terminateSchedulingUnit(int processNumber)
 {
     // Declarations
-    int processInfoCounter;
-    bool processFound = false;
-
-    // Validations
-    for(processInfoCounter = 0; processInfoCounter < childProcessCountTracker; processInfoCounter++)
-    {
-        if(childProcesses[processInfoCounter].processNumber == processNumber)
-        {
-            if(childProcesses[processInfoCounter].state == Terminated)
-            {
-                printf("The child process %d having process number %d is already terminated.\n",
-                childProcesses[processInfoCounter].processId, processNumber);
+    int counter, memberCount, childStatus;
+    int unitMembers[MAXIMUM_NUMBER_OF_CHILD_PROCESSES];
 
-                return 1;
-            }
+    memberCount = getSchedulingUnit(processNumber, unitMembers);
 
-            processFound = true;
-            break;
-        }
-    }
+    sendSignalToProcesses(unitMembers, memberCount, SIGKILL);
+    __atomic_add_fetch(&metrics.terminationCount, 1, __ATOMIC_RELAXED);
 
-    if(!processFound)
+    for(counter = 0; counter < memberCount; counter++)
     {
-        puts("The entered process number appears to be incorrect.\n"
-        "Please use the 'l' command to display child processes information.\n");
+        waitpid(childProcesses.processId[unitMembers[counter]], &childStatus, 0);
 
-        return 1;
+        setProcessState(unitMembers[counter], Terminated);
+        logSchedulerEvent(LogInfo, "\033[0;32m", "Child %d -> Running -> Terminated\n\n", childProcesses.processId[unitMembers[counter]]);
     }
+}
 
-    // runningOneProcess is 1, as 'r #' command is entered by the user
-    runningOneProcess = 1;
-
-    printf("\033[0;35m");
-
-    printf("Child %d -> Suspended -> Ready\n", childProcesses[processNumber].processId);
-    childProcesses[processNumber].state = Ready;
-    printf("Child %d -> Ready -> Running\n", childProcesses[processNumber].processId);
-    childProcesses[processNumber].state = Running;
-
-    kill(childProcesses[processNumber].processId, SIGCONT);
+/*
+* Summary - This method will get the current time of the monotonic clock.
+* Returns the time in microseconds
+*/
+long long getMonotonicTimeInMicros()
+{
+    // Declarations
+    struct timespec currentTime;
 
-    printf("\033[0m");
+    clock_gettime(CLOCK_MONOTONIC, &currentTime);
 
-    return 1;
+    return (currentTime.tv_sec * 1000000LL) + (currentTime.tv_nsec / 1000);
 }
 
 /*
-* Summary - This method will run child process using the scheduling algorithm.
-* The execution of child process will be started using SIGCONT.
-* Param 1 - processNumber - The unique identifier of the child process.
+* Summary - This method will read the scheduling statistics of a child process from /proc/<pid>/schedstat.
+* Param 1 - processId - the child process id
+* Param 2 - cpuTimeInNanos - receives the time the process has spent on the cpu
+* Param 3 - runDelayInNanos - receives the time the process has spent waiting on a run queue
+* Returns 1, if the statistics are read, else 0.
 */
-void runChildProcessUsingSchedulingAlgo(int processNumber)
+int readProcessSchedulingStats(int processId, long long *cpuTimeInNanos, long long *runDelayInNanos)
 {
-    printf("\033[0;35m");
+    // Declarations
+    char filePath[64];
+    FILE *statsFile;
+    int fieldsRead;
 
-    printf("Child %d -> Suspended -> Ready\n", childProcesses[processNumber].processId);
-    childProcesses[processNumber].state = Ready;
-    printf("Child %d -> Ready -> Running\n", childProcesses[processNumber].processId);
-    childProcesses[processNumber].state = Running;
+    snprintf(filePath, sizeof(filePath), "/proc/%d/schedstat", processId);
 
-    // If RR, then apply the quantum time using alarm
-    if(strcmp(schedulingAlgo, "rr") == 0)
-    {
-        alarm(roundRobinQuantumTimeInSecs);
-    }
-    // If FCFS, if burst time is provided, then apply the burst time using alarm
-    if(strcmp(schedulingAlgo, "fcfs") == 0)
+    statsFile = fopen(filePath, "r");
+    if(statsFile == NULL)
     {
-        if(fcfsBurstTimeInSecs > 0)
-        {
-            alarm(fcfsBurstTimeInSecs);
-        }
+        return 0;
     }
 
-    // Start the process
-    kill(childProcesses[processNumber].processId, SIGCONT);
-    printf("\033[0m");
+    fieldsRead = fscanf(statsFile, "%lld %lld", cpuTimeInNanos, runDelayInNanos);
+    fclose(statsFile);
+
+    return fieldsRead == 2;
 }
 
 /*
-* Summary - This method will get process state name by state id.
-* Param 1 - processStateId - process state id
-* Returns - Process state name
+* Summary - This method will get the quantum time to be used for the given process.
+* Param 1 - processNumber - the process identifier
+* Returns the quantum time in milliseconds
 */
-char* getProcessState(int processStateId)
+int getQuantumTimeInMillis(int processNumber)
 {
-    switch(processStateId)
+    if(autoQuantumEnabled && childProcesses.quantumTimeInMillis[processNumber] > 0)
     {
-        case 1: return "Ready";
-        case 2: return "Running";
-        case 3: return "Suspended";
-        case 4: return "Terminated";
+        return childProcesses.quantumTimeInMillis[processNumber];
     }
+
+    return roundRobinQuantumTimeInMillis;
 }
 
 /*
-* Summary - This method will display the child processes information.
-* Process Number, Child Process Id, Parent Process Id, Process State
-* Param 1 - cmdArguments - command line arguments
-* Returns 1, after a flawless execution
-* Answer to Question 4 (l: to list the current user processes in the system including it PID, process number, and state)
+* Summary - This method will schedule the alarm with a millisecond resolution.
+* Like alarm(), it replaces any previously scheduled alarm, and 0 cancels it. The cpu time burst timer is cancelled as well.
+* The time at which the alarm is due is remembered, to measure how late it fires.
+* Param 1 - timeInMillis - time after which the alarm handler gets invoked
 */
-int displayChildProcessInformation(char **cmdArguments)
+void armSchedulerTimer(int timeInMillis)
 {
     // Declarations
-    int processInfoCounter, childStatus;
+    struct itimerval timerValue;
 
-    if(cmdArguments[1] == NULL)
+    if(burstTimerCreated)
     {
-        if(childProcessCountTracker == 0)
-        {
-            printf("There aren't any child processes that have been created to show their information.\n");
-        }
-        for(processInfoCounter = 0; processInfoCounter < childProcessCountTracker; processInfoCounter++)
-        {
-            printf("\033[0;36m");
-            printf("Process %d, PID %d, PPID %d, State %s\n", childProcesses[processInfoCounter].processNumber,
-            childProcesses[processInfoCounter].processId, getpid(), getProcessState(childProcesses[processInfoCounter].state));
-            printf("\033[0m");
-        }
-        return 1;
+        timer_delete(burstTimer);
+        burstTimerCreated = false;
     }
 
-    puts("The command you entered appears to be incorrect.\n"
-    "If needed, use the 'help' command to see the command list.\n");
+    memset(&timerValue, 0, sizeof(timerValue));
+    timerValue.it_value.tv_sec = timeInMillis / 1000;
+    timerValue.it_value.tv_usec = (timeInMillis % 1000) * 1000;
 
-    return 1;
+    metrics.timerDeadlineInMicros = timeInMillis > 0 ? getMonotonicTimeInMicros() + timeInMillis * 1000LL : 0;
+    setitimer(ITIMER_REAL, &timerValue, NULL);
 }
 
 /*
-* Summary - This method will create child processes.
-* Param 1 - cmdArguments - command line arguments
-* Returns 1, after a flawless execution
-* Answer to question 2 (c #)
+* Summary - This method will schedule the alarm after the given cpu time of a child process, to enforce the FCFS burst time.
+* The timer runs on the cpu time clock of the process, so the time it spends stopped, sleeping or waiting for the cpu does not
+* count towards its burst. The SIGALRM of the timer is delivered to the shell, that created it.
+* If the cpu time clock is not available, the burst time is measured with the wall clock as before.
+* Param 1 - processNumber - the process identifier, the cpu time of a gang is measured on the member that leads it
+* Param 2 - timeInMillis - cpu time after which the alarm handler gets invoked
 */
-int createChildProcesses(char **cmdArguments)
+void armBurstTimer(int processNumber, int timeInMillis)
 {
-    if(cmdArguments[1] != NULL && cmdArguments[2] == NULL)
-    {
-        // Declarations
-        int argDataLength = strlen(cmdArguments[1]);
-        int argCount, forkStatus;
+    // Declarations
+    clockid_t cpuClock;
+    struct sigevent timerEvent;
+    struct itimerspec timerValue;
 
-        for(argCount = 0; argCount < argDataLength; argCount ++)
-        {
-            if(isdigit(cmdArguments[1][argCount]) == 0)
-            {
-                goto PrintError;
-            }
-        }
+    armSchedulerTimer(0);
 
-        int childProcessCount = atoi(cmdArguments[1]);
+    memset(&timerEvent, 0, sizeof(timerEvent));
+    timerEvent.sigev_notify = SIGEV_SIGNAL;
+    timerEvent.sigev_signo = SIGALRM;
 
-        if(childProcessCount > 0 && childProcessCount <= MAXIMUM_NUMBER_OF_CHILD_PROCESSES)
+    memset(&timerValue, 0, sizeof(timerValue));
+    timerValue.it_value.tv_sec = timeInMillis / 1000;
+    timerValue.it_value.tv_nsec = (timeInMillis % 1000) * 1000000L;
+
+    if(clock_getcpuclockid(childProcesses.processId[processNumber], &cpuClock) == 0
+    && timer_create(cpuClock, &timerEvent, &burstTimer) == 0)
+    {
+        burstTimerCreated = true;
+        if(timer_settime(burstTimer, 0, &timerValue, NULL) == 0)
         {
-            forkStatus = forkParentProcess(childProcessCount);
-            return forkStatus;
+            // The alarm is not due at a known time, so its overshoot is not measured.
+            return;
         }
     }
 
-    // The user has entered an invalid value for the no. of child processes to be generated. Display the error and proceed the execution.
-    PrintError: printf("The entered value for the no. of child processes to be generated appears to be incorrect.\nPlease set the value to atleast 1 and no longer than %d.\nIf needed, use the 'help' command to see the command list.\n", MAXIMUM_NUMBER_OF_CHILD_PROCESSES);
-
-    return 1;
+    armSchedulerTimer(timeInMillis);
 }
 
 /*
-* Summary - This method will fork the parent process for creating the entered number of child processes.
-* Param 1 - childProcessCount - Number of child processes to be created.
-* 1. Run a for loop for childProcessCount times, and create a child process in every iteration.
-* 2. Load './process' program using execvp in the newly created child process.
-* 3. Add the new child process in the childProcesses struct by calling addChildProcess method.
-* Returns 1, after a flawless execution
+* Summary - This method will record how late the alarm fired, compared to the time it was set for.
+* Param 1 - alarmTimeInMicros - time at which the alarm handler got invoked
 */
-int forkParentProcess(int childProcessCount)
+void recordTimerOvershoot(long long alarmTimeInMicros)
 {
     // Declarations
-    int processCount, childProcessId, procNo;
-    enum processStates state;
-    char *processName = "./proce";
+    long long overshootInMicros;
 
-    for(processCount = 0; processCount < childProcessCount; processCount ++)
+    __atomic_add_fetch(&metrics.alarmCount, 1, __ATOMIC_RELAXED);
+
+    if(metrics.timerDeadlineInMicros == 0)
     {
-        int processCreationAllowed = creationOfChildProcessAllowed();
-        if(!processCreationAllowed)
+        return;
+    }
+
+    overshootInMicros = alarmTimeInMicros - metrics.timerDeadlineInMicros;
+    if(overshootInMicros < 0)
+    {
+        overshootInMicros = 0;
+    }
+    metrics.timerDeadlineInMicros = 0;
+    recordLatency(&timerOvershootHistogram, overshootInMicros);
+
+    __atomic_add_fetch(&metrics.timerOvershootInMicros, overshootInMicros, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&metrics.timerOvershootCount, 1, __ATOMIC_RELAXED);
+    if(overshootInMicros > metrics.maximumTimerOvershootInMicros)
+    {
+        metrics.maximumTimerOvershootInMicros = overshootInMicros;
+    }
+}
+
+/*
+* Summary - This method will be called when a process gets the cpu, to start accounting its time slice.
+* If the process was preempted by RR earlier, the time it waited for the cpu is recorded as a response time sample.
+* Param 1 - processNumber - the process identifier
+*/
+void startTimeSlice(int processNumber)
+{
+    // Declarations
+    long long currentTimeInMicros = getMonotonicTimeInMicros();
+
+    if(childProcesses.preemptionTimeInMicros[processNumber] > 0)
+    {
+        responseTimeSamplesInMicros[responseTimeSampleCount % NUMBER_OF_RESPONSE_TIME_SAMPLES] =
+        currentTimeInMicros - childProcesses.preemptionTimeInMicros[processNumber];
+        responseTimeSampleCount++;
+        childProcesses.preemptionTimeInMicros[processNumber] = 0;
+    }
+
+    childProcesses.sliceStartTimeInMicros[processNumber] = currentTimeInMicros;
+
+    // Reading /proc is too slow for the alarm handler, and not safe in it, so the main loop reads the statistics of the slice,
+    // once the process has been continued. They are only needed by 'q auto'.
+    childProcesses.sliceStartCpuTimeInNanos[processNumber] = -1;
+    if(autoQuantumEnabled)
+    {
+        timeSliceStatsPending = true;
+    }
+}
+
+/*
+* Summary - This method will compare two response time samples for qsort.
+*/
+int compareResponseTimes(const void *first, const void *second)
+{
+    long long firstTime = *(const long long *)first, secondTime = *(const long long *)second;
+
+    return (firstTime > secondTime) - (firstTime < secondTime);
+}
+
+/*
+* Summary - This method will compute the 99th percentile of the recent response time samples.
+* Returns the p99 response time in microseconds, 0 if there are no samples.
+*/
+long long getP99ResponseTimeInMicros()
+{
+    // Declarations
+    long long sortedSamples[NUMBER_OF_RESPONSE_TIME_SAMPLES];
+    int sampleCount = responseTimeSampleCount;
+
+    if(sampleCount > NUMBER_OF_RESPONSE_TIME_SAMPLES)
+    {
+        sampleCount = NUMBER_OF_RESPONSE_TIME_SAMPLES;
+    }
+
+    if(sampleCount == 0)
+    {
+        return 0;
+    }
+
+    memcpy(sortedSamples, responseTimeSamplesInMicros, sampleCount * sizeof(long long));
+    qsort(sortedSamples, sampleCount, sizeof(long long), compareResponseTimes);
+
+    return sortedSamples[(sampleCount * 99) / 100];
+}
+
+/*
+* Summary - This method will be called when the time slice of a running process ends.
+* If 'q auto' is enabled, the end of the slice is recorded, and the main loop tunes the quantum time of the process on the basis
+* of the slice, as the statistics of the process can not be read in the alarm handler.
+* Param 1 - processNumber - the process identifier
+*/
+void endTimeSlice(int processNumber)
+{
+    // The statistics of the start of the slice were never read, so the slice can not be accounted.
+    if(!autoQuantumEnabled || childProcesses.sliceStartCpuTimeInNanos[processNumber] == -1)
+    {
+        return;
+    }
+
+    childProcesses.sliceEndTimeInMicros[processNumber] = getMonotonicTimeInMicros();
+    timeSliceStatsPending = true;
+}
+
+/*
+* Summary - This method will read the scheduling statistics of the time slices that started or ended since it last ran.
+* It runs in the main loop, with the signals of the scheduler blocked. A process that is stopped does not use the cpu, so the statistics read
+* after its slice ended are those of the end of the slice, and they are those of the start of its next slice as well.
+*/
+void readPendingTimeSliceStats()
+{
+    // Declarations
+    int processNumber;
+    long long cpuTimeInNanos, runDelayInNanos;
+    sigset_t previousSignals;
+
+    if(!timeSliceStatsPending)
+    {
+        return;
+    }
+
+    blockSchedulerSignals(&previousSignals);
+
+    timeSliceStatsPending = false;
+    for(processNumber = 0; processNumber < childProcessCountTracker; processNumber++)
+    {
+        if(childProcesses.state[processNumber] == Terminated ||
+        (childProcesses.sliceEndTimeInMicros[processNumber] == 0 && childProcesses.sliceStartCpuTimeInNanos[processNumber] != -1))
         {
-            printf("Maximum number of child processes created. Only %d processes can be created with this shell.\n",
-            MAXIMUM_NUMBER_OF_CHILD_PROCESSES);
-            break;
+            continue;
         }
 
-        childProcessId = fork();
-
-        // Child process code
-        if(childProcessId == 0)
+        // Without the statistics, the slice can not be accounted, and the start of the next one stays unread.
+        if(!readProcessSchedulingStats(childProcesses.processId[processNumber], &cpuTimeInNanos, &runDelayInNanos))
         {
-            char *arguments[] = {processName, NULL};
-            execvp(processName, arguments);
+            childProcesses.sliceEndTimeInMicros[processNumber] = 0;
+            continue;
         }
-        // Parent process code
-        else if(childProcessId > 0)
+
+        if(childProcesses.sliceEndTimeInMicros[processNumber] != 0)
         {
-            state = Suspended;
-            addChildProcess(childProcessId, state);
-            printf("Child %d of Parent %d has been created.\n", childProcessId, getpid());
+            accountTimeSlice(processNumber, cpuTimeInNanos, runDelayInNanos);
+            childProcesses.sliceEndTimeInMicros[processNumber] = 0;
         }
-        // Fork failure
-        else
+
+        if(childProcesses.sliceStartCpuTimeInNanos[processNumber] == -1)
         {
-            // The creation of child process has failed. So return 0 to stop the execution of the program.
-            printf("The creation of child process failed.\n");
-            return 0;
+            childProcesses.sliceStartCpuTimeInNanos[processNumber] = cpuTimeInNanos;
+            childProcesses.sliceStartRunDelayInNanos[processNumber] = runDelayInNanos;
         }
     }
 
-    return 1;
+    unblockSchedulerSignals(&previousSignals);
 }
 
 /*
-* Summary - This method will check, if the shell can create new child processes.
-* This shell is designed to create only MAXIMUM_NUMBER_OF_CHILD_PROCESSES processes.
-* Returns 1, after a flawless execution
+* Summary - This method will tune the quantum time of a process on the basis of its last time slice ('q auto'):
+* 1. If the context switch overhead is above TARGET_SWITCH_OVERHEAD_IN_PERCENT, the quantum time is doubled.
+* 2. Else if the p99 response time is above TARGET_P99_RESPONSE_TIME_IN_MILLISECS, the quantum time is halved.
+* 3. Else if the process was blocked for most of the time slice, the quantum time is reduced by a quarter,
+*    as it does not need the cpu for that long.
+* 4. Else if the process was on the cpu for almost the whole time slice, the quantum time is increased by a quarter.
+* The quantum time is kept within MINIMUM_AUTO_QUANTUM_TIME_IN_MILLISECS and MAXIMUM_AUTO_QUANTUM_TIME_IN_MILLISECS,
+* and every adjustment is logged for the 'stats' command.
+* Param 1 - processNumber - the process identifier
+* Param 2 - cpuTimeInNanos - cpu time consumed by the process when the slice ended
+* Param 3 - runDelayInNanos - time the process had spent waiting on a run queue when the slice ended
 */
-int creationOfChildProcessAllowed()
+void accountTimeSlice(int processNumber, long long cpuTimeInNanos, long long runDelayInNanos)
 {
-    // Decalrations
-    int totalChildProcesses = 0;
-    totalChildProcesses = childProcessCountTracker + 1;
+    // Declarations
+    long long sliceTimeInMicros, switchOverheadInMicros;
+    int cpuUsageInPercent, switchOverheadInPermille, oldQuantumTimeInMillis, newQuantumTimeInMillis;
+    char *reason = NULL;
+    struct quantumAdjustment *adjustment;
 
-    if(totalChildProcesses > MAXIMUM_NUMBER_OF_CHILD_PROCESSES)
+    sliceTimeInMicros = childProcesses.sliceEndTimeInMicros[processNumber] - childProcesses.sliceStartTimeInMicros[processNumber];
+    if(sliceTimeInMicros <= 0)
     {
-        return 0;
+        return;
     }
 
-    childProcessCountTracker = totalChildProcesses;
+    // The overhead of a time slice is the time taken by the shell to switch to the process,
+    // plus the time the process waited on a run queue after it was continued.
+    switchOverheadInMicros = lastSwitchOverheadInMicros + ((runDelayInNanos - childProcesses.sliceStartRunDelayInNanos[processNumber]) / 1000);
+    cpuUsageInPercent = (int)(((cpuTimeInNanos - childProcesses.sliceStartCpuTimeInNanos[processNumber]) / 1000) * 100 / sliceTimeInMicros);
+    switchOverheadInPermille = (int)((switchOverheadInMicros * 1000) / sliceTimeInMicros);
+
+    oldQuantumTimeInMillis = getQuantumTimeInMillis(processNumber);
+    newQuantumTimeInMillis = oldQuantumTimeInMillis;
+
+    if(switchOverheadInPermille > TARGET_SWITCH_OVERHEAD_IN_PERCENT * 10)
+    {
+        newQuantumTimeInMillis = oldQuantumTimeInMillis * 2;
+        reason = "switch overhead above target";
+    }
+    else if(getP99ResponseTimeInMicros() > TARGET_P99_RESPONSE_TIME_IN_MILLISECS * 1000LL)
+    {
+        newQuantumTimeInMillis = oldQuantumTimeInMillis / 2;
+        reason = "p99 response time above target";
+    }
+    else if(cpuUsageInPercent < 50)
+    {
+        newQuantumTimeInMillis = oldQuantumTimeInMillis - (oldQuantumTimeInMillis / 4);
+        reason = "blocked for most of the slice";
+    }
+    else if(cpuUsageInPercent >= 90)
+    {
+        newQuantumTimeInMillis = oldQuantumTimeInMillis + (oldQuantumTimeInMillis / 4);
+        reason = "cpu bound for the whole slice";
+    }
+
+    if(newQuantumTimeInMillis < MINIMUM_AUTO_QUANTUM_TIME_IN_MILLISECS)
+    {
+        newQuantumTimeInMillis = MINIMUM_AUTO_QUANTUM_TIME_IN_MILLISECS;
+    }
+    if(newQuantumTimeInMillis > MAXIMUM_AUTO_QUANTUM_TIME_IN_MILLISECS)
+    {
+        newQuantumTimeInMillis = MAXIMUM_AUTO_QUANTUM_TIME_IN_MILLISECS;
+    }
+
+    childProcesses.quantumTimeInMillis[processNumber] = newQuantumTimeInMillis;
+
+    if(newQuantumTimeInMillis != oldQuantumTimeInMillis)
+    {
+        adjustment = &quantumAdjustments[quantumAdjustmentCount % NUMBER_OF_LOGGED_QUANTUM_ADJUSTMENTS];
+        adjustment->processId = childProcesses.processId[processNumber];
+        adjustment->oldQuantumTimeInMillis = oldQuantumTimeInMillis;
+        adjustment->newQuantumTimeInMillis = newQuantumTimeInMillis;
+        adjustment->cpuUsageInPercent = cpuUsageInPercent;
+        adjustment->switchOverheadInPermille = switchOverheadInPermille;
+        adjustment->reason = reason;
+        quantumAdjustmentCount++;
+    }
+}
+
+/*
+* Summary - This method will suspend non-terminated child processes using SIGSTOP signal.
+* The childProcesses struct will also get updated with SUSPENDED process state.
+* Besides 's all', a selection of processes can be suspended, for example 's 1,4,9'.
+* Param 1 - cmdArguments - command line arguments
+* Returns 1, after a flawless execution
+* Answer to Question 11 (s all)
+*/
+int suspendAll(char **cmdArguments)
+{
+    // Declarations
+    int processInfoCounter, suspendedProcessCount = 0;
+    int processesToSuspend[MAXIMUM_NUMBER_OF_CHILD_PROCESSES];
+    bool selectedProcesses[MAXIMUM_NUMBER_OF_CHILD_PROCESSES];
+
+    if(cmdArguments[1] != NULL && cmdArguments[2] == NULL)
+    {
+        if(parseProcessSelection(cmdArguments[1], selectedProcesses) >= 0)
+        {
+            for(processInfoCounter = 0; processInfoCounter < childProcessCountTracker; processInfoCounter++)
+            {
+                if(selectedProcesses[processInfoCounter] && childProcesses.state[processInfoCounter] != Terminated)
+                {
+                    processesToSuspend[suspendedProcessCount] = processInfoCounter;
+                    suspendedProcessCount++;
+                }
+            }
+
+            if(suspendedProcessCount == 0)
+            {
+                puts("There is nothing to suspend because all of the processes have either been terminated or not created at all.\n");
+                return 1;
+            }
+
+            sendSignalToProcesses(processesToSuspend, suspendedProcessCount, SIGSTOP);
+
+            for(processInfoCounter = 0; processInfoCounter < suspendedProcessCount; processInfoCounter++)
+            {
+                setProcessState(processesToSuspend[processInfoCounter], Suspended);
+            }
+
+            // Cancel the future alarm, if no process is left running
+            if(countRunningProcesses() == 0)
+            {
+                armSchedulerTimer(0);
+            }
 
+            puts("The child processes are moved to a suspended state.\n");
+            return 1;
+        }
+    }
+    puts("The command you entered to suspend the child processes appears to be incorrect.\n"
+    "If needed, use the 'help' command to see the command list.\n");
     return 1;
 }
 
 /*
-* Summary - This method will clear the console.
+* Summary - This method will be used to terminate child processes by using SIGKILL command.
+* Besides a process number, a selection of processes can be terminated, for example 'k 10-500' or 'k group:name'.
+* Param 1 - cmdArguments - command line arguments
 * Returns 1, after a flawless execution
+* Answer to Question 8 (k #)
 */
-int clearConsole(char **cmdArguments)
+int terminateChildProcess(char **cmdArguments)
 {
-    if(cmdArguments[1] == NULL)
+    if(cmdArguments[1] != NULL && cmdArguments[2] == NULL)
     {
-        system("clear");
+        // Declarations
+        int processInfoCounter, childStatus, selectedCount, terminatedProcessCount = 0, terminatedRunningProcessId = 0;
+        int processesToTerminate[MAXIMUM_NUMBER_OF_CHILD_PROCESSES];
+        bool selectedProcesses[MAXIMUM_NUMBER_OF_CHILD_PROCESSES];
+
+        selectedCount = parseProcessSelection(cmdArguments[1], selectedProcesses);
+
+        if(selectedCount <= 0)
+        {
+            puts("The entered process number appears to be incorrect.\n"
+            "Please use the 'l' command to display child processes information.\n");
+            return 1;
+        }
+
+        // If the process is not terminated, then terminate it.
+        for(processInfoCounter = 0; processInfoCounter < childProcessCountTracker; processInfoCounter++)
+        {
+            if(selectedProcesses[processInfoCounter] && childProcesses.state[processInfoCounter] != Terminated)
+            {
+                if(childProcesses.state[processInfoCounter] == Running)
+                {
+                    terminatedRunningProcessId = childProcesses.processId[processInfoCounter];
+                }
+
+                processesToTerminate[terminatedProcessCount] = processInfoCounter;
+                terminatedProcessCount++;
+            }
+        }
+
+        if(terminatedProcessCount == 0)
+        {
+            printf("Failed to terminate the process.\nThe process is already terminated.\n");
+            return 1;
+        }
+
+        sendSignalToProcesses(processesToTerminate, terminatedProcessCount, SIGKILL);
+
+        for(processInfoCounter = 0; processInfoCounter < terminatedProcessCount; processInfoCounter++)
+        {
+            setProcessState(processesToTerminate[processInfoCounter], Terminated);
+            waitpid(childProcesses.processId[processesToTerminate[processInfoCounter]], &childStatus, 0);
+            printf("The process with number %d has been terminated.\n", childProcesses.processNumber[processesToTerminate[processInfoCounter]]);
+        }
+
+        // If the terminated process was a running process,
+        // then for rr or fcfs, the alarm should be called immediately to run the next process.
+        // runningOneProcess will indicate if all processes are running (r all) or just 1 process (r #)
+        // runningOneProcess is 1, then it means the process is running because of r # command, and it has nothing
+        // to do with FCFS or RR
+        // A gang keeps its time slice while any of its other members is still running.
+        if(runningOneProcess == 0 && terminatedRunningProcessId != 0 && countRunningProcesses() == 0)
+        {
+            terminatedChildProcess = terminatedRunningProcessId;
+            // The need for immediate calling arises from the fact that, for instance if the quantum time is
+            // set to 50 secs, the next process will start after that amount of time.
+            // This alarm is not a timer that expired, so its overshoot is not measured.
+            metrics.timerDeadlineInMicros = 0;
+            ualarm(1, 0);
+        }
+
         return 1;
     }
 
-    puts("The entered command appears to be incorrect.\n"
-    "Please use the 'help' command to see the command list.\n");
+    puts("The command you entered appears to be incorrect.\n"
+    "If needed, use the 'help' command to see the command list.\n");
 
     return 1;
 }
 
 /*
-* Summary - This method will be used to set the quantum time that will be used by RR & RRN scheduling algorithms.
+* Summary - This method will be used to run all child processes by using the configured scheduling algorithm.
 * Param 1 - cmdArguments - command line arguments
 * Returns 1, after a flawless execution
-* Answer to question 5 (q #)
+* Answer to Question 9 (r #) & 10 (r all)
 */
-int setQuantumTime(char **cmdArguments)
+int resumeChildProcesses(char **cmdArguments)
 {
+    int childProcessNumber;
+    bool resumeAllChildProcesses = false, isInputValueADigit = true, isProcessRunning = false;
+
     if(cmdArguments[1] != NULL && cmdArguments[2] == NULL)
     {
         // Declarations
         int argDataLength = strlen(cmdArguments[1]);
-        int argCount, loopCounter;
+        int argCount;
 
+        // Step 1 - Validations
         for(argCount = 0; argCount < argDataLength; argCount ++)
         {
             if(isdigit(cmdArguments[1][argCount]) == 0)
             {
-                goto PrintError;
+                isInputValueADigit = false;
+                break;
             }
         }
 
-        if(isProcessRunning() == 0)
+        if(strcmp(cmdArguments[1], "all") == 0)
         {
-            printf("There is an ongoing process execution. Please stop that first and then set the quantum time.\n");
+            resumeAllChildProcesses = true;
+        }
+
+        // A selection of processes, for example 'r 1,4,9' or 'r group:name'
+        bool selectedProcesses[MAXIMUM_NUMBER_OF_CHILD_PROCESSES];
+        if(isInputValueADigit == false && resumeAllChildProcesses == false
+        && parseProcessSelection(cmdArguments[1], selectedProcesses) <= 0)
+        {
+            goto PrintError;
+        }
+
+        if(childProcessCountTracker == 0)
+        {
+            printf("There aren't any child processes that have been created to resume their execution.\n");
+            return 1;
+        }
+
+        bool isProcessAlive = countProcessesInState(Terminated) < childProcessCountTracker;
+
+        isProcessRunning = findNextProcessInState(Running, 0) != -1;
+
+        if(!isProcessAlive)
+        {
+            printf("There is no process to run because all processes have been terminated.\n");
+            return 1;
+        }
+
+        if(isProcessRunning)
+        {
+            printf("There is an ongoing process execution. Please stop that first.\n");
             return 1;
         }
 
-        int timeInSecs = atoi(cmdArguments[1]);
-
-        if(timeInSecs > 0 && timeInSecs <= MAXIMUM_ROUND_ROBIN_QUANTUM_TIME_IN_SECS)
+        // Reset data
+        terminatedChildProcess = 0;
+
+        // Step 2 - Run a single process, as the user has entered r # command.
+        // This has nothing to do with the scheduling algorithm.
+        if(!resumeAllChildProcesses && !isInputValueADigit)
+        {
+            return runSelectedChildProcesses(selectedProcesses);
+        }
+        else if(!resumeAllChildProcesses)
+        {
+            childProcessNumber = atoi(cmdArguments[1]);
+            int runChildProcessStatus = runChildProcess(childProcessNumber);
+            return runChildProcessStatus;
+        }
+        // Step 3 - Run all processes by using the scheduling algorithm
+        else
+        {
+            if(strcmp(schedulingAlgo, "") == 0)
+            {
+                printf("Please set the scheduling algorithm first in order to resume the process execution.\n");
+                return 1;
+            }
+
+            if(strcmp(schedulingAlgo, "rr") == 0)
+            {
+                if(roundRobinQuantumTimeInMillis <= 0)
+                {
+                    printf("Please set the quantum time for executing processes utilizing round robin scheduling.\n");
+                    return 1;
+                }
+            }
+
+            int resumeStatus = runFirstProcessUsingSchedulingAlgorithm();
+            return resumeStatus;
+        }
+    }
+
+    PrintError:puts("The entered value appears to be incorrect.\n"
+    "Please enter the process number, a selection of processes or 'all' to resume the child process execution.\n"
+    "If needed, use the 'help' command to see the command list.\n");
+
+    return 1;
+}
+
+/*
+* Summary - This method will be called for running the first non-terminated process using the configured scheduling algorithm.
+* It will run the first process, and the rest will be executed by the alarm handler.
+* Returns 1, after a flawless execution
+*/
+int runFirstProcessUsingSchedulingAlgorithm()
+{
+    // Declarations
+    int processInfoCounter = findNextSchedulableProcess(0, childProcessCountTracker);
+
+    if(processInfoCounter != -1)
+    {
+        // runningOneProcess is 0, as 'r all' command is executing
+        runningOneProcess = 0;
+
+        if(strcmp(schedulingAlgo, "rr") == 0)
+        {
+            setOutputColor("\033[0;34m");
+            printf("***Running all processes using Round Robin***\n\n");
+            setOutputColor("\033[0m");
+
+        }
+
+        if(strcmp(schedulingAlgo, "fcfs") == 0)
+        {
+            setOutputColor("\033[0;34m");
+            printf("***Running all processes using FCFS***\n\n");
+            setOutputColor("\033[0m");
+
+        }
+
+        runChildProcessUsingSchedulingAlgo(processInfoCounter);
+        return 1;
+    }
+
+    return 1;
+}
+
+/*
+* Summary - This method will run the process for the entered process number (r # command).
+* It will just run the process by using SIGCONT. It will not use any scheduling algorithm.
+* Param 1 - childProcessNumber - Unique identifier for the process
+* Returns 1, after a flawless execution
+*/
+int runChildProcess(int processNumber)
+{
+    // Declarations
+    int processInfoCounter;
+    bool processFound = false;
+
+    // Validations
+    for(processInfoCounter = 0; processInfoCounter < childProcessCountTracker; processInfoCounter++)
+    {
+        if(childProcesses.processNumber[processInfoCounter] == processNumber)
+        {
+            if(childProcesses.state[processInfoCounter] == Terminated)
+            {
+                printf("The child process %d having process number %d is already terminated.\n",
+                childProcesses.processId[processInfoCounter], processNumber);
+
+                return 1;
+            }
+
+            processFound = true;
+            break;
+        }
+    }
+
+    if(!processFound)
+    {
+        puts("The entered process number appears to be incorrect.\n"
+        "Please use the 'l' command to display child processes information.\n");
+
+        return 1;
+    }
+
+    // runningOneProcess is 1, as 'r #' command is entered by the user
+    runningOneProcess = 1;
+
+    logSchedulerEvent(LogDebug, "\033[0;35m", "Child %d -> Suspended -> Ready\n", childProcesses.processId[processNumber]);
+    setProcessState(processNumber, Ready);
+    logSchedulerEvent(LogInfo, "\033[0;35m", "Child %d -> Ready -> Running\n", childProcesses.processId[processNumber]);
+    setProcessState(processNumber, Running);
+
+    recordContinueTime(&processNumber, 1);
+    releaseYieldedProcesses(&processNumber, 1);
+    kill(childProcesses.processId[processNumber], SIGCONT);
+
+    return 1;
+}
+
+/*
+* Summary - This method will run a selection of processes (for example 'r 1,4,9' or 'r group:name') by using SIGCONT.
+* Like 'r #', it will not use any scheduling algorithm.
+* Param 1 - selectedProcesses - the processes selected with parseProcessSelection
+* Returns 1, after a flawless execution
+*/
+int runSelectedChildProcesses(bool *selectedProcesses)
+{
+    // Declarations
+    int processInfoCounter, resumedProcessCount = 0;
+    int processesToResume[MAXIMUM_NUMBER_OF_CHILD_PROCESSES];
+
+    for(processInfoCounter = 0; processInfoCounter < childProcessCountTracker; processInfoCounter++)
+    {
+        if(selectedProcesses[processInfoCounter] && childProcesses.state[processInfoCounter] != Terminated)
+        {
+            logSchedulerEvent(LogDebug, "\033[0;35m", "Child %d -> Suspended -> Ready\n", childProcesses.processId[processInfoCounter]);
+            setProcessState(processInfoCounter, Ready);
+            logSchedulerEvent(LogInfo, "\033[0;35m", "Child %d -> Ready -> Running\n", childProcesses.processId[processInfoCounter]);
+            setProcessState(processInfoCounter, Running);
+
+            processesToResume[resumedProcessCount] = processInfoCounter;
+            resumedProcessCount++;
+        }
+    }
+
+    if(resumedProcessCount == 0)
+    {
+        printf("The selected child processes are already terminated.\n");
+        return 1;
+    }
+
+    // runningOneProcess is 1, as the processes are run on the user's request and not by the scheduler
+    runningOneProcess = 1;
+
+    recordContinueTime(processesToResume, resumedProcessCount);
+    sendSignalToProcesses(processesToResume, resumedProcessCount, SIGCONT);
+
+    return 1;
+}
+
+/*
+* Summary - This method will run child process using the scheduling algorithm.
+* The execution of child process will be started using SIGCONT.
+* If the child process is a gang member, all the members of the gang are started together.
+* Param 1 - processNumber - The unique identifier of the child process.
+*/
+void runChildProcessUsingSchedulingAlgo(int processNumber)
+{
+    // Declarations
+    int counter, memberCount;
+    int unitMembers[MAXIMUM_NUMBER_OF_CHILD_PROCESSES];
+
+    memberCount = getSchedulingUnit(processNumber, unitMembers);
+
+    for(counter = 0; counter < memberCount; counter++)
+    {
+        logSchedulerEvent(LogDebug, "\033[0;35m", "Child %d -> Suspended -> Ready\n", childProcesses.processId[unitMembers[counter]]);
+        setProcessState(unitMembers[counter], Ready);
+        logSchedulerEvent(LogInfo, "\033[0;35m", "Child %d -> Ready -> Running\n", childProcesses.processId[unitMembers[counter]]);
+        setProcessState(unitMembers[counter], Running);
+        startTimeSlice(unitMembers[counter]);
+    }
+
+    // If RR, then apply the quantum time using alarm
+    if(strcmp(schedulingAlgo, "rr") == 0)
+    {
+        armSchedulerTimer(getQuantumTimeInMillis(processNumber));
+    }
+    // If FCFS, if burst time is provided, then apply the burst time using an alarm on the cpu time of the process
+    if(strcmp(schedulingAlgo, "fcfs") == 0)
+    {
+        if(fcfsBurstTimeInSecs > 0)
+        {
+            armBurstTimer(processNumber, fcfsBurstTimeInSecs * 1000);
+        }
+    }
+
+    // Start the process
+    recordContinueTime(unitMembers, memberCount);
+    sendSignalToProcesses(unitMembers, memberCount, SIGCONT);
+    __atomic_add_fetch(&metrics.dispatchCount, 1, __ATOMIC_RELAXED);
+}
+
+/*
+* Summary - This method will get process state name by state id.
+* Param 1 - processStateId - process state id
+* Returns - Process state name
+*/
+char* getProcessState(int processStateId)
+{
+    switch(processStateId)
+    {
+        case 1: return "Ready";
+        case 2: return "Running";
+        case 3: return "Suspended";
+        case 4: return "Terminated";
+    }
+}
+
+/*
+* Summary - This method will get the time since the last heartbeat of a child process.
+* A process that was just continued has not had the cpu to refresh its heartbeat yet, so the time since SIGCONT was sent is
+* used instead, till the process reports that it is running.
+* Param 1 - processNumber - the child process, having a control page
+* Returns the time since the last heartbeat in milliseconds
+*/
+long long getHeartbeatAgeInMillis(int processNumber)
+{
+    // Declarations
+    long long heartbeatTimeInMicros = __atomic_load_n(&childProcesses.controlPage[processNumber]->heartbeatTimeInMicros, __ATOMIC_ACQUIRE);
+
+    if(childProcesses.continueTimeInMicros[processNumber] > heartbeatTimeInMicros)
+    {
+        heartbeatTimeInMicros = childProcesses.continueTimeInMicros[processNumber];
+    }
+
+    return (getMonotonicTimeInMicros() - heartbeatTimeInMicros) / 1000;
+}
+
+/*
+* Summary - This method will format the information of a child process into a row of the 'l' command.
+* Process Number, Child Process Id, Parent Process Id, Process State, Gang Name, Cpu Time, and the progress published in its control page
+* A process re-adopted from a previous shell is not a child of this shell, so its parent is read from /proc, or shown as '-'.
+* Param 1 - processNumber - the child process
+* Param 2 - row - receives the row, without a newline
+* Param 3 - rowSize - size of the row buffer
+* Returns the length of the row
+*/
+int formatChildProcessInformation(int processNumber, char *row, int rowSize)
+{
+    // Declarations
+    struct controlPage *control = childProcesses.controlPage[processNumber];
+    long long heartbeatAgeInMillis, cpuTimeInNanos, runDelayInNanos;
+    int rowLength, parentProcessId = getpid();
+    char parentProcessIdText[16];
+
+    if(childProcesses.processFileDescriptor[processNumber] != -1)
+    {
+        parentProcessId = childProcesses.state[processNumber] != Terminated ? readParentProcessId(childProcesses.processId[processNumber]) : -1;
+    }
+    if(parentProcessId == -1)
+    {
+        snprintf(parentProcessIdText, sizeof(parentProcessIdText), "-");
+    }
+    else
+    {
+        snprintf(parentProcessIdText, sizeof(parentProcessIdText), "%d", parentProcessId);
+    }
+
+    rowLength = snprintf(row, rowSize, "Process %d, PID %d, PPID %s, State %s", childProcesses.processNumber[processNumber],
+    childProcesses.processId[processNumber], parentProcessIdText, getProcessState(childProcesses.state[processNumber]));
+    if(childProcesses.gangNumber[processNumber] != 0)
+    {
+        rowLength += snprintf(row + rowLength, rowSize - rowLength, ", Gang %s", gangs[childProcesses.gangNumber[processNumber] - 1].gangName);
+    }
+    if(childProcesses.state[processNumber] != Terminated
+    && readProcessSchedulingStats(childProcesses.processId[processNumber], &cpuTimeInNanos, &runDelayInNanos))
+    {
+        rowLength += snprintf(row + rowLength, rowSize - rowLength, ", CPU %.2f s", cpuTimeInNanos / 1000000000.0);
+    }
+    if(control != NULL && __atomic_load_n(&control->startTimeInMicros, __ATOMIC_ACQUIRE) == 0)
+    {
+        rowLength += snprintf(row + rowLength, rowSize - rowLength, ", Not started");
+    }
+    else if(control != NULL)
+    {
+        heartbeatAgeInMillis = getHeartbeatAgeInMillis(processNumber);
+        rowLength += snprintf(row + rowLength, rowSize - rowLength, ", Iterations %llu", __atomic_load_n(&control->iterationCount, __ATOMIC_RELAXED));
+        if(__atomic_load_n(&control->yieldState, __ATOMIC_ACQUIRE) == YieldParked)
+        {
+            rowLength += snprintf(row + rowLength, rowSize - rowLength, ", Yielded");
+        }
+        else if(childProcesses.state[processNumber] == Running && heartbeatAgeInMillis > HEARTBEAT_TIMEOUT_IN_MILLISECS)
+        {
+            rowLength += snprintf(row + rowLength, rowSize - rowLength, ", Not responding for %lld ms", heartbeatAgeInMillis);
+        }
+        else if(childProcesses.state[processNumber] == Running)
+        {
+            rowLength += snprintf(row + rowLength, rowSize - rowLength, ", Heartbeat %lld ms ago", heartbeatAgeInMillis);
+        }
+    }
+
+    return rowLength < rowSize ? rowLength : rowSize - 1;
+}
+
+/*
+* Summary - This method will format the information of a child process into a JSON object of the 'l --json' command.
+* Param 1 - processNumber - the child process
+* Param 2 - output - the output buffer
+*/
+void formatChildProcessJson(int processNumber, struct listOutput *output)
+{
+    // Declarations
+    struct controlPage *control = childProcesses.controlPage[processNumber];
+    long long cpuTimeInNanos = -1, runDelayInNanos;
+
+    if(childProcesses.state[processNumber] == Terminated
+    || !readProcessSchedulingStats(childProcesses.processId[processNumber], &cpuTimeInNanos, &runDelayInNanos))
+    {
+        cpuTimeInNanos = -1;
+    }
+
+    appendListOutput(output, "{\"process\":%d,\"pid\":%d,\"state\":\"%s\",\"gang\":", childProcesses.processNumber[processNumber],
+    childProcesses.processId[processNumber], getProcessState(childProcesses.state[processNumber]));
+    if(childProcesses.gangNumber[processNumber] != 0)
+    {
+        appendListOutput(output, "\"%s\"", gangs[childProcesses.gangNumber[processNumber] - 1].gangName);
+    }
+    else
+    {
+        appendListOutput(output, "null");
+    }
+    appendListOutput(output, ",\"process_group\":%d,\"cpu_seconds\":", childProcesses.processGroupId[processNumber]);
+    if(cpuTimeInNanos >= 0)
+    {
+        appendListOutput(output, "%.6f", cpuTimeInNanos / 1000000000.0);
+    }
+    else
+    {
+        appendListOutput(output, "null");
+    }
+    appendListOutput(output, ",\"memory_kb\":%ld,\"cache_domain\":%d,\"last_cpu\":%d", childProcesses.memoryUsageInKB[processNumber],
+    childProcesses.cacheDomain[processNumber], childProcesses.lastCpu[processNumber]);
+    if(control != NULL && __atomic_load_n(&control->startTimeInMicros, __ATOMIC_ACQUIRE) != 0)
+    {
+        appendListOutput(output, ",\"started\":true,\"iterations\":%llu,\"heartbeat_age_ms\":%lld,\"yielded\":%s}",
+        __atomic_load_n(&control->iterationCount, __ATOMIC_RELAXED),
+        getHeartbeatAgeInMillis(processNumber),
+        __atomic_load_n(&control->yieldState, __ATOMIC_ACQUIRE) == YieldParked ? "true" : "false");
+    }
+    else
+    {
+        appendListOutput(output, ",\"started\":%s,\"iterations\":null,\"heartbeat_age_ms\":null,\"yielded\":false}",
+        control != NULL ? "false" : "null");
+    }
+}
+
+/*
+* Summary - This method will write the whole output buffer of the 'l' command to the standard output.
+* Param 1 - output - the output buffer, it is empty afterwards
+*/
+void writeListOutput(struct listOutput *output)
+{
+    // Declarations
+    size_t bytesDone = 0;
+    ssize_t bytesWritten;
+
+    // Write the pending stdio output first, so that the order is kept.
+    fflush(stdout);
+
+    while(bytesDone < output->length)
+    {
+        bytesWritten = write(STDOUT_FILENO, output->data + bytesDone, output->length - bytesDone);
+        if(bytesWritten < 0)
+        {
+            if(errno == EINTR)
+            {
+                continue;
+            }
+            break;
+        }
+        bytesDone += bytesWritten;
+    }
+
+    output->length = 0;
+}
+
+/*
+* Summary - This method will append formatted text to the output buffer of the 'l' command.
+* A streaming buffer is written out once it is full, so the rows of a large table are written in a few large writes.
+* Any other buffer grows, so that it can be written with a single write call.
+* Param 1 - output - the output buffer
+* Param 2 - format - printf style format of the text
+*/
+void appendListOutput(struct listOutput *output, const char *format, ...)
+{
+    // Declarations
+    va_list formatArguments;
+    int textLength;
+    char *grownData;
+
+    while(1)
+    {
+        va_start(formatArguments, format);
+        textLength = vsnprintf(output->data + output->length, output->capacity - output->length, format, formatArguments);
+        va_end(formatArguments);
+
+        if(textLength < 0 || output->length + textLength < output->capacity)
+        {
+            break;
+        }
+
+        // The text did not fit, so make room and format it again.
+        if(output->streaming && output->length > 0)
+        {
+            writeListOutput(output);
+            continue;
+        }
+        grownData = realloc(output->data, (output->capacity + textLength) * 2);
+        if(grownData == NULL)
+        {
+            output->data[output->length] = '\0';
+            return;
+        }
+        output->data = grownData;
+        output->capacity = (output->capacity + textLength) * 2;
+    }
+
+    if(textLength > 0)
+    {
+        output->length += textLength;
+    }
+}
+
+/*
+* Summary - This method will parse the options of the 'l' command.
+* 'l state' and 'l --state=state' list the processes in that state, 'l --sort=key' sorts the rows on number, pid, state, cpu
+* or iterations, 'l --top=#' lists # rows, 'l --page=#' lists the #th page of rows, 'l --watch[=secs]' redraws the changed rows
+* every secs (1 by default), and 'l --json' lists the rows as JSON.
+* Param 1 - cmdArguments - command line arguments
+* Param 2 - options - receives the options
+* Returns 1, if the options are valid, else 0.
+*/
+int parseListOptions(char **cmdArguments, struct listOptions *options)
+{
+    // Declarations
+    char *sortKeys[] = {"number", "pid", "state", "cpu", "iterations"};
+    char *stateName, *value, *valueEnd;
+    int argCount, state, sortKey;
+    long optionValue;
+
+    memset(options, 0, sizeof(struct listOptions));
+    options->pageNumber = 1;
+
+    for(argCount = 1; cmdArguments[argCount] != NULL; argCount++)
+    {
+        value = strchr(cmdArguments[argCount], '=');
+        value = value != NULL ? value + 1 : NULL;
+        optionValue = value != NULL ? strtol(value, &valueEnd, 10) : 0;
+
+        if(strncmp(cmdArguments[argCount], "--", 2) != 0 || strncmp(cmdArguments[argCount], "--state=", 8) == 0)
+        {
+            stateName = strncmp(cmdArguments[argCount], "--", 2) == 0 ? value : cmdArguments[argCount];
+            options->state = 0;
+            for(state = Ready; state <= Terminated; state++)
+            {
+                if(strcasecmp(stateName, getProcessState(state)) == 0)
+                {
+                    options->state = state;
+                }
+            }
+            if(options->state == 0)
+            {
+                return 0;
+            }
+        }
+        else if(strncmp(cmdArguments[argCount], "--sort=", 7) == 0)
+        {
+            for(sortKey = 0; sortKey < (int)(sizeof(sortKeys) / sizeof(sortKeys[0])); sortKey++)
+            {
+                if(strcasecmp(value, sortKeys[sortKey]) == 0)
+                {
+                    break;
+                }
+            }
+            if(sortKey == (int)(sizeof(sortKeys) / sizeof(sortKeys[0])))
+            {
+                return 0;
+            }
+            options->sortKey = sortKey;
+        }
+        else if((strncmp(cmdArguments[argCount], "--top=", 6) == 0 || strncmp(cmdArguments[argCount], "--page=", 7) == 0
+        || strncmp(cmdArguments[argCount], "--watch=", 8) == 0) && isdigit(value[0]) && *valueEnd == '\0' && optionValue > 0
+        && optionValue <= MAXIMUM_NUMBER_OF_CHILD_PROCESSES)
+        {
+            if(cmdArguments[argCount][2] == 't')
+            {
+                options->topCount = optionValue;
+            }
+            else if(cmdArguments[argCount][2] == 'p')
+            {
+                options->pageNumber = optionValue;
+                options->paged = true;
+            }
+            else
+            {
+                options->watchIntervalInSecs = optionValue;
+            }
+        }
+        else if(strcmp(cmdArguments[argCount], "--watch") == 0)
+        {
+            options->watchIntervalInSecs = 1;
+        }
+        else if(strcmp(cmdArguments[argCount], "--json") == 0)
+        {
+            options->json = true;
+        }
+        else
+        {
+            return 0;
+        }
+    }
+
+    // The watch mode redraws rows in place, which a JSON document can not do.
+    return !(options->json && options->watchIntervalInSecs > 0);
+}
+
+/*
+* Summary - This method will compare two rows of the 'l' command for qsort_r, on their sort values.
+* The cpu time and the iterations are sorted in descending order, the other keys in ascending order.
+* Ties are broken on the process number, so that the order of the rows is stable.
+*/
+int compareListRows(const void *first, const void *second, void *sortValuesArgument)
+{
+    // Declarations
+    long long *sortValues = sortValuesArgument;
+    int firstProcess = *(const int *)first, secondProcess = *(const int *)second;
+
+    if(sortValues[firstProcess] != sortValues[secondProcess])
+    {
+        return sortValues[firstProcess] < sortValues[secondProcess] ? -1 : 1;
+    }
+
+    return (firstProcess > secondProcess) - (firstProcess < secondProcess);
+}
+
+/*
+* Summary - This method will collect the processes to be listed by the 'l' command, filtered on their state, sorted,
+* and cut down to the requested page.
+* The processes in a state are found by scanning the bitmap of the state instead of the whole table.
+* Param 1 - options - the options of the 'l' command
+* Param 2 - rowProcesses - receives the process numbers of the rows
+* Param 3 - matchingCount - receives the number of processes matching the filter, before the page is cut
+* Returns the number of rows
+*/
+int collectListRows(struct listOptions *options, int *rowProcesses, int *matchingCount)
+{
+    // Declarations
+    static long long sortValues[MAXIMUM_NUMBER_OF_CHILD_PROCESSES];
+    int rowCount = 0, processNumber, pageSize, firstRow, counter;
+    long long cpuTimeInNanos, runDelayInNanos;
+
+    for(processNumber = 0; processNumber < childProcessCountTracker; processNumber++)
+    {
+        if(options->state != 0)
+        {
+            processNumber = findNextProcessInState(options->state, processNumber);
+            if(processNumber == -1)
+            {
+                break;
+            }
+        }
+        if(childProcesses.processAdded[processNumber] == 0)
+        {
+            continue;
+        }
+        rowProcesses[rowCount++] = processNumber;
+
+        switch(options->sortKey)
+        {
+            case SortByPid: sortValues[processNumber] = childProcesses.processId[processNumber]; break;
+            case SortByState: sortValues[processNumber] = childProcesses.state[processNumber]; break;
+            case SortByCpu:
+                sortValues[processNumber] = childProcesses.state[processNumber] != Terminated
+                && readProcessSchedulingStats(childProcesses.processId[processNumber], &cpuTimeInNanos, &runDelayInNanos) ? -cpuTimeInNanos : 0;
+                break;
+            case SortByIterations:
+                sortValues[processNumber] = childProcesses.controlPage[processNumber] != NULL
+                ? -(long long)__atomic_load_n(&childProcesses.controlPage[processNumber]->iterationCount, __ATOMIC_RELAXED) : 0;
+                break;
+            default: sortValues[processNumber] = processNumber; break;
+        }
+    }
+
+    if(options->sortKey != SortByNumber)
+    {
+        qsort_r(rowProcesses, rowCount, sizeof(int), compareListRows, sortValues);
+    }
+
+    *matchingCount = rowCount;
+    pageSize = options->topCount > 0 ? options->topCount : (options->paged ? LIST_PAGE_SIZE : rowCount);
+    firstRow = (options->pageNumber - 1) * pageSize;
+    if(firstRow >= rowCount)
+    {
+        return 0;
+    }
+    if(firstRow > 0)
+    {
+        for(counter = 0; counter < pageSize && firstRow + counter < rowCount; counter++)
+        {
+            rowProcesses[counter] = rowProcesses[firstRow + counter];
+        }
+    }
+
+    return rowCount - firstRow < pageSize ? rowCount - firstRow : pageSize;
+}
+
+/*
+* Summary - This method will redraw the rows of the 'l' command every interval, till a line is entered ('l --watch').
+* Only the rows that changed since the previous interval are drawn again. On a terminal, the cursor is moved to the row and
+* the row is overwritten, and the rows are limited to the height of the terminal; otherwise the changed rows are appended.
+* The output of the child processes keeps being drained, and the scheduler messages wait in the log queue till the watch ends.
+* Param 1 - options - the options of the 'l' command
+*/
+void watchChildProcessInformation(struct listOptions *options)
+{
+    // Declarations
+    static char displayedRows[MAXIMUM_NUMBER_OF_CHILD_PROCESSES][LIST_ROW_LENGTH];
+    static int rowProcesses[MAXIMUM_NUMBER_OF_CHILD_PROCESSES];
+    struct listOutput output = { .streaming = true, .capacity = LIST_OUTPUT_BUFFER_SIZE };
+    struct pollfd inputStatus = { .fd = STDIN_FILENO, .events = POLLIN };
+    struct winsize windowSize;
+    bool terminal = isatty(STDOUT_FILENO), windowSizeKnown;
+    int rowCount, matchingCount, displayedRowCount = 0, counter, linesUp;
+    char row[LIST_ROW_LENGTH], inputCharacter;
+
+    output.data = malloc(output.capacity);
+    if(output.data == NULL)
+    {
+        return;
+    }
+
+    printf("Watching the child processes every %d secs, press Enter to stop.\n", options->watchIntervalInSecs);
+
+    while(1)
+    {
+        drainAllChildProcessOutput();
+        rowCount = collectListRows(options, rowProcesses, &matchingCount);
+        windowSizeKnown = terminal && ioctl(STDOUT_FILENO, TIOCGWINSZ, &windowSize) == 0 && windowSize.ws_row > 2 && windowSize.ws_col > 1;
+        if(windowSizeKnown && rowCount > windowSize.ws_row - 2)
+        {
+            rowCount = windowSize.ws_row - 2;
+        }
+
+        appendListOutput(&output, "%s", colorEnabled ? "\033[0;36m" : "");
+        for(counter = 0; counter < rowCount || counter < displayedRowCount; counter++)
+        {
+            row[0] = '\0';
+            if(counter < rowCount)
+            {
+                formatChildProcessInformation(rowProcesses[counter], row, sizeof(row));
+            }
+            // A row that wraps would take two lines, and the cursor would not get back to it.
+            if(windowSizeKnown && windowSize.ws_col < LIST_ROW_LENGTH)
+            {
+                row[windowSize.ws_col - 1] = '\0';
+            }
+
+            if(counter < displayedRowCount && strcmp(row, displayedRows[counter]) == 0)
+            {
+                continue;
+            }
+
+            if(counter >= displayedRowCount)
+            {
+                appendListOutput(&output, "%s\n", row);
+                displayedRowCount++;
+            }
+            else if(terminal)
+            {
+                linesUp = displayedRowCount - counter;
+                appendListOutput(&output, "\033[%dA\r\033[2K%s\033[%dB\r", linesUp, row, linesUp);
+            }
+            else if(row[0] != '\0')
+            {
+                appendListOutput(&output, "%s\n", row);
+            }
+            strcpy(displayedRows[counter], row);
+        }
+        appendListOutput(&output, "%s", colorEnabled ? "\033[0m" : "");
+        writeListOutput(&output);
+
+        if(poll(&inputStatus, 1, options->watchIntervalInSecs * 1000) == 1)
+        {
+            // Consume the line that stopped the watch, but not the commands entered after it.
+            while(read(STDIN_FILENO, &inputCharacter, 1) == 1 && inputCharacter != '\n');
+            break;
+        }
+    }
+
+    free(output.data);
+}
+
+/*
+* Summary - This method will display the child processes information.
+* The rows are formatted into a buffer that is written out in large writes, instead of a printf call per field.
+* 'l state' only displays the processes in that state, and the rows can be sorted, paged, watched or listed as JSON
+* (see parseListOptions).
+* Param 1 - cmdArguments - command line arguments
+* Returns 1, after a flawless execution
+* Answer to Question 4 (l: to list the current user processes in the system including it PID, process number, and state)
+*/
+int displayChildProcessInformation(char **cmdArguments)
+{
+    // Declarations
+    static int rowProcesses[MAXIMUM_NUMBER_OF_CHILD_PROCESSES];
+    struct listOptions options;
+    struct listOutput output;
+    int rowCount, matchingCount, counter, pageSize;
+    char row[LIST_ROW_LENGTH];
+
+    if(!parseListOptions(cmdArguments, &options))
+    {
+        puts("The command you entered appears to be incorrect.\n"
+        "Please use 'l [state] [--state=state] [--sort=number|pid|state|cpu|iterations] [--top=#] [--page=#] [--watch[=secs]] [--json]'.\n"
+        "If needed, use the 'help' command to see the command list.\n");
+        return 1;
+    }
+
+    if(options.watchIntervalInSecs > 0)
+    {
+        watchChildProcessInformation(&options);
+        return 1;
+    }
+
+    rowCount = collectListRows(&options, rowProcesses, &matchingCount);
+
+    output.streaming = !options.json;
+    output.capacity = LIST_OUTPUT_BUFFER_SIZE;
+    output.length = 0;
+    output.data = malloc(output.capacity);
+    if(output.data == NULL)
+    {
+        return 1;
+    }
+
+    if(options.json)
+    {
+        appendListOutput(&output, "{\"matching\":%d,\"page\":%d,\"processes\":[", matchingCount, options.pageNumber);
+        for(counter = 0; counter < rowCount; counter++)
+        {
+            appendListOutput(&output, counter == 0 ? "" : ",");
+            formatChildProcessJson(rowProcesses[counter], &output);
+        }
+        appendListOutput(&output, "]}\n");
+    }
+    else if(matchingCount == 0)
+    {
+        if(childProcessCountTracker == 0)
+        {
+            appendListOutput(&output, "There aren't any child processes that have been created to show their information.\n");
+        }
+        else
+        {
+            appendListOutput(&output, "There aren't any child processes in the %s state.\n", getProcessState(options.state));
+        }
+    }
+    else
+    {
+        appendListOutput(&output, "%s", colorEnabled ? "\033[0;36m" : "");
+        for(counter = 0; counter < rowCount; counter++)
+        {
+            formatChildProcessInformation(rowProcesses[counter], row, sizeof(row));
+            appendListOutput(&output, "%s\n", row);
+        }
+        appendListOutput(&output, "%s", colorEnabled ? "\033[0m" : "");
+
+        pageSize = options.topCount > 0 ? options.topCount : LIST_PAGE_SIZE;
+        if(rowCount == 0)
+        {
+            appendListOutput(&output, "There are only %d child processes to list, the page %d is empty.\n", matchingCount, options.pageNumber);
+        }
+        else if((options.pageNumber - 1) * pageSize + rowCount < matchingCount)
+        {
+            appendListOutput(&output, "Listed %d of %d child processes, use --page=%d for the next %d.\n", rowCount, matchingCount,
+            options.pageNumber + 1, pageSize);
+        }
+    }
+
+    // The JSON document is never flushed early, so it is written with this single write call.
+    writeListOutput(&output);
+    free(output.data);
+
+    return 1;
+}
+
+/*
+* Summary - This method will create child processes.
+* If a name is given ('c # name'), the child processes are created as members of the gang with that name.
+* Resource limits can be given as well, for example 'c 4 as=64 nofile=16 cpu=30' or 'c 2 name cpu=5'.
+* Param 1 - cmdArguments - command line arguments
+* Returns 1, after a flawless execution
+* Answer to question 2 (c #)
+*/
+int createChildProcesses(char **cmdArguments)
+{
+    if(cmdArguments[1] != NULL)
+    {
+        // Declarations
+        int argDataLength = strlen(cmdArguments[1]);
+        int argCount, forkStatus, gangNumber = 0;
+        char *gangName = NULL;
+        struct resourceLimits limits = {0, 0, 0};
+        struct jobWorkload workload = {0, 0, 0};
+
+        for(argCount = 0; argCount < argDataLength; argCount ++)
+        {
+            if(isdigit(cmdArguments[1][argCount]) == 0)
+            {
+                goto PrintError;
+            }
+        }
+
+        // Every argument having a '=' is a resource limit, and the only other argument is the gang name.
+        for(argCount = 2; cmdArguments[argCount] != NULL; argCount++)
+        {
+            if(strchr(cmdArguments[argCount], '=') != NULL)
+            {
+                if(!parseResourceLimit(cmdArguments[argCount], &limits))
+                {
+                    printf("The entered resource limit '%s' appears to be incorrect.\n"
+                    "Please use as=MB, nofile=# or cpu=secs, with a value of atleast 1.\n", cmdArguments[argCount]);
+                    return 1;
+                }
+            }
+            else if(gangName == NULL)
+            {
+                gangName = cmdArguments[argCount];
+            }
+            else
+            {
+                goto PrintError;
+            }
+        }
+
+        int childProcessCount = atoi(cmdArguments[1]);
+
+        if(childProcessCount > 0 && childProcessCount <= MAXIMUM_NUMBER_OF_CHILD_PROCESSES)
+        {
+            if(gangName != NULL)
+            {
+                gangNumber = findOrAddGang(gangName);
+                if(gangNumber == 0)
+                {
+                    printf("The entered gang name appears to be incorrect, or no more gangs can be created.\n"
+                    "Please use upto %d letters or digits for the name. Only %d gangs can be created with this shell.\n",
+                    MAXIMUM_GANG_NAME_LENGTH - 1, MAXIMUM_NUMBER_OF_GANGS);
+                    return 1;
+                }
+            }
+
+            forkStatus = forkParentProcess(childProcessCount, gangNumber, &limits, &workload);
+            return forkStatus;
+        }
+    }
+
+    // The user has entered an invalid value for the no. of child processes to be generated. Display the error and proceed the execution.
+    PrintError: printf("The entered value for the no. of child processes to be generated appears to be incorrect.\nPlease set the value to atleast 1 and no longer than %d.\nIf needed, use the 'help' command to see the command list.\n", MAXIMUM_NUMBER_OF_CHILD_PROCESSES);
+
+    return 1;
+}
+
+/*
+* Summary - This method will parse a resource limit of the 'c #' command, given as as=MB, nofile=# or cpu=secs.
+* Param 1 - argument - the resource limit argument
+* Param 2 - limits - receives the resource limit
+* Returns 1 if the resource limit is valid, else 0.
+*/
+int parseResourceLimit(char *argument, struct resourceLimits *limits)
+{
+    // Declarations
+    char *value = strchr(argument, '=') + 1;
+    char *valueEnd;
+    long limitValue;
+
+    if(!isdigit(value[0]))
+    {
+        return 0;
+    }
+
+    limitValue = strtol(value, &valueEnd, 10);
+    if(*valueEnd != '\0' || limitValue <= 0 || limitValue > INT_MAX)
+    {
+        return 0;
+    }
+
+    if(strncmp(argument, "as=", 3) == 0)
+    {
+        limits->addressSpaceInMB = limitValue;
+    }
+    else if(strncmp(argument, "nofile=", 7) == 0)
+    {
+        limits->openFileCount = limitValue;
+    }
+    else if(strncmp(argument, "cpu=", 4) == 0)
+    {
+        limits->cpuTimeInSecs = limitValue;
+    }
+    else
+    {
+        return 0;
+    }
+
+    return 1;
+}
+
+/*
+* Summary - This method will apply the resource limits in a newly forked child process, before it is loaded.
+* The hard cpu time limit is kept 1 sec above the soft limit, so that the process gets SIGXCPU before it gets SIGKILL.
+* Param 1 - limits - the resource limits
+* Returns 1, if all the resource limits are applied, else 0.
+*/
+int applyResourceLimits(struct resourceLimits *limits)
+{
+    // Declarations
+    struct rlimit limit;
+
+    if(limits->addressSpaceInMB > 0)
+    {
+        limit.rlim_cur = limit.rlim_max = (rlim_t)limits->addressSpaceInMB * 1024 * 1024;
+        if(setrlimit(RLIMIT_AS, &limit) == -1)
+        {
+            return 0;
+        }
+    }
+
+    if(limits->openFileCount > 0)
+    {
+        limit.rlim_cur = limit.rlim_max = limits->openFileCount;
+        if(setrlimit(RLIMIT_NOFILE, &limit) == -1)
+        {
+            return 0;
+        }
+    }
+
+    if(limits->cpuTimeInSecs > 0)
+    {
+        limit.rlim_cur = limits->cpuTimeInSecs;
+        limit.rlim_max = limits->cpuTimeInSecs + 1;
+        if(setrlimit(RLIMIT_CPU, &limit) == -1)
+        {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+/*
+* Summary - This method will find the gang with the given name, and will add it to the gangs struct if it does not exist.
+* Param 1 - gangName - the name of the gang
+* Returns the gang number (1 based), or 0 if the name is invalid or the gangs struct is full.
+*/
+int findOrAddGang(char *gangName)
+{
+    // Declarations
+    int counter, nameLength = strlen(gangName);
+
+    if(nameLength >= MAXIMUM_GANG_NAME_LENGTH)
+    {
+        return 0;
+    }
+
+    for(counter = 0; counter < nameLength; counter++)
+    {
+        if(isalnum(gangName[counter]) == 0)
+        {
+            return 0;
+        }
+    }
+
+    if(findGang(gangName) != 0)
+    {
+        return findGang(gangName);
+    }
+
+    for(counter = 0; counter < MAXIMUM_NUMBER_OF_GANGS; counter++)
+    {
+        if(gangs[counter].gangAdded == 0)
+        {
+            strcpy(gangs[counter].gangName, gangName);
+            gangs[counter].gangAdded = 1;
+            journalGang(counter + 1);
+            return counter + 1;
+        }
+    }
+
+    return 0;
+}
+
+/*
+* Summary - This method will find the gang with the given name.
+* Param 1 - gangName - the name of the gang
+* Returns the gang number (1 based), or 0 if the gang does not exist.
+*/
+int findGang(char *gangName)
+{
+    // Declarations
+    int counter;
+
+    for(counter = 0; counter < MAXIMUM_NUMBER_OF_GANGS; counter++)
+    {
+        if(gangs[counter].gangAdded == 1 && strcmp(gangs[counter].gangName, gangName) == 0)
+        {
+            return counter + 1;
+        }
+    }
+
+    return 0;
+}
+
+/*
+* Summary - This method will get the process group that a new child process has to join.
+* A gang has its own process group, and all the other child processes share the default process group.
+* Param 1 - gangNumber - the gang of the new child process, 0 if it is not a part of any gang
+* Returns the process group id, or 0 if the new child process has to start a new process group,
+* as the group does not exist yet or all of its members are terminated.
+* A group having only processes re-adopted from a previous shell is not joined, as it might belong to another session.
+*/
+int getProcessGroupForNewChild(int gangNumber)
+{
+    // Declarations
+    int counter, processGroupId;
+
+    processGroupId = gangNumber != 0 ? gangs[gangNumber - 1].processGroupId : defaultProcessGroupId;
+
+    for(counter = 0; processGroupId != 0 && counter < childProcessCountTracker; counter++)
+    {
+        if(childProcesses.processGroupId[counter] == processGroupId && childProcesses.state[counter] != Terminated
+        && childProcesses.processFileDescriptor[counter] == -1)
+        {
+            return processGroupId;
+        }
+    }
+
+    return 0;
+}
+
+/*
+* Summary - This method will fork the parent process for creating the entered number of child processes.
+* Param 1 - childProcessCount - Number of child processes to be created.
+* Param 2 - gangNumber - the gang that the child processes will belong to, 0 if they are not a part of any gang.
+* Param 3 - limits - the resource limits of the child processes.
+* Param 4 - workload - the work done by the child processes, passed to them as their arguments.
+* 1. Run a for loop for childProcessCount times, and create a child process in every iteration.
+* 2. Load './process' program using execvp in the newly created child process.
+* 3. Add the new child process in the childProcesses struct by calling addChildProcess method.
+* Returns 1, after a flawless execution
+*/
+int forkParentProcess(int childProcessCount, int gangNumber, struct resourceLimits *limits, struct jobWorkload *workload)
+{
+    // Declarations
+    int processCount, childProcessId, procNo, processGroupId, controlPageDescriptor, memoryFileDescriptor, cacheDomain;
+    int outputPipe[2];
+    struct controlPage *control;
+    enum processStates state;
+    char *processName = "./proce";
+    char cpuArgument[32], memoryArgument[32];
+    char *arguments[] = {processName, NULL, NULL, NULL};
+
+    // A synthetic child process is told how much cpu time to burn and how much memory to touch.
+    if(workload->cpuTimeInMillis > 0)
+    {
+        snprintf(cpuArgument, sizeof(cpuArgument), "--cpu=%lld", workload->cpuTimeInMillis);
+        snprintf(memoryArgument, sizeof(memoryArgument), "--memory=%ld", workload->memoryInMB);
+        arguments[1] = cpuArgument;
+        arguments[2] = memoryArgument;
+    }
+
+    for(processCount = 0; processCount < childProcessCount; processCount ++)
+    {
+        if(!memoryAdmissionAllowed())
+        {
+            queueChildProcessCreation(childProcessCount - processCount, gangNumber, limits, workload);
+            break;
+        }
+
+        int processCreationAllowed = creationOfChildProcessAllowed();
+        if(!processCreationAllowed)
+        {
+            printf("Maximum number of child processes created. Only %d processes can be created with this shell.\n",
+            childProcessLimit);
+            break;
+        }
+
+        // The output of the child process is captured through a pipe.
+        if(pipe2(outputPipe, O_CLOEXEC) == -1)
+        {
+            childProcessCountTracker--;
+            printf("The creation of child process failed, as its output pipe could not be created.\n");
+            return 1;
+        }
+
+        // All the child processes share the handshake pipe. Its writes do not block, so a child process never waits for the shell.
+        if(handshakePipe[0] == -1 && pipe2(handshakePipe, O_CLOEXEC | O_NONBLOCK) == -1)
+        {
+            handshakePipe[0] = handshakePipe[1] = -1;
+        }
+
+        // The control page is a memfd of its own for every child process. It is kept above the descriptors it is moved
+        // to in the child process, so that moving the handshake pipe can not overwrite it. Without it, the process still runs.
+        controlPageDescriptor = -1;
+        control = NULL;
+        memoryFileDescriptor = memfd_create("proce-control", MFD_CLOEXEC);
+        if(memoryFileDescriptor != -1)
+        {
+            controlPageDescriptor = fcntl(memoryFileDescriptor, F_DUPFD_CLOEXEC, CONTROL_PAGE_DESCRIPTOR + 1);
+            close(memoryFileDescriptor);
+        }
+        if(controlPageDescriptor != -1 && (ftruncate(controlPageDescriptor, sizeof(struct controlPage)) == -1
+        || (control = mapControlPage(controlPageDescriptor)) == NULL))
+        {
+            close(controlPageDescriptor);
+            controlPageDescriptor = -1;
+        }
+
+        // Flush the pending output, so that it does not get duplicated in the child process.
+        fflush(stdout);
+
+        processGroupId = getProcessGroupForNewChild(gangNumber);
+        cacheDomain = pickCacheDomain(gangNumber);
+
+        childProcessId = fork();
+
+        // Child process code
+        if(childProcessId == 0)
+        {
+            setpgid(0, processGroupId);
+            dup2(outputPipe[1], STDOUT_FILENO);
+            if(handshakePipe[1] == HANDSHAKE_DESCRIPTOR)
+            {
+                fcntl(HANDSHAKE_DESCRIPTOR, F_SETFD, 0);
+            }
+            else if(handshakePipe[1] != -1)
+            {
+                dup2(handshakePipe[1], HANDSHAKE_DESCRIPTOR);
+            }
+            if(controlPageDescriptor != -1)
+            {
+                dup2(controlPageDescriptor, CONTROL_PAGE_DESCRIPTOR);
+            }
+            placeChildProcess(cacheDomain);
+            // The child process gets the descriptor limit the shell was started with, not the one raised for the shell.
+            setrlimit(RLIMIT_NOFILE, &inheritedFileDescriptorLimit);
+            // A child process that cannot be limited exits right away, and gets reaped like any other exited process.
+            if(!applyResourceLimits(limits))
+            {
+                fprintf(stderr, "The resource limits of child %d could not be applied: %s\n", getpid(), strerror(errno));
+                _exit(1);
+            }
+            execvp(processName, arguments);
+            fprintf(stderr, "Child %d could not be loaded: %s\n", getpid(), strerror(errno));
+            _exit(1);
+        }
+        // Parent process code
+        else if(childProcessId > 0)
+        {
+            // The process group is set by the parent as well, so that it is in place before the parent signals the child.
+            setpgid(childProcessId, processGroupId);
+            if(processGroupId == 0)
+            {
+                processGroupId = childProcessId;
+                if(gangNumber != 0)
+                {
+                    gangs[gangNumber - 1].processGroupId = processGroupId;
+                    journalGang(gangNumber);
+                }
+                else
+                {
+                    defaultProcessGroupId = processGroupId;
+                    journalSettings();
+                }
+            }
+
+            close(outputPipe[1]);
+            state = Suspended;
+            addChildProcess(childProcessId, state, gangNumber, processGroupId);
+            // The mapping stays valid after the descriptor is closed.
+            childProcesses.controlPage[childProcessCountTracker - 1] = control;
+            childProcesses.cacheDomain[childProcessCountTracker - 1] = cacheDomain;
+            childProcesses.arrivalTimeInMicros[childProcessCountTracker - 1] = workload->arrivalTimeInMicros;
+            childProcesses.cpuDemandInMillis[childProcessCountTracker - 1] = workload->cpuTimeInMillis;
+            if(controlPageDescriptor != -1)
+            {
+                close(controlPageDescriptor);
+            }
+            setupOutputCapture(childProcessCountTracker - 1, outputPipe[0]);
+            // The jobs of a replayed trace arrive while the prompt is displayed, so they are announced through the scheduler log.
+            if(workload->arrivalTimeInMicros != 0)
+            {
+                logSchedulerEvent(LogDebug, "\033[0m", "Child %d of Parent %d has been created.\n", childProcessId, getpid());
+            }
+            else
+            {
+                printf("Child %d of Parent %d has been created.\n", childProcessId, getpid());
+            }
+        }
+        // Fork failure
+        else
+        {
+            close(outputPipe[0]);
+            close(outputPipe[1]);
+            if(controlPageDescriptor != -1)
+            {
+                close(controlPageDescriptor);
+                munmap(control, sizeof(struct controlPage));
+            }
+            // The creation of child process has failed. So return 0 to stop the execution of the program.
+            printf("The creation of child process failed.\n");
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+/*
+* Summary - This method will read the memory usage of a child process.
+* The proportional set size from /proc/<pid>/smaps_rollup is used, so that the pages shared by the child processes are not
+* counted more than once. If it is not available, the resident set size from /proc/<pid>/statm is used.
+* Param 1 - processId - the child process id
+* Returns the memory usage in KB, 0 if the process does not exist.
+*/
+long readProcessMemoryUsage(int processId)
+{
+    // Declarations
+    char filePath[64], line[128];
+    FILE *memoryFile;
+    long memoryUsageInKB = 0, residentPages = 0;
+
+    snprintf(filePath, sizeof(filePath), "/proc/%d/smaps_rollup", processId);
+    memoryFile = fopen(filePath, "r");
+    if(memoryFile != NULL)
+    {
+        while(fgets(line, sizeof(line), memoryFile) != NULL)
+        {
+            if(sscanf(line, "Pss: %ld kB", &memoryUsageInKB) == 1)
+            {
+                fclose(memoryFile);
+                return memoryUsageInKB;
+            }
+        }
+        fclose(memoryFile);
+    }
+
+    snprintf(filePath, sizeof(filePath), "/proc/%d/statm", processId);
+    memoryFile = fopen(filePath, "r");
+    if(memoryFile != NULL)
+    {
+        if(fscanf(memoryFile, "%*s %ld", &residentPages) == 1)
+        {
+            memoryUsageInKB = residentPages * (sysconf(_SC_PAGESIZE) / 1024);
+        }
+        fclose(memoryFile);
+    }
+
+    return memoryUsageInKB;
+}
+
+/*
+* Summary - This method will sample the memory usage of all the non-terminated child processes.
+* Param 1 - liveProcessCount - receives the number of non-terminated child processes, can be NULL
+* Returns the total memory usage in KB
+*/
+long sampleMemoryUsage(int *liveProcessCount)
+{
+    // Declarations
+    int counter, processCount = 0;
+    long totalMemoryUsageInKB = 0;
+
+    for(counter = 0; counter < childProcessCountTracker; counter++)
+    {
+        if(childProcesses.state[counter] != Terminated)
+        {
+            childProcesses.memoryUsageInKB[counter] = readProcessMemoryUsage(childProcesses.processId[counter]);
+            totalMemoryUsageInKB += childProcesses.memoryUsageInKB[counter];
+            processCount++;
+        }
+    }
+
+    if(liveProcessCount != NULL)
+    {
+        *liveProcessCount = processCount;
+    }
+
+    return totalMemoryUsageInKB;
+}
+
+/*
+* Summary - This method will check, if a new child process fits in the memory budget.
+* The memory of the new child process is projected to be the average memory usage of the existing child processes.
+* Returns 1, if there is no budget or the projected memory usage fits in the budget, else 0.
+*/
+int memoryAdmissionAllowed()
+{
+    // Declarations
+    int liveProcessCount;
+    long totalMemoryUsageInKB, projectedMemoryInKB = DEFAULT_MEMORY_ESTIMATE_IN_KB;
+
+    if(memoryBudgetInKB == 0)
+    {
+        return 1;
+    }
+
+    totalMemoryUsageInKB = sampleMemoryUsage(&liveProcessCount);
+    if(liveProcessCount > 0)
+    {
+        projectedMemoryInKB = totalMemoryUsageInKB / liveProcessCount;
+    }
+
+    return (totalMemoryUsageInKB + projectedMemoryInKB) <= memoryBudgetInKB;
+}
+
+/*
+* Summary - This method will queue the creation of child processes that did not fit in the memory budget.
+* Param 1 - childProcessCount - Number of child processes that are yet to be created
+* Param 2 - gangNumber - the gang of the child processes, 0 if they are not a part of any gang
+* Param 3 - limits - the resource limits of the child processes
+* Param 4 - workload - the work done by the child processes
+*/
+void queueChildProcessCreation(int childProcessCount, int gangNumber, struct resourceLimits *limits, struct jobWorkload *workload)
+{
+    if(queuedCreationCount == MAXIMUM_NUMBER_OF_QUEUED_CREATIONS)
+    {
+        printf("The memory budget of %ld MB is exhausted, and the creation queue is full. %d child processes were not created.\n",
+        memoryBudgetInKB / 1024, childProcessCount);
+        return;
+    }
+
+    queuedCreations[queuedCreationCount].childProcessCount = childProcessCount;
+    queuedCreations[queuedCreationCount].gangNumber = gangNumber;
+    queuedCreations[queuedCreationCount].limits = *limits;
+    queuedCreations[queuedCreationCount].workload = *workload;
+    queuedCreationCount++;
+
+    printf("The memory budget of %ld MB is exhausted. The creation of %d child processes is queued until memory gets freed.\n",
+    memoryBudgetInKB / 1024, childProcessCount);
+}
+
+/*
+* Summary - This method will create the queued child processes, in the order they were queued, as long as they fit in the memory budget.
+*/
+void admitQueuedChildProcesses()
+{
+    // Declarations
+    int counter;
+    struct queuedCreationRequest request;
+
+    while(queuedCreationCount > 0 && memoryAdmissionAllowed())
+    {
+        request = queuedCreations[0];
+        queuedCreationCount--;
+        for(counter = 0; counter < queuedCreationCount; counter++)
+        {
+            queuedCreations[counter] = queuedCreations[counter + 1];
+        }
+
+        // The child processes that still do not fit are queued again at the end of the queue.
+        forkParentProcess(request.childProcessCount, request.gangNumber, &request.limits, &request.workload);
+    }
+}
+
+/*
+* Summary - This method will keep the child processes within the memory budget.
+* It is called by the main loop every MEMORY_SAMPLING_INTERVAL_IN_MILLISECS, as the memory usage is read from /proc, which is
+* too slow for the alarm handler. The alarm handler only skips the processes marked in memoryThrottledBitmap.
+* Only the memory of the processes the scheduler may run is held against the budget, as the throttled ones can not grow.
+* While it exceeds the budget, the scheduling unit of the process having the largest memory usage is suspended, all of
+* its members together, and skipped by the scheduler. If it was running, the next process is started, as the alarm handler would.
+* A throttled unit is made schedulable again once it fits MEMORY_RELEASE_HEADROOM_IN_PERCENT below the budget, so that it
+* is not suspended again at the next check.
+*/
+void relieveMemoryPressure()
+{
+    // Declarations
+    int counter, innerCounter, memberCount, stoppedMemberCount, largestProcessNo, stoppedProcessNo = -1, nextProcessNo;
+    int unitMembers[MAXIMUM_NUMBER_OF_CHILD_PROCESSES], stoppedMembers[MAXIMUM_NUMBER_OF_CHILD_PROCESSES];
+    bool unitThrottled = false;
+    long usageInKB = 0, unitUsageInKB;
+    sigset_t previousSignals;
+
+    if(memoryBudgetInKB == 0 || getMonotonicTimeInMicros() - lastMemorySampleTimeInMicros < MEMORY_SAMPLING_INTERVAL_IN_MILLISECS * 1000LL)
+    {
+        return;
+    }
+
+    sampleMemoryUsage(NULL);
+    lastMemorySampleTimeInMicros = getMonotonicTimeInMicros();
+
+    // The process states are shared with the alarm and control-c handlers.
+    blockSchedulerSignals(&previousSignals);
+
+    for(counter = 0; counter < childProcessCountTracker; counter++)
+    {
+        if(childProcesses.state[counter] != Terminated && !isMemoryThrottled(counter))
+        {
+            usageInKB += childProcesses.memoryUsageInKB[counter];
+        }
+    }
+
+    while(usageInKB > memoryBudgetInKB)
+    {
+        largestProcessNo = -1;
+        for(counter = 0; counter < childProcessCountTracker; counter++)
+        {
+            if(childProcesses.state[counter] != Terminated && !isMemoryThrottled(counter)
+            && (largestProcessNo == -1 || childProcesses.memoryUsageInKB[counter] > childProcesses.memoryUsageInKB[largestProcessNo]))
+            {
+                largestProcessNo = counter;
+            }
+        }
+
+        if(largestProcessNo == -1)
+        {
+            break;
+        }
+
+        // The members of a gang are preempted together, so they are throttled together.
+        memberCount = getSchedulingUnit(largestProcessNo, unitMembers);
+        stoppedMemberCount = 0;
+        unitUsageInKB = 0;
+        for(counter = 0; counter < memberCount; counter++)
+        {
+            unitUsageInKB += childProcesses.memoryUsageInKB[unitMembers[counter]];
+            if(childProcesses.state[unitMembers[counter]] == Running)
+            {
+                endTimeSlice(unitMembers[counter]);
+                stoppedMembers[stoppedMemberCount] = unitMembers[counter];
+                stoppedMemberCount++;
+                stoppedProcessNo = unitMembers[counter];
+            }
+            setProcessState(unitMembers[counter], Suspended);
+            setMemoryThrottled(unitMembers[counter], 1);
+        }
+        sendSignalToProcesses(stoppedMembers, stoppedMemberCount, SIGSTOP);
+        unitThrottled = true;
+
+        if(memberCount > 1)
+        {
+            logSchedulerEvent(LogWarning, "\033[0;31m", "\nThe memory budget is exceeded (%ld KB of %ld KB). The gang of child %d using %ld KB is suspended.\n",
+            usageInKB, memoryBudgetInKB, childProcesses.processId[largestProcessNo], unitUsageInKB);
+        }
+        else
+        {
+            logSchedulerEvent(LogWarning, "\033[0;31m", "\nThe memory budget is exceeded (%ld KB of %ld KB). Child %d using %ld KB is suspended.\n",
+            usageInKB, memoryBudgetInKB, childProcesses.processId[largestProcessNo], unitUsageInKB);
+        }
+
+        usageInKB -= unitUsageInKB;
+    }
+
+    // Once no unit had to be throttled, make the throttled units schedulable again, as long as they fit below the budget.
+    for(counter = 0; !unitThrottled && counter < childProcessCountTracker; counter++)
+    {
+        if(childProcesses.state[counter] == Terminated || !isMemoryThrottled(counter))
+        {
+            continue;
+        }
+
+        memberCount = getThrottledUnit(counter, unitMembers);
+        unitUsageInKB = 0;
+        for(innerCounter = 0; innerCounter < memberCount; innerCounter++)
+        {
+            unitUsageInKB += childProcesses.memoryUsageInKB[unitMembers[innerCounter]];
+        }
+
+        if((usageInKB + unitUsageInKB) * 100 <= memoryBudgetInKB * (100 - MEMORY_RELEASE_HEADROOM_IN_PERCENT))
+        {
+            for(innerCounter = 0; innerCounter < memberCount; innerCounter++)
+            {
+                setMemoryThrottled(unitMembers[innerCounter], 0);
+            }
+            usageInKB += unitUsageInKB;
+        }
+    }
+
+    if(stoppedProcessNo != -1 && runningOneProcess == 0 && countRunningProcesses() == 0)
+    {
+        nextProcessNo = findNextSchedulableProcess(stoppedProcessNo + 1, childProcessCountTracker);
+        if(nextProcessNo == -1)
+        {
+            nextProcessNo = findNextSchedulableProcess(0, stoppedProcessNo);
+        }
+        if(nextProcessNo != -1)
+        {
+            runChildProcessUsingSchedulingAlgo(nextProcessNo);
+        }
+    }
+
+    unblockSchedulerSignals(&previousSignals);
+}
+
+/*
+* Summary - This method will check if the scheduler can pick the process to run next.
+* Param 1 - processNumber - the process identifier
+* Returns true, if the process is suspended and is not held back due to memory pressure.
+*/
+bool isProcessSchedulable(int processNumber)
+{
+    return childProcesses.state[processNumber] == Suspended && !isMemoryThrottled(processNumber);
+}
+
+/*
+* Summary - This method will be used to set the memory budget of the child processes.
+* Param 1 - cmdArguments - command line arguments
+* Returns 1, after a flawless execution
+*/
+int setMemoryBudget(char **cmdArguments)
+{
+    if(cmdArguments[1] != NULL && cmdArguments[2] == NULL)
+    {
+        // Declarations
+        int argDataLength = strlen(cmdArguments[1]);
+        int argCount;
+        sigset_t previousSignals;
+
+        for(argCount = 0; argCount < argDataLength; argCount ++)
+        {
+            if(isdigit(cmdArguments[1][argCount]) == 0)
+            {
+                goto PrintError;
+            }
+        }
+
+        memoryBudgetInKB = atol(cmdArguments[1]) * 1024;
+        journalSettings();
+
+        if(memoryBudgetInKB == 0)
+        {
+            // Without a budget, the processes suspended due to memory pressure are schedulable again.
+            blockSchedulerSignals(&previousSignals);
+            for(argCount = 0; argCount < childProcessCountTracker; argCount++)
+            {
+                setMemoryThrottled(argCount, 0);
+            }
+            unblockSchedulerSignals(&previousSignals);
+
+            printf("The memory budget is removed.\n");
+        }
+        else
+        {
+            printf("The memory budget of the child processes is set to %ld MB.\n", memoryBudgetInKB / 1024);
+        }
+
+        return 1;
+    }
+
+    PrintError:puts("The entered memory budget appears to be incorrect.\n"
+    "Please enter the budget in MB, or 0 to remove the budget.\n"
+    "If needed, use the 'help' command to see the command list.\n");
+
+    return 1;
+}
+
+/*
+* Summary - This method will set up the capture of a child process's output.
+* The output is moved from the pipe into JOB_LOG_DIRECTORY/process-#.log, and the recent output is kept in the outputRing pipe.
+* Param 1 - processNumber - the process identifier
+* Param 2 - outputPipe - read end of the pipe connected to the standard output of the process
+* Returns 1, if the output is captured, else 0.
+*/
+int setupOutputCapture(int processNumber, int outputPipe)
+{
+    // Declarations
+    char logFilePath[64];
+
+    childProcesses.outputPipe[processNumber] = outputPipe;
+    childProcesses.outputRing[processNumber][0] = -1;
+    childProcesses.outputRing[processNumber][1] = -1;
+    childProcesses.outputLogFile[processNumber] = -1;
+
+    fcntl(outputPipe, F_SETFL, O_NONBLOCK);
+
+    if(nullDevice == -1)
+    {
+        nullDevice = open("/dev/null", O_WRONLY | O_CLOEXEC);
+    }
+
+    mkdir(JOB_LOG_DIRECTORY, 0755);
+    snprintf(logFilePath, sizeof(logFilePath), "%s/process-%d.log", JOB_LOG_DIRECTORY, processNumber);
+
+    // splice() does not support files opened with O_APPEND, so the file offset is used for appending the output.
+    childProcesses.outputLogFile[processNumber] = open(logFilePath, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+
+    if(pipe2(childProcesses.outputRing[processNumber], O_CLOEXEC | O_NONBLOCK) == 0)
+    {
+        fcntl(childProcesses.outputRing[processNumber][1], F_SETPIPE_SZ, JOB_OUTPUT_RING_SIZE);
+    }
+
+    if(childProcesses.outputLogFile[processNumber] == -1 || childProcesses.outputRing[processNumber][0] == -1)
+    {
+        printf("The output of child %d could not be captured in %s.\n", childProcesses.processId[processNumber], logFilePath);
+        return 0;
+    }
+
+    return 1;
+}
+
+/*
+* Summary - This method will move the pending output of a child process from its pipe into its log file.
+* The output is first duplicated into the outputRing pipe using tee(), and then moved into the log file using splice().
+* The outputRing pipe acts as a ring buffer, the oldest output is discarded into /dev/null to make room for the new output.
+* When the process closes its output, the pipe and the log file are closed.
+* Param 1 - processNumber - the process identifier
+*/
+void drainChildProcessOutput(int processNumber)
+{
+    // Declarations
+    int pendingBytes, ringBytes, ringCapacity, bytesToMove;
+    ssize_t bytesMoved;
+
+    if(childProcesses.outputPipe[processNumber] == -1)
+    {
+        return;
+    }
+
+    ringCapacity = fcntl(childProcesses.outputRing[processNumber][1], F_GETPIPE_SZ);
+
+    while(ioctl(childProcesses.outputPipe[processNumber], FIONREAD, &pendingBytes) == 0 && pendingBytes > 0)
+    {
+        bytesToMove = pendingBytes < ringCapacity ? pendingBytes : ringCapacity;
+
+        // Discard the oldest output from the ring, if the new output does not fit in it.
+        if(ioctl(childProcesses.outputRing[processNumber][0], FIONREAD, &ringBytes) == 0 && ringBytes + bytesToMove > ringCapacity)
+        {
+            splice(childProcesses.outputRing[processNumber][0], NULL, nullDevice, NULL, ringBytes + bytesToMove - ringCapacity, SPLICE_F_NONBLOCK);
+        }
+
+        bytesMoved = tee(childProcesses.outputPipe[processNumber], childProcesses.outputRing[processNumber][1], bytesToMove, SPLICE_F_NONBLOCK);
+        if(bytesMoved <= 0)
+        {
+            bytesMoved = bytesToMove;
+        }
+
+        bytesMoved = splice(childProcesses.outputPipe[processNumber], NULL, childProcesses.outputLogFile[processNumber] != -1 ? childProcesses.outputLogFile[processNumber] : nullDevice, NULL,
+        bytesMoved, SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+        if(bytesMoved <= 0)
+        {
+            break;
+        }
+    }
+
+    // The process has closed its output, as it got terminated.
+    // A process that exited on its own, for example on reaching its cpu time limit, is reaped first. Its pipe is kept till then,
+    // as the output is closed a moment before the process can be reaped, and the pipe keeps reporting the hangup.
+    if(pendingBytes == 0)
+    {
+        struct pollfd pipeStatus = { .fd = childProcesses.outputPipe[processNumber], .events = POLLIN };
+        if(poll(&pipeStatus, 1, 0) == 1 && (pipeStatus.revents & POLLHUP))
+        {
+            reapExitedChildProcess(processNumber);
+            if(childProcesses.state[processNumber] != Terminated)
+            {
+                return;
+            }
+
+            close(childProcesses.outputPipe[processNumber]);
+            childProcesses.outputPipe[processNumber] = -1;
+            if(childProcesses.outputLogFile[processNumber] != -1)
+            {
+                close(childProcesses.outputLogFile[processNumber]);
+                childProcesses.outputLogFile[processNumber] = -1;
+            }
+        }
+    }
+}
+
+/*
+* Summary - This method will reap a child process that exited on its own, for example by exceeding its resource limits.
+* If it was run by the scheduler, the alarm is raised right away to run the next process, like the 'k #' command does.
+* The signals of the scheduler are blocked meanwhile, so that their handlers do not see the process table half updated.
+* Param 1 - processNumber - the process identifier
+*/
+void reapExitedChildProcess(int processNumber)
+{
+    // Declarations
+    int childStatus, processId = childProcesses.processId[processNumber];
+    enum processStates previousState = childProcesses.state[processNumber];
+    sigset_t previousSignals;
+
+    if(previousState == Terminated || waitpid(processId, &childStatus, WNOHANG) != processId)
+    {
+        return;
+    }
+
+    blockSchedulerSignals(&previousSignals);
+
+    previousState = childProcesses.state[processNumber];
+    setProcessState(processNumber, Terminated);
+    if(WIFSIGNALED(childStatus))
+    {
+        logSchedulerEvent(LogWarning, "\033[0;31m", "\nChild %d -> %s -> Terminated by %s\n", processId, getProcessState(previousState),
+        strsignal(WTERMSIG(childStatus)));
+    }
+    // A synthetic child process exits with status 0 once it has burnt its cpu time, which is not worth a warning.
+    else if(WEXITSTATUS(childStatus) == 0)
+    {
+        logSchedulerEvent(LogInfo, "\033[0;32m", "\nChild %d -> %s -> Terminated, having completed its work\n", processId,
+        getProcessState(previousState));
+        recordReplayedJobCompletion(processNumber);
+    }
+    else
+    {
+        logSchedulerEvent(LogWarning, "\033[0;31m", "\nChild %d -> %s -> Terminated with exit status %d\n", processId,
+        getProcessState(previousState), WEXITSTATUS(childStatus));
+    }
+
+    if(previousState == Running && runningOneProcess == 0 && countRunningProcesses() == 0)
+    {
+        terminatedChildProcess = processId;
+        metrics.timerDeadlineInMicros = 0;
+        ualarm(1, 0);
+    }
+
+    unblockSchedulerSignals(&previousSignals);
+}
+
+/*
+* Summary - This method will drain the pending output of all the child processes.
+*/
+void drainAllChildProcessOutput()
+{
+    // Declarations
+    int counter;
+
+    for(counter = 0; counter < childProcessCountTracker; counter++)
+    {
+        if(childProcesses.processAdded[counter] == 1)
+        {
+            drainChildProcessOutput(counter);
+        }
+    }
+}
+
+/*
+* Summary - This method will display the recent output of a child process from its outputRing pipe.
+* The ring is duplicated into a temporary pipe using tee(), so that the output stays in the ring for the next 'tail #' command.
+* Param 1 - cmdArguments - command line arguments
+* Returns 1, after a flawless execution
+*/
+int displayChildProcessOutput(char **cmdArguments)
+{
+    if(cmdArguments[1] != NULL && cmdArguments[2] == NULL)
+    {
+        // Declarations
+        int argDataLength = strlen(cmdArguments[1]);
+        int argCount, processNumber, ringBytes = 0, temporaryPipe[2];
+        char recentOutput[JOB_OUTPUT_RING_SIZE + 1], *firstLine;
+        ssize_t bytesRead = 0;
+
+        for(argCount = 0; argCount < argDataLength; argCount ++)
+        {
+            if(isdigit(cmdArguments[1][argCount]) == 0)
+            {
+                goto PrintError;
+            }
+        }
+
+        processNumber = atoi(cmdArguments[1]);
+        if(processNumber >= childProcessCountTracker || childProcesses.processAdded[processNumber] == 0)
+        {
+            goto PrintError;
+        }
+
+        drainChildProcessOutput(processNumber);
+
+        if(childProcesses.outputRing[processNumber][0] != -1 && pipe2(temporaryPipe, O_CLOEXEC) == 0)
+        {
+            fcntl(temporaryPipe[1], F_SETPIPE_SZ, JOB_OUTPUT_RING_SIZE);
+            ioctl(childProcesses.outputRing[processNumber][0], FIONREAD, &ringBytes);
+            if(ringBytes > 0 && tee(childProcesses.outputRing[processNumber][0], temporaryPipe[1], ringBytes, SPLICE_F_NONBLOCK) > 0)
+            {
+                bytesRead = read(temporaryPipe[0], recentOutput, JOB_OUTPUT_RING_SIZE);
+            }
+            close(temporaryPipe[0]);
+            close(temporaryPipe[1]);
+        }
+
+        if(bytesRead <= 0)
+        {
+            printf("There is no output from the process with number %d.\n", processNumber);
+            return 1;
+        }
+
+        recentOutput[bytesRead] = '\0';
+
+        // If the oldest output was discarded from a full ring, the first line might be partial.
+        firstLine = recentOutput;
+        if(bytesRead == JOB_OUTPUT_RING_SIZE && strchr(recentOutput, '\n') != NULL)
+        {
+            firstLine = strchr(recentOutput, '\n') + 1;
+        }
+
+        fputs(firstLine, stdout);
+        setOutputColor("\033[0m");
+        return 1;
+    }
+
+    PrintError:puts("The entered process number appears to be incorrect.\n"
+    "Please use the 'l' command to display child processes information.\n");
+
+    return 1;
+}
+
+/*
+* Summary - This method will read the start time of a process from /proc/<pid>/stat.
+* Param 1 - processId - the process id
+* Returns the start time in clock ticks since boot, 0 if the process does not exist.
+*/
+unsigned long long readProcessStartTime(int processId)
+{
+    // Declarations
+    char statPath[64], statLine[1024], *fields;
+    unsigned long long startTime = 0;
+    FILE *statFile;
+
+    snprintf(statPath, sizeof(statPath), "/proc/%d/stat", processId);
+    statFile = fopen(statPath, "r");
+    if(statFile == NULL)
+    {
+        return 0;
+    }
+
+    // The process name is in parentheses and may contain spaces, so the fields are counted from the last ')'.
+    // The start time is the 22nd field, which is the 20th field after the process name.
+    if(fgets(statLine, sizeof(statLine), statFile) != NULL && (fields = strrchr(statLine, ')')) != NULL)
+    {
+        sscanf(fields + 2, "%*c %*d %*d %*d %*d %*d %*u %*u %*u %*u %*u %*u %*u %*d %*d %*d %*d %*d %*d %llu", &startTime);
+    }
+    fclose(statFile);
+
+    return startTime;
+}
+
+/*
+* Summary - This method will read the parent process id of a process from /proc/<pid>/stat.
+* Param 1 - processId - the process id
+* Returns the parent process id, which is the 4th field, or -1 if the process does not exist.
+*/
+int readParentProcessId(int processId)
+{
+    // Declarations
+    char statPath[64], statLine[1024], *fields;
+    int parentProcessId = -1;
+    FILE *statFile;
+
+    snprintf(statPath, sizeof(statPath), "/proc/%d/stat", processId);
+    statFile = fopen(statPath, "r");
+    if(statFile == NULL)
+    {
+        return -1;
+    }
+
+    if(fgets(statLine, sizeof(statLine), statFile) == NULL || (fields = strrchr(statLine, ')')) == NULL
+    || sscanf(fields + 2, "%*c %d", &parentProcessId) != 1)
+    {
+        parentProcessId = -1;
+    }
+    fclose(statFile);
+
+    return parentProcessId;
+}
+
+/*
+* Summary - This method will append a record to the state journal.
+* The record is written with a single write() on a file opened with O_APPEND, so that a crash of the shell
+* can leave at most the last record incomplete. Nothing is written while the state is being recovered.
+* Param 1 - format - printf style format of the record, without the trailing newline
+*/
+void appendJournalRecord(const char *format, ...)
+{
+    // Declarations
+    char record[MAXIMUM_STATE_RECORD_LENGTH];
+    int recordLength;
+    va_list arguments;
+
+    if(stateJournal == -1)
+    {
+        return;
+    }
+
+    va_start(arguments, format);
+    recordLength = vsnprintf(record, sizeof(record) - 1, format, arguments);
+    va_end(arguments);
+
+    if(recordLength < 0 || recordLength >= (int) sizeof(record) - 1)
+    {
+        return;
+    }
+
+    record[recordLength++] = '\n';
+    if(write(stateJournal, record, recordLength) == recordLength)
+    {
+        journalRecordCount++;
+    }
+}
+
+/*
+* Summary - This method will journal the record of a child process.
+* Format - P processNumber processId state gangNumber processGroupId startTime
+* Param 1 - processNumber - the process identifier
+*/
+void journalProcess(int processNumber)
+{
+    appendJournalRecord("P %d %d %d %d %d %llu", processNumber, childProcesses.processId[processNumber],
+    childProcesses.state[processNumber], childProcesses.gangNumber[processNumber], childProcesses.processGroupId[processNumber],
+    childProcesses.startTime[processNumber]);
+}
+
+/*
+* Summary - This method will journal the record of a gang.
+* Format - G gangNumber gangName processGroupId
+* Param 1 - gangNumber - the gang number (1 based)
+*/
+void journalGang(int gangNumber)
+{
+    appendJournalRecord("G %d %s %d", gangNumber, gangs[gangNumber - 1].gangName, gangs[gangNumber - 1].processGroupId);
+}
+
+/*
+* Summary - This method will journal the scheduler settings.
+* Format - S algorithm quantumTimeInMillis burstTimeInSecs autoQuantumEnabled memoryBudgetInKB defaultProcessGroupId
+*/
+void journalSettings()
+{
+    appendJournalRecord("S %s %d %d %d %ld %d", schedulingAlgo[0] != '\0' ? schedulingAlgo : "-", roundRobinQuantumTimeInMillis,
+    fcfsBurstTimeInSecs, autoQuantumEnabled, memoryBudgetInKB, defaultProcessGroupId);
+}
+
+/*
+* Summary - This method will write the complete state, one record per line, into a state file.
+* Param 1 - stateFile - the file to write into
+* Returns 1, if all the records are written, else 0.
+*/
+int writeStateRecords(int stateFile)
+{
+    // Declarations
+    int counter, expectedRecordCount = 1, writtenRecordCount;
+    int savedJournal = stateJournal, savedRecordCount = journalRecordCount;
+
+    // The records are produced by the journal methods, so the journal is pointed to the state file for a while.
+    stateJournal = stateFile;
+    journalRecordCount = 0;
+
+    journalSettings();
+    for(counter = 0; counter < MAXIMUM_NUMBER_OF_GANGS; counter++)
+    {
+        if(gangs[counter].gangAdded == 1)
+        {
+            journalGang(counter + 1);
+            expectedRecordCount++;
+        }
+    }
+    for(counter = 0; counter < childProcessCountTracker; counter++)
+    {
+        if(childProcesses.processAdded[counter] == 1)
+        {
+            journalProcess(counter);
+            expectedRecordCount++;
+        }
+    }
+
+    writtenRecordCount = journalRecordCount;
+    stateJournal = savedJournal;
+    journalRecordCount = savedRecordCount;
+
+    return writtenRecordCount == expectedRecordCount;
+}
+
+/*
+* Summary - This method will compact the journal into a snapshot.
+* The snapshot is written into a temporary file that is renamed over the previous snapshot, so that a crash
+* leaves either the previous or the new snapshot in place. The journal is emptied only after the rename.
+* The signals of the scheduler are blocked meanwhile, as their handlers change the process states and journal them,
+* which would write their records into the snapshot while the journal is pointed to it.
+*/
+void writeStateSnapshot()
+{
+    // Declarations
+    int snapshotFile;
+    sigset_t previousSignals;
+
+    if(stateJournal == -1)
+    {
+        return;
+    }
+
+    blockSchedulerSignals(&previousSignals);
+
+    snapshotFile = open(STATE_SNAPSHOT_FILE ".tmp", O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if(snapshotFile != -1)
+    {
+        if(writeStateRecords(snapshotFile) && fsync(snapshotFile) == 0 && rename(STATE_SNAPSHOT_FILE ".tmp", STATE_SNAPSHOT_FILE) == 0)
+        {
+            ftruncate(stateJournal, 0);
+            journalRecordCount = 0;
+        }
+        close(snapshotFile);
+    }
+
+    unblockSchedulerSignals(&previousSignals);
+}
+
+/*
+* Summary - This method will apply a journal or snapshot record to the process table and the scheduler settings.
+* A later record of a process or a gang replaces the earlier one. Malformed records are ignored.
+* Param 1 - record - the record, without the trailing newline
+*/
+void replayStateRecord(char *record)
+{
+    // Declarations
+    int processNumber, processId, state, gangNumber, processGroupId, quantumTimeInMillis, burstTimeInSecs, autoQuantum;
+    unsigned long long startTime;
+    long budgetInKB;
+    char name[MAXIMUM_GANG_NAME_LENGTH + 1], algorithm[10];
+
+    if(sscanf(record, "P %d %d %d %d %d %llu", &processNumber, &processId, &state, &gangNumber, &processGroupId, &startTime) == 6)
+    {
+        if(processNumber < 0 || processNumber >= MAXIMUM_NUMBER_OF_CHILD_PROCESSES || state < Ready || state > Terminated
+        || gangNumber < 0 || gangNumber > MAXIMUM_NUMBER_OF_GANGS)
+        {
+            return;
+        }
+
+        childProcesses.processNumber[processNumber] = processNumber;
+        childProcesses.processId[processNumber] = processId;
+        childProcesses.state[processNumber] = state;
+        childProcesses.processAdded[processNumber] = 1;
+        childProcesses.gangNumber[processNumber] = gangNumber;
+        childProcesses.processGroupId[processNumber] = processGroupId;
+        childProcesses.startTime[processNumber] = startTime;
+        if(processNumber >= childProcessCountTracker)
+        {
+            childProcessCountTracker = processNumber + 1;
+        }
+    }
+    else if(sscanf(record, "G %d %20s %d", &gangNumber, name, &processGroupId) == 3)
+    {
+        if(gangNumber < 1 || gangNumber > MAXIMUM_NUMBER_OF_GANGS || strlen(name) >= MAXIMUM_GANG_NAME_LENGTH)
+        {
+            return;
+        }
+
+        strcpy(gangs[gangNumber - 1].gangName, name);
+        gangs[gangNumber - 1].gangAdded = 1;
+        gangs[gangNumber - 1].processGroupId = processGroupId;
+    }
+    else if(sscanf(record, "S %9s %d %d %d %ld %d", algorithm, &quantumTimeInMillis, &burstTimeInSecs, &autoQuantum, &budgetInKB,
+    &processGroupId) == 6)
+    {
+        strcpy(schedulingAlgo, strcmp(algorithm, "rr") == 0 || strcmp(algorithm, "fcfs") == 0 ? algorithm : "");
+        roundRobinQuantumTimeInMillis = quantumTimeInMillis;
+        fcfsBurstTimeInSecs = burstTimeInSecs;
+        autoQuantumEnabled = autoQuantum != 0;
+        memoryBudgetInKB = budgetInKB;
+        defaultProcessGroupId = processGroupId;
+    }
+}
+
+/*
+* Summary - This method will replay all the complete records of a journal or snapshot file.
+* A record without a trailing newline was cut short by a crash, so it is ignored.
+* Param 1 - path - the file to replay
+*/
+void replayStateFile(char *path)
+{
+    // Declarations
+    char record[MAXIMUM_STATE_RECORD_LENGTH];
+    FILE *stateFile = fopen(path, "r");
+
+    if(stateFile == NULL)
+    {
+        return;
+    }
+
+    while(fgets(record, sizeof(record), stateFile) != NULL)
+    {
+        if(strchr(record, '\n') != NULL)
+        {
+            replayStateRecord(record);
+        }
+    }
+
+    fclose(stateFile);
+}
+
+/*
+* Summary - This method will recover the state left behind by a previous shell, when the shell starts.
+* 1. Replay the snapshot, and then the journal, to rebuild the process table and the scheduler settings.
+* 2. Open a pidfd for every non-terminated process, and check its start time, so that a process reusing the pid is not adopted.
+*    The processes that did not survive are marked as terminated, so that the process numbers stay the same.
+* 3. Stop the re-adopted processes, as nothing else will preempt the ones that were running when the previous shell died.
+*    Their control pages are mapped again from the descriptor they hold it in.
+* 4. Start a new journal with a snapshot of the recovered state.
+* If no process survived, the previous state is discarded and the shell starts afresh.
+*/
+void recoverSchedulerState()
+{
+    // Declarations
+    int counter, processFileDescriptor, adoptedProcessCount = 0, lostProcessCount = 0;
+    long long recoveryStartTimeInMicros = getMonotonicTimeInMicros();
+
+    for(counter = 0; counter < MAXIMUM_NUMBER_OF_CHILD_PROCESSES; counter++)
+    {
+        childProcesses.processFileDescriptor[counter] = -1;
+        childProcesses.outputPipe[counter] = -1;
+        childProcesses.outputRing[counter][0] = -1;
+        childProcesses.outputRing[counter][1] = -1;
+        childProcesses.outputLogFile[counter] = -1;
+        childProcesses.cacheDomain[counter] = -1;
+        childProcesses.lastCpu[counter] = -1;
+    }
+
+    mkdir(STATE_DIRECTORY, 0755);
+    replayStateFile(STATE_SNAPSHOT_FILE);
+    replayStateFile(STATE_JOURNAL_FILE);
+
+    for(counter = 0; counter < childProcessCountTracker; counter++)
+    {
+        if(childProcesses.processAdded[counter] == 0)
+        {
+            continue;
+        }
+
+        if(childProcesses.state[counter] != Terminated)
+        {
+            processFileDescriptor = pidfd_open(childProcesses.processId[counter], 0);
+            if(processFileDescriptor == -1 || childProcesses.startTime[counter] == 0
+            || readProcessStartTime(childProcesses.processId[counter]) != childProcesses.startTime[counter])
+            {
+                if(processFileDescriptor != -1)
+                {
+                    close(processFileDescriptor);
+                }
+                childProcesses.state[counter] = Terminated;
+                lostProcessCount++;
+            }
+            else
+            {
+                fcntl(processFileDescriptor, F_SETFD, FD_CLOEXEC);
+                childProcesses.processFileDescriptor[counter] = processFileDescriptor;
+                recoverControlPage(counter);
+                childProcesses.cacheDomain[counter] = findCacheDomainOfProcess(childProcesses.processId[counter]);
+                // The kernel continues the stopped processes of a group orphaned by the death of the shell, so all of them are stopped again.
+                pidfd_send_signal(processFileDescriptor, SIGSTOP, NULL, 0);
+                childProcesses.state[counter] = Suspended;
+                adoptedProcessCount++;
+            }
+        }
+
+        // Rebuild the state bitmaps, the journal is not open yet so nothing is journalled.
+        setProcessState(counter, childProcesses.state[counter]);
+    }
+
+    if(adoptedProcessCount == 0)
+    {
+        memset(&childProcesses, 0, sizeof(childProcesses));
+        memset(gangs, 0, sizeof(gangs));
+        childProcessCountTracker = 0;
+        schedulingAlgo[0] = '\0';
+        roundRobinQuantumTimeInMillis = 0;
+        fcfsBurstTimeInSecs = 0;
+        autoQuantumEnabled = false;
+        memoryBudgetInKB = 0;
+        defaultProcessGroupId = 0;
+        for(counter = 0; counter < MAXIMUM_NUMBER_OF_CHILD_PROCESSES; counter++)
+        {
+            childProcesses.processFileDescriptor[counter] = -1;
+        }
+    }
+
+    stateJournal = open(STATE_JOURNAL_FILE, O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    writeStateSnapshot();
+
+    if(adoptedProcessCount > 0)
+    {
+        setOutputColor("\033[0;34m");
+        printf("Re-adopted %d child processes of the previous shell in %lld ms, %d did not survive.\n", adoptedProcessCount,
+        (getMonotonicTimeInMicros() - recoveryStartTimeInMicros) / 1000, lostProcessCount);
+        setOutputColor("\033[0m");
+    }
+}
+
+/*
+* Summary - This method will map the control page of a re-adopted process again, through its descriptor in /proc.
+* The page is only used if the process has published its own process id in it.
+* Param 1 - processNumber - the re-adopted process
+*/
+void recoverControlPage(int processNumber)
+{
+    // Declarations
+    char descriptorPath[64];
+    int controlPageDescriptor;
+    struct controlPage *control;
+
+    snprintf(descriptorPath, sizeof(descriptorPath), "/proc/%d/fd/%d", childProcesses.processId[processNumber], CONTROL_PAGE_DESCRIPTOR);
+    controlPageDescriptor = open(descriptorPath, O_RDWR | O_CLOEXEC);
+    if(controlPageDescriptor == -1)
+    {
+        return;
+    }
+
+    control = mapControlPage(controlPageDescriptor);
+    close(controlPageDescriptor);
+    if(control != NULL && control->processId != childProcesses.processId[processNumber])
+    {
+        munmap(control, sizeof(struct controlPage));
+        control = NULL;
+    }
+
+    childProcesses.controlPage[processNumber] = control;
+}
+
+/*
+* Summary - This method will remove the state files, when the shell exits after terminating all the child processes.
+*/
+void removeSchedulerState()
+{
+    if(stateJournal != -1)
+    {
+        close(stateJournal);
+        stateJournal = -1;
+    }
+
+    unlink(STATE_JOURNAL_FILE);
+    unlink(STATE_SNAPSHOT_FILE);
+    rmdir(STATE_DIRECTORY);
+}
+
+/*
+* Summary - This method will check, if the shell can create new child processes.
+* This shell is designed to create only MAXIMUM_NUMBER_OF_CHILD_PROCESSES processes, or fewer, if the descriptor limit
+* does not leave room for that many (see raiseFileDescriptorLimit).
+* Returns 1, after a flawless execution
+*/
+int creationOfChildProcessAllowed()
+{
+    // Decalrations
+    int totalChildProcesses = 0;
+    totalChildProcesses = childProcessCountTracker + 1;
+
+    if(totalChildProcesses > childProcessLimit)
+    {
+        return 0;
+    }
+
+    childProcessCountTracker = totalChildProcesses;
+
+    return 1;
+}
+
+/*
+* Summary - This method will clear the console.
+* Returns 1, after a flawless execution
+*/
+int clearConsole(char **cmdArguments)
+{
+    if(cmdArguments[1] == NULL)
+    {
+        system("clear");
+        return 1;
+    }
+
+    puts("The entered command appears to be incorrect.\n"
+    "Please use the 'help' command to see the command list.\n");
+
+    return 1;
+}
+
+/*
+* Summary - This method will be used to set the quantum time that will be used by RR & RRN scheduling algorithms.
+* 'q auto' lets the scheduler tune the quantum time of every process, starting from the quantum time set by 'q #' (1 sec by default).
+* 'q #' sets a fixed quantum time for all the processes, and turns 'q auto' off. 'q #ms' sets it in milliseconds.
+* Param 1 - cmdArguments - command line arguments
+* Returns 1, after a flawless execution
+* Answer to question 5 (q #)
+*/
+int setQuantumTime(char **cmdArguments)
+{
+    if(cmdArguments[1] != NULL && cmdArguments[2] == NULL)
+    {
+        // Declarations
+        int argDataLength = strlen(cmdArguments[1]);
+        int argCount, loopCounter;
+
+        if(strcmp(cmdArguments[1], "auto") == 0)
+        {
+            if(isProcessRunning() == 0)
+            {
+                printf("There is an ongoing process execution. Please stop that first and then set the quantum time.\n");
+                return 1;
+            }
+
+            if(roundRobinQuantumTimeInMillis <= 0)
+            {
+                roundRobinQuantumTimeInMillis = 1000;
+            }
+
+            autoQuantumEnabled = true;
+            journalSettings();
+            printf("The quantum time will be tuned automatically, starting from %d ms.\n", roundRobinQuantumTimeInMillis);
+            return 1;
+        }
+
+        // The quantum time is in secs, unless it ends with 'ms'.
+        bool timeInMillis = argDataLength > 2 && strcmp(cmdArguments[1] + argDataLength - 2, "ms") == 0;
+        if(timeInMillis)
+        {
+            argDataLength -= 2;
+        }
+
+        for(argCount = 0; argCount < argDataLength; argCount ++)
+        {
+            if(isdigit(cmdArguments[1][argCount]) == 0)
+            {
+                goto PrintError;
+            }
+        }
+
+        if(isProcessRunning() == 0)
+        {
+            printf("There is an ongoing process execution. Please stop that first and then set the quantum time.\n");
+            return 1;
+        }
+
+        int timeValue = atoi(cmdArguments[1]);
+
+        if(timeValue > 0 && timeValue <= (timeInMillis ? MAXIMUM_ROUND_ROBIN_QUANTUM_TIME_IN_SECS * 1000 : MAXIMUM_ROUND_ROBIN_QUANTUM_TIME_IN_SECS))
+        {
+            roundRobinQuantumTimeInMillis = timeInMillis ? timeValue : timeValue * 1000;
+            autoQuantumEnabled = false;
+            for(loopCounter = 0; loopCounter < childProcessCountTracker; loopCounter++)
+            {
+                childProcesses.quantumTimeInMillis[loopCounter] = 0;
+            }
+            journalSettings();
+            printf("The value of quantum time is set to %d %s.\n", timeValue, timeInMillis ? "ms" : "secs");
+            return 1;
+        }
+    }
+
+    // Invalid quantum time is entered by the user. Display the error and proceed the execution.
+    PrintError:printf("The entered quantum time appears to be incorrect.\nPlease set the quantum time to atleast 1 ms and no longer than %d secs, or to 'auto'.\nIf needed, use the 'help' command to see the command list.\n", MAXIMUM_ROUND_ROBIN_QUANTUM_TIME_IN_SECS);
+
+    return 1;
+}
+
+/*
+* Summary - This method will be used to set the burst time that will be used by FCFS scheduling algorithm.
+* Param 1 - cmdArguments - command line arguments
+* Returns 1, after a flawless execution
+*/
+int setBurstTimeForFCFS(char **cmdArguments)
+{
+    if(cmdArguments[1] != NULL && cmdArguments[2] == NULL)
+    {
+        // Declarations
+        int argDataLength = strlen(cmdArguments[1]);
+        int argCount, loopCounter;
+
+        for(argCount = 0; argCount < argDataLength; argCount ++)
+        {
+            if(isdigit(cmdArguments[1][argCount]) == 0)
+            {
+                goto PrintError;
+            }
+        }
+
+        if(isProcessRunning() == 0)
+        {
+            printf("There is an ongoing process execution. Please stop that first and then set the burst time.\n");
+            return 1;
+        }
+
+        int timeInSecs = atoi(cmdArguments[1]);
+
+        if(timeInSecs >= MINIMUM_FCFS_BURST_TIME_IN_SECS)
+        {
+            fcfsBurstTimeInSecs = timeInSecs;
+            journalSettings();
+            printf("The value of burst time is set to %d secs.\n", fcfsBurstTimeInSecs);
+            return 1;
+        }
+    }
+
+    // Invalid burst time is entered by the user. Display the error and proceed the execution.
+    PrintError:printf("The entered burst time appears to be incorrect.\nPlease set the burst time to atleast %d secs.\nIf needed, use the 'help' command to see the command list.\n", MINIMUM_FCFS_BURST_TIME_IN_SECS);
+
+    return 1;
+}
+
+/*
+* Summary - This method will be used to set the scheduling algorithm.
+* 1.FCFS - First Come First Serve
+* 2.RR - Round Robin
+* Param 1 - cmdArguments - command line arguments
+* Returns 1, after a flawless execution
+* Answer to question 6 & 7 (t rr, t fcfs)
+*/
+int setSchedulingAlgorithm(char **cmdArguments)
+{
+    // Declarations
+    char *schedulingAlgorithms[] = {"fcfs", "rr"};
+    int algoLength = sizeof(schedulingAlgorithms) / sizeof(char*);
+    int countOfAlgo;
+
+    if(cmdArguments[1] != NULL && cmdArguments[2] == NULL)
+    {
+        for(countOfAlgo = 0; countOfAlgo < algoLength; countOfAlgo++)
+        {
+            if (strcmp(cmdArguments[1], schedulingAlgorithms[countOfAlgo]) == 0)
+            {
+                if(isProcessRunning() == 0)
+                {
+                    printf("Cant set a new algorithm, as the process is already running.\n");
+                    return 1;
+                }
+
+                // Reset the data
+                terminatedChildProcess = 0;
+
+                strcpy(schedulingAlgo, cmdArguments[1]);
+                journalSettings();
+                printf("The algorithm for process scheduling is set to %s.\n", schedulingAlgo);
+                return 1;
+            }
+        }
+    }
+
+    // Invalid name of the algorithm is entered by the user. Display list of available algorithms & commands and proceed the execution.
+    puts("The algorithm you entered appears to be incorrect.\n"
+    "Round robin and fcfs are currently supported.\n"
+    "If needed, use the 'help' command to see the command list.\n");
+
+    return 1;
+}
+
+/*
+* Summary - This method will display the scheduler statistics.
+* The quantum time, memory usage and placement of every non-terminated process, the p99 response time, the memory budget,
+* the cpu topology, the migrations of the running processes, and the recent 'q auto' adjustments are displayed.
+* Param 1 - cmdArguments - command line arguments
+* Returns 1, after a flawless execution
+*/
+int displaySchedulerStatistics(char **cmdArguments)
+{
+    // Declarations
+    int counter, firstAdjustment;
+    struct quantumAdjustment *adjustment;
+
+    if(cmdArguments[1] != NULL)
+    {
+        puts("The command you entered appears to be incorrect.\n"
+        "If needed, use the 'help' command to see the command list.\n");
+        return 1;
+    }
+
+    setOutputColor("\033[0;36m");
+    printf("Quantum Time: %s, p99 Response Time: %lld ms, Last Switch Overhead: %lld us\n",
+    autoQuantumEnabled ? "auto" : "fixed", getP99ResponseTimeInMicros() / 1000, lastSwitchOverheadInMicros);
+    printf("Memory Usage: %ld KB, Memory Budget: %ld KB, Queued Creations: %d\n", sampleMemoryUsage(NULL), memoryBudgetInKB,
+    queuedCreationCount);
+    printf("Topology: %d CPUs, %d Packages, %d L3 Domains, %d NUMA Nodes\n", topology.cpuCount, topology.packageCount,
+    topology.cacheDomainCount, topology.numaNodeCount);
+    printf("Migrations: %lu within an L3 domain, %lu across L3 domains, %lu across NUMA nodes\n",
+    __atomic_load_n(&metrics.migrationCount, __ATOMIC_RELAXED), __atomic_load_n(&metrics.crossCacheDomainMigrationCount, __ATOMIC_RELAXED),
+    __atomic_load_n(&metrics.crossNodeMigrationCount, __ATOMIC_RELAXED));
+
+    for(counter = 0; counter < childProcessCountTracker; counter++)
+    {
+        if(childProcesses.state[counter] != Terminated)
+        {
+            printf("Process %d, PID %d, Quantum %d ms, Memory %ld KB, L3 Domain %d, Last CPU %d%s\n", childProcesses.processNumber[counter],
+            childProcesses.processId[counter], getQuantumTimeInMillis(counter), childProcesses.memoryUsageInKB[counter],
+            childProcesses.cacheDomain[counter], childProcesses.lastCpu[counter],
+            isMemoryThrottled(counter) ? " (suspended due to memory pressure)" : "");
+        }
+    }
+
+    firstAdjustment = quantumAdjustmentCount - NUMBER_OF_LOGGED_QUANTUM_ADJUSTMENTS;
+    if(firstAdjustment < 0)
+    {
+        firstAdjustment = 0;
+    }
+
+    for(counter = firstAdjustment; counter < quantumAdjustmentCount; counter++)
+    {
+        adjustment = &quantumAdjustments[counter % NUMBER_OF_LOGGED_QUANTUM_ADJUSTMENTS];
+        printf("Adjustment: PID %d, Quantum %d ms -> %d ms, CPU %d%%, Switch Overhead %d.%d%% (%s)\n", adjustment->processId,
+        adjustment->oldQuantumTimeInMillis, adjustment->newQuantumTimeInMillis, adjustment->cpuUsageInPercent,
+        adjustment->switchOverheadInPermille / 10, adjustment->switchOverheadInPermille % 10, adjustment->reason);
+    }
+    setOutputColor("\033[0m");
+
+    return 1;
+}
+
+/*
+* Summary - This method will export the scheduler metrics in the Prometheus text format.
+* The metrics are written into a temporary file that is renamed over METRICS_FILE, so a reader never sees a partial file.
+* The rates are computed over the time since the previous export.
+*/
+void exportSchedulerMetrics()
+{
+    // Declarations
+    FILE *metricsFile;
+    char *stateLabels[] = {"", "ready", "running", "suspended", "terminated"};
+    int counter, state;
+    long long nowInMicros = getMonotonicTimeInMicros(), cpuTimeInNanos, runDelayInNanos;
+    double elapsedInSecs = (nowInMicros - lastMetricsExportTimeInMicros) / 1000000.0;
+    unsigned long dispatchCount = __atomic_load_n(&metrics.dispatchCount, __ATOMIC_RELAXED);
+    unsigned long preemptionCount = __atomic_load_n(&metrics.preemptionCount, __ATOMIC_RELAXED);
+    unsigned long dispatchLatencyCount = __atomic_load_n(&metrics.dispatchLatencyCount, __ATOMIC_RELAXED);
+    unsigned long long dispatchLatencyInMicros = __atomic_load_n(&metrics.dispatchLatencyInMicros, __ATOMIC_RELAXED);
+
+    metricsFile = fopen(METRICS_FILE ".tmp", "w");
+    if(metricsFile == NULL)
+    {
+        return;
+    }
+
+    fprintf(metricsFile, "# HELP scheduler_processes Child processes per state.\n# TYPE scheduler_processes gauge\n");
+    for(state = Ready; state <= Terminated; state++)
+    {
+        fprintf(metricsFile, "scheduler_processes{state=\"%s\"} %d\n", stateLabels[state], countProcessesInState(state));
+    }
+
+    fprintf(metricsFile, "# HELP scheduler_dispatches_total Scheduling units started by the scheduler.\n"
+    "# TYPE scheduler_dispatches_total counter\nscheduler_dispatches_total %lu\n", dispatchCount);
+    fprintf(metricsFile, "# HELP scheduler_preemptions_total Scheduling units preempted by round robin.\n"
+    "# TYPE scheduler_preemptions_total counter\nscheduler_preemptions_total %lu\n", preemptionCount);
+    fprintf(metricsFile, "# HELP scheduler_terminations_total Scheduling units terminated once their fcfs burst time elapsed.\n"
+    "# TYPE scheduler_terminations_total counter\nscheduler_terminations_total %lu\n",
+    __atomic_load_n(&metrics.terminationCount, __ATOMIC_RELAXED));
+    fprintf(metricsFile, "# HELP scheduler_alarms_total Alarms handled by the scheduler.\n"
+    "# TYPE scheduler_alarms_total counter\nscheduler_alarms_total %lu\n", __atomic_load_n(&metrics.alarmCount, __ATOMIC_RELAXED));
+
+    fprintf(metricsFile, "# HELP scheduler_dispatches_per_second Dispatches per second since the previous export.\n"
+    "# TYPE scheduler_dispatches_per_second gauge\nscheduler_dispatches_per_second %.3f\n",
+    elapsedInSecs > 0 ? (dispatchCount - lastExportedDispatchCount) / elapsedInSecs : 0.0);
+    fprintf(metricsFile, "# HELP scheduler_preemptions_per_second Preemptions per second since the previous export.\n"
+    "# TYPE scheduler_preemptions_per_second gauge\nscheduler_preemptions_per_second %.3f\n",
+    elapsedInSecs > 0 ? (preemptionCount - lastExportedPreemptionCount) / elapsedInSecs : 0.0);
+
+    fprintf(metricsFile, "# HELP scheduler_dispatch_latency_seconds Time from an alarm until the next scheduling unit was started.\n"
+    "# TYPE scheduler_dispatch_latency_seconds summary\nscheduler_dispatch_latency_seconds_sum %.6f\n"
+    "scheduler_dispatch_latency_seconds_count %lu\n", dispatchLatencyInMicros / 1000000.0, dispatchLatencyCount);
+    fprintf(metricsFile, "# HELP scheduler_dispatch_latency_mean_seconds Mean time from an alarm until the next scheduling unit was started.\n"
+    "# TYPE scheduler_dispatch_latency_mean_seconds gauge\nscheduler_dispatch_latency_mean_seconds %.6f\n",
+    dispatchLatencyCount > 0 ? dispatchLatencyInMicros / 1000000.0 / dispatchLatencyCount : 0.0);
+
+    fprintf(metricsFile, "# HELP scheduler_timer_overshoot_seconds Time by which the alarms fired later than they were set for.\n"
+    "# TYPE scheduler_timer_overshoot_seconds summary\nscheduler_timer_overshoot_seconds_sum %.6f\n"
+    "scheduler_timer_overshoot_seconds_count %lu\n", __atomic_load_n(&metrics.timerOvershootInMicros, __ATOMIC_RELAXED) / 1000000.0,
+    __atomic_load_n(&metrics.timerOvershootCount, __ATOMIC_RELAXED));
+    fprintf(metricsFile, "# HELP scheduler_timer_overshoot_max_seconds Largest overshoot of an alarm.\n"
+    "# TYPE scheduler_timer_overshoot_max_seconds gauge\nscheduler_timer_overshoot_max_seconds %.6f\n",
+    metrics.maximumTimerOvershootInMicros / 1000000.0);
+
+    fprintf(metricsFile, "# HELP scheduler_migrations_total Moves of the running processes to another cpu, by how far they moved.\n"
+    "# TYPE scheduler_migrations_total counter\nscheduler_migrations_total{scope=\"cache_domain\"} %lu\n"
+    "scheduler_migrations_total{scope=\"cross_cache_domain\"} %lu\nscheduler_migrations_total{scope=\"cross_node\"} %lu\n",
+    __atomic_load_n(&metrics.migrationCount, __ATOMIC_RELAXED), __atomic_load_n(&metrics.crossCacheDomainMigrationCount, __ATOMIC_RELAXED),
+    __atomic_load_n(&metrics.crossNodeMigrationCount, __ATOMIC_RELAXED));
+
+    fprintf(metricsFile, "# HELP scheduler_process_cpu_seconds_total Cpu time consumed by a child process.\n"
+    "# TYPE scheduler_process_cpu_seconds_total counter\n");
+    for(counter = 0; counter < childProcessCountTracker; counter++)
+    {
+        if(childProcesses.processAdded[counter] == 1 && childProcesses.state[counter] != Terminated
+        && readProcessSchedulingStats(childProcesses.processId[counter], &cpuTimeInNanos, &runDelayInNanos))
+        {
+            fprintf(metricsFile, "scheduler_process_cpu_seconds_total{process=\"%d\",pid=\"%d\"} %.6f\n", counter,
+            childProcesses.processId[counter], cpuTimeInNanos / 1000000000.0);
+        }
+    }
+
+    if(fclose(metricsFile) == 0)
+    {
+        rename(METRICS_FILE ".tmp", METRICS_FILE);
+    }
+
+    lastMetricsExportTimeInMicros = nowInMicros;
+    lastExportedDispatchCount = dispatchCount;
+    lastExportedPreemptionCount = preemptionCount;
+}
+
+/*
+* Summary - This method will find the histogram bucket of a latency.
+* Param 1 - latencyInMicros - the latency
+* Returns the bucket
+*/
+int getLatencyBucket(long long latencyInMicros)
+{
+    // Declarations
+    int exponent, bucket;
+
+    if(latencyInMicros < LATENCY_SUB_BUCKET_COUNT)
+    {
+        return latencyInMicros < 0 ? 0 : latencyInMicros;
+    }
+
+    // The bits below the leading LATENCY_SUB_BUCKET_BITS + 1 bits of the latency are dropped.
+    exponent = 63 - __builtin_clzll(latencyInMicros) - LATENCY_SUB_BUCKET_BITS;
+    bucket = LATENCY_SUB_BUCKET_COUNT + exponent * LATENCY_SUB_BUCKET_COUNT + (int) (latencyInMicros >> exponent) - LATENCY_SUB_BUCKET_COUNT;
+
+    return bucket < LATENCY_HISTOGRAM_BUCKETS ? bucket : LATENCY_HISTOGRAM_BUCKETS - 1;
+}
+
+/*
+* Summary - This method will get the largest latency that is recorded in a histogram bucket.
+* Param 1 - bucket - the bucket
+* Returns the latency in microsecs
+*/
+long long getLatencyBucketUpperBound(int bucket)
+{
+    // Declarations
+    int exponent, subBucket;
+
+    if(bucket < LATENCY_SUB_BUCKET_COUNT)
+    {
+        return bucket;
+    }
+
+    exponent = (bucket - LATENCY_SUB_BUCKET_COUNT) / LATENCY_SUB_BUCKET_COUNT;
+    subBucket = (bucket - LATENCY_SUB_BUCKET_COUNT) % LATENCY_SUB_BUCKET_COUNT;
+
+    return ((long long) (LATENCY_SUB_BUCKET_COUNT + subBucket + 1) << exponent) - 1;
+}
+
+/*
+* Summary - This method will record a latency in a histogram.
+* It only increments counters, so it can be called from the signal handlers.
+* Param 1 - histogram - the histogram
+* Param 2 - latencyInMicros - the latency
+*/
+void recordLatency(struct latencyHistogram *histogram, long long latencyInMicros)
+{
+    if(latencyInMicros < 0)
+    {
+        latencyInMicros = 0;
+    }
+
+    histogram->bucketCounts[getLatencyBucket(latencyInMicros)]++;
+    if(histogram->totalCount == 0 || latencyInMicros < histogram->minimumInMicros)
+    {
+        histogram->minimumInMicros = latencyInMicros;
+    }
+    if(latencyInMicros > histogram->maximumInMicros)
+    {
+        histogram->maximumInMicros = latencyInMicros;
+    }
+    histogram->totalCount++;
+}
+
+/*
+* Summary - This method will get a percentile of the latencies recorded in a histogram.
+* Param 1 - histogram - the histogram
+* Param 2 - percentile - the percentile, for example 99.9
+* Returns the upper bound of the bucket holding the percentile, limited to the largest latency recorded
+*/
+long long getLatencyPercentile(struct latencyHistogram *histogram, double percentile)
+{
+    // Declarations
+    unsigned long targetCount, cumulativeCount = 0;
+    int bucket;
+
+    targetCount = (unsigned long) (histogram->totalCount * percentile / 100.0 + 0.999999);
+    if(targetCount == 0)
+    {
+        targetCount = 1;
+    }
+
+    for(bucket = 0; bucket < LATENCY_HISTOGRAM_BUCKETS; bucket++)
+    {
+        cumulativeCount += histogram->bucketCounts[bucket];
+        if(cumulativeCount >= targetCount)
+        {
+            break;
+        }
+    }
+
+    return getLatencyBucketUpperBound(bucket) < histogram->maximumInMicros ? getLatencyBucketUpperBound(bucket) : histogram->maximumInMicros;
+}
+
+/*
+* Summary - This method will remember when SIGCONT is sent to the child processes, to measure how long they take to run.
+* Param 1 - processNumbers - the process identifiers
+* Param 2 - processCount - number of entries in processNumbers
+*/
+void recordContinueTime(int *processNumbers, int processCount)
+{
+    // Declarations
+    int counter;
+    long long continueTimeInMicros = getMonotonicTimeInMicros();
+
+    for(counter = 0; counter < processCount; counter++)
+    {
+        childProcesses.continueTimeInMicros[processNumbers[counter]] = continueTimeInMicros;
+    }
+}
+
+/*
+* Summary - This method will read the handshakes of the child processes that are running after receiving SIGCONT,
+* and record the time they took to run. A handshake is only counted once for every SIGCONT sent by the shell.
+*/
+void readContinueHandshakes()
+{
+    // Declarations
+    struct continueHandshake handshakes[64];
+    ssize_t bytesRead;
+    int handshakeCount, counter, processNumber;
+
+    while((bytesRead = read(handshakePipe[0], handshakes, sizeof(handshakes))) > 0)
+    {
+        handshakeCount = bytesRead / sizeof(struct continueHandshake);
+        for(counter = 0; counter < handshakeCount; counter++)
+        {
+            for(processNumber = 0; processNumber < childProcessCountTracker; processNumber++)
+            {
+                if(childProcesses.processId[processNumber] == handshakes[counter].processId)
+                {
+                    break;
+                }
+            }
+
+            if(processNumber < childProcessCountTracker && childProcesses.continueTimeInMicros[processNumber] != 0)
+            {
+                recordLatency(&continueLatencyHistogram,
+                handshakes[counter].continuedTimeInMicros - childProcesses.continueTimeInMicros[processNumber]);
+                childProcesses.continueTimeInMicros[processNumber] = 0;
+            }
+        }
+    }
+}
+
+/*
+* Summary - This method will display the latency histograms of the scheduler ('lat' command), or clear them ('lat reset').
+* Param 1 - cmdArguments - command line arguments
+* Returns 1, after a flawless execution
+*/
+int displayLatencyHistograms(char **cmdArguments)
+{
+    // Declarations
+    struct latencyHistogram *histograms[] = {&timerOvershootHistogram, &dispatchLatencyHistogram, &continueLatencyHistogram};
+    int histogramCount = sizeof(histograms) / sizeof(histograms[0]);
+    int counter;
+    char *name;
+    sigset_t previousSignals;
+
+    if(cmdArguments[1] != NULL && strcmp(cmdArguments[1], "reset") == 0 && cmdArguments[2] == NULL)
+    {
+        // The alarm handler records latencies into the histograms, so it must not run while they are cleared.
+        blockSchedulerSignals(&previousSignals);
+        for(counter = 0; counter < histogramCount; counter++)
+        {
+            name = histograms[counter]->name;
+            memset(histograms[counter], 0, sizeof(struct latencyHistogram));
+            histograms[counter]->name = name;
+        }
+        unblockSchedulerSignals(&previousSignals);
+        printf("The latency histograms are cleared.\n");
+        return 1;
+    }
+
+    if(cmdArguments[1] != NULL)
+    {
+        puts("The command you entered appears to be incorrect.\n"
+        "If needed, use the 'help' command to see the command list.\n");
+        return 1;
+    }
+
+    // Collect the pending handshakes, so that the latest dispatch is included.
+    if(handshakePipe[0] != -1)
+    {
+        readContinueHandshakes();
+    }
+
+    setOutputColor("\033[0;36m");
+    printf("%-20s %8s %10s %10s %10s %10s %10s %10s\n", "Latency (us)", "Count", "Min", "p50", "p90", "p99", "p99.9", "Max");
+    for(counter = 0; counter < histogramCount; counter++)
+    {
+        if(histograms[counter]->totalCount == 0)
+        {
+            printf("%-20s %8d %10s %10s %10s %10s %10s %10s\n", histograms[counter]->name, 0, "-", "-", "-", "-", "-", "-");
+            continue;
+        }
+
+        printf("%-20s %8lu %10lld %10lld %10lld %10lld %10lld %10lld\n", histograms[counter]->name, histograms[counter]->totalCount,
+        histograms[counter]->minimumInMicros, getLatencyPercentile(histograms[counter], 50),
+        getLatencyPercentile(histograms[counter], 90), getLatencyPercentile(histograms[counter], 99),
+        getLatencyPercentile(histograms[counter], 99.9), histograms[counter]->maximumInMicros);
+    }
+    setOutputColor("\033[0m");
+
+    return 1;
+}
+
+/*
+* Summary - This method will read a number from a file of CPU_TOPOLOGY_DIRECTORY.
+* Param 1 - path - the path of the file
+* Returns the number, -1 if the file can not be read.
+*/
+int readTopologyValue(char *path)
+{
+    // Declarations
+    FILE *topologyFile;
+    int value = -1;
+
+    topologyFile = fopen(path, "r");
+    if(topologyFile != NULL)
+    {
+        if(fscanf(topologyFile, "%d", &value) != 1)
+        {
+            value = -1;
+        }
+        fclose(topologyFile);
+    }
+
+    return value;
+}
+
+/*
+* Summary - This method will read a list of cpus, for example '0-3,8-11', from a file of CPU_TOPOLOGY_DIRECTORY.
+* Param 1 - path - the path of the file
+* Param 2 - cpus - receives the cpus of the list
+* Returns 1, if the list has atleast one cpu, else 0.
+*/
+int parseCpuList(char *path, cpu_set_t *cpus)
+{
+    // Declarations
+    FILE *listFile;
+    char cpuList[1024], *range, *savePointer;
+    int firstCpu, lastCpu, cpu;
+
+    CPU_ZERO(cpus);
+
+    listFile = fopen(path, "r");
+    if(listFile == NULL)
+    {
+        return 0;
+    }
+    if(fgets(cpuList, sizeof(cpuList), listFile) == NULL)
+    {
+        cpuList[0] = '\0';
+    }
+    fclose(listFile);
+
+    for(range = strtok_r(cpuList, ",\n", &savePointer); range != NULL; range = strtok_r(NULL, ",\n", &savePointer))
+    {
+        if(sscanf(range, "%d-%d", &firstCpu, &lastCpu) == 1)
+        {
+            lastCpu = firstCpu;
+        }
+        for(cpu = firstCpu; cpu >= 0 && cpu <= lastCpu && cpu < CPU_SETSIZE; cpu++)
+        {
+            CPU_SET(cpu, cpus);
+        }
+    }
+
+    return CPU_COUNT(cpus) > 0;
+}
+
+/*
+* Summary - This method will raise the soft limit on open file descriptors to the hard limit, when the shell starts.
+* Every child process holds DESCRIPTORS_PER_CHILD_PROCESS descriptors in the shell, so the number of child processes
+* that can be created is derived from the raised limit, keeping RESERVED_FILE_DESCRIPTORS for the shell itself.
+*/
+void raiseFileDescriptorLimit()
+{
+    // Declarations
+    struct rlimit limit;
+
+    if(getrlimit(RLIMIT_NOFILE, &inheritedFileDescriptorLimit) == -1)
+    {
+        inheritedFileDescriptorLimit.rlim_cur = inheritedFileDescriptorLimit.rlim_max = RLIM_INFINITY;
+        return;
+    }
+
+    limit = inheritedFileDescriptorLimit;
+    limit.rlim_cur = limit.rlim_max;
+    if(limit.rlim_cur != inheritedFileDescriptorLimit.rlim_cur && setrlimit(RLIMIT_NOFILE, &limit) == -1)
+    {
+        limit = inheritedFileDescriptorLimit;
+    }
+
+    if(limit.rlim_cur != RLIM_INFINITY
+    && limit.rlim_cur < RESERVED_FILE_DESCRIPTORS + (rlim_t)MAXIMUM_NUMBER_OF_CHILD_PROCESSES * DESCRIPTORS_PER_CHILD_PROCESS)
+    {
+        childProcessLimit = limit.rlim_cur > RESERVED_FILE_DESCRIPTORS
+        ? (int)((limit.rlim_cur - RESERVED_FILE_DESCRIPTORS) / DESCRIPTORS_PER_CHILD_PROCESS) : 0;
+    }
+}
+
+/*
+* Summary - This method will read the topology of the cpus the shell may run on, when the shell starts.
+* 1. The package of every cpu is read from topology/physical_package_id, and its NUMA node from the nodeN entry of its directory.
+* 2. The cpus sharing its L3 cache are read from the cache/indexN directory of level 3. If the cpu has no L3 cache, the cpus
+*    of its package are used.
+* 3. Every distinct group of cpus becomes an L3 cache domain.
+* If the topology can not be read, every cpu ends up in a single domain, and the child processes are not placed.
+*/
+void readCpuTopology()
+{
+    // Declarations
+    cpu_set_t allowedCpus, domainCpus;
+    char path[128];
+    int cpu, cacheIndex, domain, node, packageId;
+    bool domainFound, packageSeen[CPU_SETSIZE];
+    DIR *cpuDirectory;
+    struct dirent *directoryEntry;
+
+    memset(&topology, 0, sizeof(topology));
+    memset(packageSeen, 0, sizeof(packageSeen));
+    topology.numaNodeCount = 1;
+    for(cpu = 0; cpu < CPU_SETSIZE; cpu++)
+    {
+        topology.cacheDomainOfCpu[cpu] = -1;
+    }
+
+    if(sched_getaffinity(0, sizeof(allowedCpus), &allowedCpus) == -1)
+    {
+        return;
+    }
+
+    for(cpu = 0; cpu < CPU_SETSIZE; cpu++)
+    {
+        if(!CPU_ISSET(cpu, &allowedCpus))
+        {
+            continue;
+        }
+        topology.cpuCount++;
+
+        snprintf(path, sizeof(path), CPU_TOPOLOGY_DIRECTORY "/cpu%d/topology/physical_package_id", cpu);
+        packageId = readTopologyValue(path);
+        if(packageId >= 0 && packageId < CPU_SETSIZE && !packageSeen[packageId])
+        {
+            packageSeen[packageId] = true;
+            topology.packageCount++;
+        }
+
+        // Step 1 - The NUMA node, the directory of the cpu only has a nodeN entry on a kernel built with NUMA.
+        node = 0;
+        snprintf(path, sizeof(path), CPU_TOPOLOGY_DIRECTORY "/cpu%d", cpu);
+        cpuDirectory = opendir(path);
+        if(cpuDirectory != NULL)
+        {
+            while((directoryEntry = readdir(cpuDirectory)) != NULL)
+            {
+                if(sscanf(directoryEntry->d_name, "node%d", &node) == 1)
+                {
+                    break;
+                }
+            }
+            closedir(cpuDirectory);
+        }
+        if(node < 0 || node >= MAXIMUM_NUMBER_OF_NUMA_NODES)
+        {
+            node = 0;
+        }
+        topology.numaNodeOfCpu[cpu] = node;
+        if(node >= topology.numaNodeCount)
+        {
+            topology.numaNodeCount = node + 1;
+        }
+
+        // Step 2 - The cpus sharing the L3 cache, or else the package, of the cpu.
+        domainFound = false;
+        for(cacheIndex = 0; cacheIndex < 10 && !domainFound; cacheIndex++)
+        {
+            snprintf(path, sizeof(path), CPU_TOPOLOGY_DIRECTORY "/cpu%d/cache/index%d/level", cpu, cacheIndex);
+            if(readTopologyValue(path) == 3)
+            {
+                snprintf(path, sizeof(path), CPU_TOPOLOGY_DIRECTORY "/cpu%d/cache/index%d/shared_cpu_list", cpu, cacheIndex);
+                domainFound = parseCpuList(path, &domainCpus);
+            }
+        }
+        if(!domainFound)
+        {
+            snprintf(path, sizeof(path), CPU_TOPOLOGY_DIRECTORY "/cpu%d/topology/core_siblings_list", cpu);
+            if(!parseCpuList(path, &domainCpus))
+            {
+                CPU_SET(cpu, &domainCpus);
+            }
+        }
+        CPU_AND(&domainCpus, &domainCpus, &allowedCpus);
+        CPU_SET(cpu, &domainCpus);
+
+        // Step 3 - Find the domain having the same cpus, or add it. Beyond the maximum, the domains are merged into the last one.
+        for(domain = 0; domain < topology.cacheDomainCount; domain++)
+        {
+            if(CPU_EQUAL(&domainCpus, &topology.cacheDomainCpus[domain]))
+            {
+                break;
+            }
+        }
+        if(domain == MAXIMUM_NUMBER_OF_CACHE_DOMAINS)
+        {
+            domain = MAXIMUM_NUMBER_OF_CACHE_DOMAINS - 1;
+            CPU_OR(&topology.cacheDomainCpus[domain], &topology.cacheDomainCpus[domain], &domainCpus);
+        }
+        else if(domain == topology.cacheDomainCount)
+        {
+            topology.cacheDomainCpus[domain] = domainCpus;
+            topology.numaNodeOfCacheDomain[domain] = node;
+            topology.cacheDomainCount++;
+        }
+        topology.cacheDomainOfCpu[cpu] = domain;
+    }
+}
+
+/*
+* Summary - This method will pick the L3 cache domain for a new child process.
+* The members of a gang share a domain, so that they share the cache as well. Any other process is placed in the domain
+* having the fewest non-terminated processes.
+* Param 1 - gangNumber - the gang of the new child process, 0 if it is not a part of any gang
+* Returns the L3 cache domain, -1 if the topology is not known.
+*/
+int pickCacheDomain(int gangNumber)
+{
+    // Declarations
+    int counter, domain, leastLoadedDomain = 0;
+    int processesInDomain[MAXIMUM_NUMBER_OF_CACHE_DOMAINS] = {0};
+
+    if(topology.cacheDomainCount <= 1)
+    {
+        return topology.cacheDomainCount - 1;
+    }
+
+    for(counter = 0; counter < childProcessCountTracker; counter++)
+    {
+        domain = childProcesses.cacheDomain[counter];
+        if(childProcesses.state[counter] == Terminated || domain < 0)
+        {
+            continue;
+        }
+        if(gangNumber != 0 && childProcesses.gangNumber[counter] == gangNumber)
+        {
+            return domain;
+        }
+        processesInDomain[domain]++;
+    }
+
+    for(domain = 1; domain < topology.cacheDomainCount; domain++)
+    {
+        if(processesInDomain[domain] < processesInDomain[leastLoadedDomain])
+        {
+            leastLoadedDomain = domain;
+        }
+    }
+
+    return leastLoadedDomain;
+}
+
+/*
+* Summary - This method will place a newly forked child process in its L3 cache domain, before it is loaded.
+* The cpu affinity keeps the migrations of the process within the domain, and the memory policy binds its memory to the NUMA node
+* of the domain. Both are kept across exec(). On a machine having a single domain or a single node, there is nothing to place.
+* Param 1 - cacheDomain - the L3 cache domain of the process
+*/
+void placeChildProcess(int cacheDomain)
+{
+    // Declarations
+    unsigned long nodeMask[MAXIMUM_NUMBER_OF_NUMA_NODES / (8 * sizeof(unsigned long))];
+    int node, bitsPerWord = 8 * sizeof(unsigned long);
+
+    if(cacheDomain < 0)
+    {
+        return;
+    }
+
+    if(topology.cacheDomainCount > 1)
+    {
+        sched_setaffinity(0, sizeof(cpu_set_t), &topology.cacheDomainCpus[cacheDomain]);
+    }
+
+    if(topology.numaNodeCount > 1)
+    {
+        node = topology.numaNodeOfCacheDomain[cacheDomain];
+        memset(nodeMask, 0, sizeof(nodeMask));
+        nodeMask[node / bitsPerWord] |= 1UL << (node % bitsPerWord);
+        syscall(SYS_set_mempolicy, MPOL_BIND, nodeMask, MAXIMUM_NUMBER_OF_NUMA_NODES + 1);
+    }
+}
+
+/*
+* Summary - This method will find the L3 cache domain of a re-adopted process from its cpu affinity.
+* Param 1 - processId - the process id
+* Returns the L3 cache domain, -1 if the affinity of the process does not match a domain.
+*/
+int findCacheDomainOfProcess(int processId)
+{
+    // Declarations
+    cpu_set_t processCpus;
+    int domain;
+
+    if(topology.cacheDomainCount <= 1)
+    {
+        return topology.cacheDomainCount - 1;
+    }
+
+    if(sched_getaffinity(processId, sizeof(processCpus), &processCpus) == 0)
+    {
+        for(domain = 0; domain < topology.cacheDomainCount; domain++)
+        {
+            if(CPU_EQUAL(&processCpus, &topology.cacheDomainCpus[domain]))
+            {
+                return domain;
+            }
+        }
+    }
+
+    return -1;
+}
+
+/*
+* Summary - This method will read the cpu on which a process last ran from /proc/<pid>/stat.
+* Param 1 - processId - the process id
+* Returns the cpu, -1 if the process does not exist.
+*/
+int readProcessCpu(int processId)
+{
+    // Declarations
+    char statPath[64], statLine[1024], *fields, *field, *savePointer;
+    int fieldNumber, cpu = -1;
+    FILE *statFile;
+
+    snprintf(statPath, sizeof(statPath), "/proc/%d/stat", processId);
+    statFile = fopen(statPath, "r");
+    if(statFile == NULL)
+    {
+        return -1;
+    }
+
+    // The cpu is the 39th field, the fields are counted from the last ')' as the process name may contain spaces.
+    if(fgets(statLine, sizeof(statLine), statFile) != NULL && (fields = strrchr(statLine, ')')) != NULL)
+    {
+        for(fieldNumber = 3, field = strtok_r(fields + 1, " ", &savePointer); field != NULL; fieldNumber++, field = strtok_r(NULL, " ", &savePointer))
+        {
+            if(fieldNumber == 39)
+            {
+                cpu = atoi(field);
+                break;
+            }
+        }
+    }
+    fclose(statFile);
+
+    return cpu;
+}
+
+/*
+* Summary - This method will sample the cpu of every running process, and count its migrations since the previous sample,
+* by whether they stayed within the L3 cache domain, crossed to another domain, or crossed to another NUMA node.
+* The migrations are sampled every METRICS_EXPORT_INTERVAL_IN_MILLISECS, so a process moving back and forth between
+* two samples is not counted.
+*/
+void sampleProcessPlacement()
+{
+    // Declarations
+    int processNumber, cpu, lastCpu;
+
+    for(processNumber = findNextProcessInState(Running, 0); processNumber != -1; processNumber = findNextProcessInState(Running, processNumber + 1))
+    {
+        cpu = readProcessCpu(childProcesses.processId[processNumber]);
+        if(cpu < 0 || cpu >= CPU_SETSIZE)
+        {
+            continue;
+        }
+
+        lastCpu = childProcesses.lastCpu[processNumber];
+        if(lastCpu != -1 && lastCpu != cpu)
+        {
+            if(topology.numaNodeOfCpu[lastCpu] != topology.numaNodeOfCpu[cpu])
+            {
+                __atomic_add_fetch(&metrics.crossNodeMigrationCount, 1, __ATOMIC_RELAXED);
+            }
+            else if(topology.cacheDomainOfCpu[lastCpu] != topology.cacheDomainOfCpu[cpu])
+            {
+                __atomic_add_fetch(&metrics.crossCacheDomainMigrationCount, 1, __ATOMIC_RELAXED);
+            }
+            else
+            {
+                __atomic_add_fetch(&metrics.migrationCount, 1, __ATOMIC_RELAXED);
+            }
+        }
+        childProcesses.lastCpu[processNumber] = cpu;
+    }
+}
+
+/*
+* Summary - This method will map the control page of a child process into the shell.
+* Param 1 - controlPageDescriptor - file descriptor of the memfd holding the control page
+* Returns the control page, or NULL if it could not be mapped.
+*/
+struct controlPage *mapControlPage(int controlPageDescriptor)
+{
+    // Declarations
+    struct controlPage *control;
+
+    control = mmap(NULL, sizeof(struct controlPage), PROT_READ | PROT_WRITE, MAP_SHARED, controlPageDescriptor, 0);
+
+    return control == MAP_FAILED ? NULL : control;
+}
+
+/*
+* Summary - This method will wake up the child processes that have yielded the cpu, or were asked to, before they are continued.
+* The control page is shared through a file, so the futex can not be a private futex.
+* Param 1 - processNumbers - the process identifiers
+* Param 2 - processCount - number of entries in processNumbers
+*/
+void releaseYieldedProcesses(int *processNumbers, int processCount)
+{
+    // Declarations
+    int counter;
+    struct controlPage *control;
+
+    for(counter = 0; counter < processCount; counter++)
+    {
+        control = childProcesses.controlPage[processNumbers[counter]];
+        if(control != NULL && __atomic_exchange_n(&control->yieldState, YieldNone, __ATOMIC_ACQ_REL) != YieldNone)
+        {
+            syscall(SYS_futex, &control->yieldState, FUTEX_WAKE, INT32_MAX, NULL, NULL, 0);
+        }
+    }
+}
+
+/*
+* Summary - This method will ask a running child process to yield the cpu ('y #' command), through its control page.
+* The process acknowledges the request by parking itself on the futex of the page, so no signal is needed to stop it.
+* If the process is run by round robin, its time slice ends right away and the next process is run.
+* If it is run with 'r #', it is suspended till it is resumed again.
+* The alarm is blocked while waiting for the acknowledgement, so that the process is not preempted meanwhile.
+* Param 1 - cmdArguments - command line arguments
+* Returns 1, after a flawless execution
+*/
+int yieldChildProcess(char **cmdArguments)
+{
+    if(cmdArguments[1] != NULL && cmdArguments[2] == NULL)
+    {
+        // Declarations
+        int argDataLength = strlen(cmdArguments[1]);
+        int argCount, processNumber, yieldState = YieldNone;
+        long long deadlineInMicros, remainingInMicros;
+        struct controlPage *control;
+        struct timespec waitTime;
+        sigset_t previousSignals;
+
+        for(argCount = 0; argCount < argDataLength; argCount ++)
+        {
+            if(isdigit(cmdArguments[1][argCount]) == 0)
+            {
+                goto PrintError;
+            }
+        }
+
+        processNumber = atoi(cmdArguments[1]);
+        if(processNumber >= childProcessCountTracker || childProcesses.processAdded[processNumber] == 0)
+        {
+            goto PrintError;
+        }
+
+        control = childProcesses.controlPage[processNumber];
+        if(childProcesses.state[processNumber] != Running || control == NULL)
+        {
+            printf("The process with number %d is not running, or it does not have a control page.\n", processNumber);
+            return 1;
+        }
+
+        if(runningOneProcess == 0 && strcmp(schedulingAlgo, "fcfs") == 0)
+        {
+            printf("A process run by FCFS keeps the cpu till it completes its burst, so it can not yield.\n");
+            return 1;
+        }
+
+        if(runningOneProcess == 0 && findNextSchedulableProcess(0, childProcessCountTracker) == -1)
+        {
+            printf("There is no other process to run, so the process with number %d keeps the cpu.\n", processNumber);
+            return 1;
+        }
+
+        blockSchedulerSignals(&previousSignals);
+
+        __atomic_compare_exchange_n(&control->yieldState, &yieldState, YieldRequested, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+        syscall(SYS_futex, &control->yieldState, FUTEX_WAKE, INT32_MAX, NULL, NULL, 0);
+
+        deadlineInMicros = getMonotonicTimeInMicros() + YIELD_TIMEOUT_IN_MILLISECS * 1000LL;
+        while(__atomic_load_n(&control->yieldState, __ATOMIC_ACQUIRE) == YieldRequested
+        && (remainingInMicros = deadlineInMicros - getMonotonicTimeInMicros()) > 0)
+        {
+            waitTime.tv_sec = remainingInMicros / 1000000;
+            waitTime.tv_nsec = (remainingInMicros % 1000000) * 1000;
+            syscall(SYS_futex, &control->yieldState, FUTEX_WAIT, YieldRequested, &waitTime, NULL, 0);
+        }
+
+        // Withdraw the request, unless the process has yielded in the meantime.
+        yieldState = YieldRequested;
+        if(__atomic_compare_exchange_n(&control->yieldState, &yieldState, YieldNone, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+        {
+            unblockSchedulerSignals(&previousSignals);
+            printf("The process with number %d did not yield the cpu within %d ms.\n", processNumber, YIELD_TIMEOUT_IN_MILLISECS);
+            return 1;
+        }
+
+        logSchedulerEvent(LogInfo, "\033[0;35m", "Child %d yielded the cpu\n", childProcesses.processId[processNumber]);
+        if(runningOneProcess == 0)
+        {
+            // The yield is not a timer that expired, so its overshoot is not measured.
+            metrics.timerDeadlineInMicros = 0;
+            ualarm(1, 0);
+        }
+        else
+        {
+            logSchedulerEvent(LogInfo, "\033[0;35m", "Child %d -> Running -> Suspended\n", childProcesses.processId[processNumber]);
+            setProcessState(processNumber, Suspended);
+        }
+
+        unblockSchedulerSignals(&previousSignals);
+        return 1;
+    }
+
+    PrintError: puts("The entered process number appears to be incorrect.\n"
+    "Please use the 'l' command to display child processes information.\n");
+
+    return 1;
+}
+
+/*
+* Summary - This method will start replaying a trace ('replay trace.csv [Nx]'), end the replay ('replay stop'), or display
+* its progress ('replay'). The jobs of the trace are created by advanceTraceReplay, which is called from the input loop.
+* Param 1 - cmdArguments - command line arguments
+* Returns 1, after a flawless execution
+*/
+int replayTrace(char **cmdArguments)
+{
+    // Declarations
+    int speedup = 1;
+    char *speedupEnd;
+    long long nextArrivalInMicros;
+    FILE *traceFile;
+
+    if(cmdArguments[1] == NULL)
+    {
+        if(!replay.active)
+        {
+            printf("No trace is being replayed.\n");
+            return 1;
+        }
+
+        printf("Replaying %s at %dx for %.1f secs: %d jobs arrived, %d completed, %d lines skipped.\n", replay.tracePath,
+        replay.speedup, (getMonotonicTimeInMicros() - replay.startTimeInMicros) / 1000000.0, replay.arrivedCount,
+        replay.completedCount, replay.skippedCount);
+        if(replay.traceFile != NULL)
+        {
+            nextArrivalInMicros = replay.nextJob.arrivalTimeInMicros - getMonotonicTimeInMicros();
+            printf("The next job '%s' arrives in %.1f secs.\n", replay.nextJobName,
+            nextArrivalInMicros > 0 ? nextArrivalInMicros / 1000000.0 : 0.0);
+        }
+        else
+        {
+            printf("All the jobs of the trace have arrived. The replay finishes once they have exited.\n");
+        }
+        return 1;
+    }
+
+    if(strcmp(cmdArguments[1], "stop") == 0 && cmdArguments[2] == NULL)
+    {
+        if(!replay.active)
+        {
+            printf("No trace is being replayed.\n");
+            return 1;
+        }
+
+        // The jobs that have arrived keep running, only the jobs yet to arrive are dropped.
+        finishTraceReplay("was stopped");
+        return 1;
+    }
+
+    if(cmdArguments[2] != NULL)
+    {
+        speedup = strtol(cmdArguments[2], &speedupEnd, 10);
+        if(!isdigit(cmdArguments[2][0]) || (*speedupEnd != '\0' && strcmp(speedupEnd, "x") != 0)
+        || speedup < 1 || speedup > MAXIMUM_REPLAY_SPEEDUP || cmdArguments[3] != NULL)
+        {
+            goto PrintError;
+        }
+    }
+
+    if(replay.active)
+    {
+        printf("The trace %s is already being replayed. Please enter 'replay stop' to end it first.\n", replay.tracePath);
+        return 1;
+    }
+
+    // The jobs are run by the scheduler as they arrive, like after 'r all', so it has to be configured first.
+    if(strcmp(schedulingAlgo, "") == 0)
+    {
+        printf("Please set the scheduling algorithm first in order to replay a trace.\n");
+        return 1;
+    }
+
+    if(strcmp(schedulingAlgo, "rr") == 0 && roundRobinQuantumTimeInMillis <= 0)
+    {
+        printf("Please set the quantum time for executing processes utilizing round robin scheduling.\n");
+        return 1;
+    }
+
+    traceFile = fopen(cmdArguments[1], "r");
+    if(traceFile == NULL)
+    {
+        printf("The trace %s could not be opened: %s\n", cmdArguments[1], strerror(errno));
+        return 1;
+    }
+
+    memset(&replay, 0, sizeof(replay));
+    replay.turnaroundHistogram.name = "Job turnaround";
+    replay.traceFile = traceFile;
+    snprintf(replay.tracePath, sizeof(replay.tracePath), "%s", cmdArguments[1]);
+    replay.speedup = speedup;
+    replay.startTimeInMicros = getMonotonicTimeInMicros();
+
+    if(!readNextTraceJob())
+    {
+        printf("The trace %s does not have any jobs.\n"
+        "Please enter one job per line as arrival_secs,command,cpu_secs,rss_mb.\n", replay.tracePath);
+        return 1;
+    }
+
+    replay.active = true;
+    printf("Replaying %s at %dx using %s.\n", replay.tracePath, replay.speedup, strcmp(schedulingAlgo, "rr") == 0 ? "Round Robin" : "FCFS");
+
+    return 1;
+
+    PrintError: puts("The entered speedup appears to be incorrect.\n"
+    "Please enter the path of the trace, optionally followed by a speedup like 10x, of atmost 1000x.\n"
+    "If needed, use the 'help' command to see the command list.\n");
+
+    return 1;
+}
+
+/*
+* Summary - This method will parse a line of a trace, given as arrival_secs,command,cpu_secs,rss_mb. The command may be quoted,
+* the rss may be left out, and any further columns are ignored. The arrival offset and the cpu time are compressed by the speedup.
+* Param 1 - line - the line
+* Param 2 - job - receives the workload of the job
+* Param 3 - jobName - receives the command of the job, cut to MAXIMUM_TRACE_JOB_NAME_LENGTH - 1 characters
+* Returns 1 if the line holds a job, -1 if it is blank, a comment or the header of the trace, else 0.
+*/
+int parseTraceLine(char *line, struct jobWorkload *job, char *jobName)
+{
+    // Declarations
+    char *field, *fieldEnd, *nameEnd;
+    double arrivalTimeInSecs, cpuTimeInSecs, memoryInMB = 0;
+
+    field = line + strspn(line, " \t");
+    if(*field == '\0' || *field == '\r' || *field == '\n' || *field == '#')
+    {
+        return -1;
+    }
+
+    // The first line may name the columns, instead of holding a job.
+    arrivalTimeInSecs = strtod(field, &fieldEnd);
+    if(fieldEnd == field)
+    {
+        return replay.lineNumber == 1 ? -1 : 0;
+    }
+    fieldEnd += strspn(fieldEnd, " \t");
+    if(*fieldEnd != ',' || !(arrivalTimeInSecs >= 0 && arrivalTimeInSecs <= INT_MAX))
+    {
+        return 0;
+    }
+
+    // The command is quoted, if it holds a comma.
+    field = fieldEnd + 1;
+    field += strspn(field, " \t");
+    if(*field == '"')
+    {
+        field++;
+        nameEnd = strchr(field, '"');
+        if(nameEnd == NULL)
+        {
+            return 0;
+        }
+        fieldEnd = nameEnd + 1;
+        fieldEnd += strspn(fieldEnd, " \t");
+    }
+    else
+    {
+        nameEnd = fieldEnd = field + strcspn(field, ",\r\n");
+        while(nameEnd > field && isspace(nameEnd[-1]))
+        {
+            nameEnd--;
+        }
+    }
+    if(*fieldEnd != ',')
+    {
+        return 0;
+    }
+    snprintf(jobName, MAXIMUM_TRACE_JOB_NAME_LENGTH, "%.*s", (int) (nameEnd - field), field);
+
+    field = fieldEnd + 1;
+    cpuTimeInSecs = strtod(field, &fieldEnd);
+    if(fieldEnd == field || !(cpuTimeInSecs > 0 && cpuTimeInSecs <= INT_MAX))
+    {
+        return 0;
+    }
+    fieldEnd += strspn(fieldEnd, " \t");
+
+    if(*fieldEnd == ',')
+    {
+        field = fieldEnd + 1;
+        memoryInMB = strtod(field, &fieldEnd);
+        if(!(memoryInMB >= 0 && memoryInMB <= INT_MAX))
+        {
+            return 0;
+        }
+        fieldEnd += strspn(fieldEnd, " \t");
+    }
+    if(*fieldEnd != '\0' && *fieldEnd != '\r' && *fieldEnd != '\n' && *fieldEnd != ',')
+    {
+        return 0;
+    }
+
+    job->arrivalTimeInMicros = replay.startTimeInMicros + (long long) (arrivalTimeInSecs * 1000000 / replay.speedup);
+    job->cpuTimeInMillis = (long long) (cpuTimeInSecs * 1000 / replay.speedup);
+    if(job->cpuTimeInMillis < 1)
+    {
+        job->cpuTimeInMillis = 1;
+    }
+    job->memoryInMB = (long) (memoryInMB + 0.5);
+
+    return 1;
+}
+
+/*
+* Summary - This method will read the next job of the trace being replayed into replay.nextJob, skipping the lines that can not
+* be parsed. Once the trace has ended, it is closed.
+* Returns 1, if a job has been read, else 0.
+*/
+int readNextTraceJob()
+{
+    // Declarations
+    char line[MAXIMUM_TRACE_LINE_LENGTH];
+    int lineStatus, character;
+
+    while(fgets(line, sizeof(line), replay.traceFile) != NULL)
+    {
+        replay.lineNumber++;
+
+        // A line longer than the buffer does not hold a job, so it is skipped as a whole.
+        if(strchr(line, '\n') == NULL && !feof(replay.traceFile))
+        {
+            while((character = fgetc(replay.traceFile)) != EOF && character != '\n');
+            lineStatus = 0;
+        }
+        else
+        {
+            lineStatus = parseTraceLine(line, &replay.nextJob, replay.nextJobName);
+        }
+
+        if(lineStatus == 1)
+        {
+            return 1;
+        }
+        if(lineStatus == 0)
+        {
+            replay.skippedCount++;
+            logSchedulerEvent(LogWarning, "\033[0;31m", "\nLine %d of the trace %s appears to be incorrect, and is skipped.\n",
+            replay.lineNumber, replay.tracePath);
+        }
+    }
+
+    fclose(replay.traceFile);
+    replay.traceFile = NULL;
+
+    return 0;
+}
+
+/*
+* Summary - This method will create the child processes of the jobs that have arrived, and will finish the replay once all
+* its jobs have exited. It is called from the input loop.
+* A job that arrives late, as its line is out of order or the shell was busy, is created right away.
+* Returns the time in millisecs till the next job arrives, -1 if no job is left to arrive.
+*/
+int advanceTraceReplay()
+{
+    // Declarations
+    struct resourceLimits limits = {0, 0, 0};
+    int counter, arrivedCount = 0;
+
+    if(!replay.active)
+    {
+        return -1;
+    }
+
+    while(replay.traceFile != NULL && replay.nextJob.arrivalTimeInMicros <= getMonotonicTimeInMicros())
+    {
+        logSchedulerEvent(LogInfo, "\033[0;36m", "\nJob '%s' from line %d of the trace has arrived.\n", replay.nextJobName, replay.lineNumber);
+        forkParentProcess(1, 0, &limits, &replay.nextJob);
+        replay.arrivedCount++;
+        arrivedCount++;
+        readNextTraceJob();
+    }
+
+    if(arrivedCount > 0)
+    {
+        dispatchArrivedJobs();
+    }
+
+    if(replay.traceFile != NULL)
+    {
+        return (replay.nextJob.arrivalTimeInMicros - getMonotonicTimeInMicros() + 999) / 1000;
+    }
+
+    // All the jobs have arrived, so the replay is finished once none of them is alive or waiting for memory.
+    // The jobs of an earlier replay arrived before this one started, so they are not waited for.
+    for(counter = 0; counter < queuedCreationCount; counter++)
+    {
+        if(queuedCreations[counter].workload.arrivalTimeInMicros >= replay.startTimeInMicros)
+        {
+            return -1;
+        }
+    }
+
+    for(counter = 0; counter < childProcessCountTracker; counter++)
+    {
+        if(childProcesses.arrivalTimeInMicros[counter] >= replay.startTimeInMicros && childProcesses.state[counter] != Terminated)
         {
-            roundRobinQuantumTimeInSecs = timeInSecs;
-            printf("The value of quantum time is set to %d secs.\n", roundRobinQuantumTimeInSecs);
-            return 1;
+            return -1;
         }
     }
 
-    // Invalid quantum time is entered by the user. Display the error and proceed the execution.
-    PrintError:printf("The entered quantum time appears to be incorrect.\nPlease set the quantum time to atleast 1 sec and no longer than %d secs.\nIf needed, use the 'help' command to see the command list.\n", MAXIMUM_ROUND_ROBIN_QUANTUM_TIME_IN_SECS);
+    finishTraceReplay("has finished");
 
-    return 1;
+    return -1;
 }
 
 /*
-* Summary - This method will be used to set the burst time that will be used by FCFS scheduling algorithm.
-* Param 1 - cmdArguments - command line arguments
-* Returns 1, after a flawless execution
+* Summary - This method will start the scheduler on the jobs that have arrived, if no process is running. Otherwise the jobs
+* wait to be picked by the scheduler, like any other suspended process.
 */
-int setBurstTimeForFCFS(char **cmdArguments)
+void dispatchArrivedJobs()
 {
-    if(cmdArguments[1] != NULL && cmdArguments[2] == NULL)
-    {
-        // Declarations
-        int argDataLength = strlen(cmdArguments[1]);
-        int argCount, loopCounter;
-
-        for(argCount = 0; argCount < argDataLength; argCount ++)
-        {
-            if(isdigit(cmdArguments[1][argCount]) == 0)
-            {
-                goto PrintError;
-            }
-        }
-
-        if(isProcessRunning() == 0)
-        {
-            printf("There is an ongoing process execution. Please stop that first and then set the burst time.\n");
-            return 1;
-        }
+    // Declarations
+    int processNumber;
+    sigset_t previousSignals;
 
-        int timeInSecs = atoi(cmdArguments[1]);
+    blockSchedulerSignals(&previousSignals);
 
-        if(timeInSecs >= MINIMUM_FCFS_BURST_TIME_IN_SECS)
-        {
-            fcfsBurstTimeInSecs = timeInSecs;
-            printf("The value of burst time is set to %d secs.\n", fcfsBurstTimeInSecs);
-            return 1;
-        }
+    // If a process has just exited, the alarm handler is about to start the next process, so it is left to it.
+    processNumber = findNextSchedulableProcess(0, childProcessCountTracker);
+    if(processNumber != -1 && countRunningProcesses() == 0 && terminatedChildProcess == 0)
+    {
+        // runningOneProcess is 0, as the scheduler runs all the processes, like after the 'r all' command
+        runningOneProcess = 0;
+        runChildProcessUsingSchedulingAlgo(processNumber);
     }
 
-    // Invalid burst time is entered by the user. Display the error and proceed the execution.
-    PrintError:printf("The entered burst time appears to be incorrect.\nPlease set the burst time to atleast %d secs.\nIf needed, use the 'help' command to see the command list.\n", MINIMUM_FCFS_BURST_TIME_IN_SECS);
-
-    return 1;
+    unblockSchedulerSignals(&previousSignals);
 }
 
 /*
-* Summary - This method will be used to set the scheduling algorithm.
-* 1.FCFS - First Come First Serve
-* 2.RR - Round Robin
-* Param 1 - cmdArguments - command line arguments
-* Returns 1, after a flawless execution
-* Answer to question 6 & 7 (t rr, t fcfs)
+* Summary - This method will record the turnaround time and the slowdown of a job of the trace being replayed, once it has
+* exited after burning its cpu time. The slowdown is the turnaround time divided by the cpu time, 1 if the job never waited.
+* Param 1 - processNumber - the child process
 */
-int setSchedulingAlgorithm(char **cmdArguments)
+void recordReplayedJobCompletion(int processNumber)
 {
     // Declarations
-    char *schedulingAlgorithms[] = {"fcfs", "rr"};
-    int algoLength = sizeof(schedulingAlgorithms) / sizeof(char*);
-    int countOfAlgo;
+    long long turnaroundTimeInMicros;
 
-    if(cmdArguments[1] != NULL && cmdArguments[2] == NULL)
+    if(!replay.active || childProcesses.arrivalTimeInMicros[processNumber] < replay.startTimeInMicros
+    || childProcesses.cpuDemandInMillis[processNumber] == 0)
     {
-        for(countOfAlgo = 0; countOfAlgo < algoLength; countOfAlgo++)
-        {
-            if (strcmp(cmdArguments[1], schedulingAlgorithms[countOfAlgo]) == 0)
-            {
-                if(isProcessRunning() == 0)
-                {
-                    printf("Cant set a new algorithm, as the process is already running.\n");
-                    return 1;
-                }
+        return;
+    }
 
-                // Reset the data
-                terminatedChildProcess = 0;
+    turnaroundTimeInMicros = getMonotonicTimeInMicros() - childProcesses.arrivalTimeInMicros[processNumber];
+    recordLatency(&replay.turnaroundHistogram, turnaroundTimeInMicros);
+    replay.totalSlowdown += turnaroundTimeInMicros / (childProcesses.cpuDemandInMillis[processNumber] * 1000.0);
+    replay.completedCount++;
+}
 
-                strcpy(schedulingAlgo, cmdArguments[1]);
-                printf("The algorithm for process scheduling is set to %s.\n", schedulingAlgo);
-                return 1;
-            }
-        }
+/*
+* Summary - This method will end the replay, and display the turnaround times and the mean slowdown of the completed jobs,
+* so that the scheduling algorithms can be compared on the same trace. The summary is displayed with --quiet as well.
+* Param 1 - reason - how the replay ended
+*/
+void finishTraceReplay(const char *reason)
+{
+    // Declarations
+    struct latencyHistogram *histogram = &replay.turnaroundHistogram;
+
+    if(replay.traceFile != NULL)
+    {
+        fclose(replay.traceFile);
+        replay.traceFile = NULL;
     }
+    replay.active = false;
 
-    // Invalid name of the algorithm is entered by the user. Display list of available algorithms & commands and proceed the execution.
-    puts("The algorithm you entered appears to be incorrect.\n"
-    "Round robin and fcfs are currently supported.\n"
-    "If needed, use the 'help' command to see the command list.\n");
+    logSchedulerEvent(LogWarning, "\033[0;36m", "\nThe replay of %s at %dx using %s %s after %.1f secs.\n", replay.tracePath,
+    replay.speedup, strcmp(schedulingAlgo, "rr") == 0 ? "Round Robin" : "FCFS", reason,
+    (getMonotonicTimeInMicros() - replay.startTimeInMicros) / 1000000.0);
+    logSchedulerEvent(LogWarning, "\033[0;36m", "%d of %d jobs completed, %d lines skipped.\n", replay.completedCount,
+    replay.arrivedCount, replay.skippedCount);
 
-    return 1;
+    if(histogram->totalCount > 0)
+    {
+        logSchedulerEvent(LogWarning, "\033[0;36m", "Turnaround (ms): p50 %lld, p90 %lld, p99 %lld, max %lld. Mean slowdown %.2f.\n",
+        getLatencyPercentile(histogram, 50) / 1000, getLatencyPercentile(histogram, 90) / 1000,
+        getLatencyPercentile(histogram, 99) / 1000, histogram->maximumInMicros / 1000, replay.totalSlowdown / replay.completedCount);
+    }
 }
 
 /*
@@ -1022,17 +5751,16 @@ int setSchedulingAlgorithm(char **cmdArguments)
 */
 int isProcessRunning()
 {
-    int processInfoCounter;
-
-    for(processInfoCounter = 0; processInfoCounter < childProcessCountTracker; processInfoCounter++)
-    {
-        if(childProcesses[processInfoCounter].state == Running)
-        {
-            return 0;
-        }
-    }
+    return findNextProcessInState(Running, 0) == -1 ? 1 : 0;
+}
 
-    return 1;
+/*
+* Summary - This method will count the child processes that are running in the background.
+* Returns the number of running processes.
+*/
+int countRunningProcesses()
+{
+    return countProcessesInState(Running);
 }
 
 /*
@@ -1046,17 +5774,33 @@ int supportedCommandsMessage(char **cmdArguments)
     {
         puts("List of available commands:"
         "\n>c #: Create # child processes."
+        "\n>c # name: Create # child processes as a gang called name, that is scheduled as a single unit."
+        "\n>c # [name] as=MB nofile=# cpu=secs: Create # child processes with limits of their address space, open files and cpu time."
         "\n>l: Display the child process information."
+        "\n>l state: Display the child processes in the given state (running, ready, suspended or terminated)."
+        "\n>l --state=state --sort=number|pid|state|cpu|iterations --top=# --page=#: Filter, sort and page the child processes."
+        "\n>l --watch[=secs]: Redraw the rows that changed every secs (1 by default), till Enter is pressed."
+        "\n>l --json: Display the child process information as JSON."
         "\n>q #: Set the quantum time to be # secs."
-        "\n>b #: Set the burst time to be # secs for FCFS."
+        "\n>q #ms: Set the quantum time to be # milliseconds."
+        "\n>q auto: Tune the quantum time of every process on the basis of its observed behavior."
+        "\n>b #: Set the burst time to be # secs of cpu time for FCFS."
         "\n>t rr: Set the scheduling algorithm to be round robin."
         "\n>t fcfs: Set the scheduling algorithm to be first come first serve."
         "\n>k #: Terminate the process, having the process number #."
         "\n>r #: Resume the process, having the process number #."
         "\n>r all: Resume to run all the processes in ready / suspended state."
         "\n>s all: Suspend all the processes."
+        "\n>k, r and s also accept a selection of processes, for example 'k 10-500', 's 1,4,9' or 'r group:name'."
 		"\n>x or X: Exit the shell & all child processes."
-        "\n>clear: Clear the console.");
+        "\n>clear: Clear the console."
+        "\n>stats: Display the scheduler statistics."
+        "\n>m #: Set the memory budget of the child processes to be # MB (0 removes the budget)."
+        "\n>tail #: Display the recent output of the process, having the process number #."
+        "\n>lat: Display the latency histograms of the scheduler, 'lat reset' clears them."
+        "\n>y #: Ask the running process, having the process number #, to yield the cpu."
+        "\n>replay trace.csv [Nx]: Replay the jobs of a trace (arrival_secs,command,cpu_secs,rss_mb), N times faster."
+        "\n>replay: Display the progress of the replay, 'replay stop' ends it.");
     }
     else
     {
@@ -1146,8 +5890,173 @@ char** extractArguments(char *inputLine)
     return arguments;
 }
 
+/*
+* Summary - This method will switch the color of the terminal output, unless the colors are turned off with --no-color.
+* Param 1 - color - ANSI escape sequence of the color
+*/
+void setOutputColor(const char *color)
+{
+    if(colorEnabled)
+    {
+        fputs(color, stdout);
+    }
+}
+
+/*
+* Summary - This method will queue a scheduler message, to be displayed by the input loop.
+* It is safe to call from the signal handlers, as it neither locks nor uses stdio. The position in the queue is reserved
+* with a compare and swap, so a signal handler interrupting another call gets its own entry. If the queue is full, the message is dropped
+* and counted, instead of the scheduler waiting for the terminal.
+* Param 1 - level - the log level of the message, it is dropped if the level is above the configured log level
+* Param 2 - color - ANSI escape sequence of the color, NULL for the default color
+* Param 3 - format - printf style format of the message
+*/
+void logSchedulerEvent(enum logLevels level, const char *color, const char *format, ...)
+{
+    // Declarations
+    unsigned long position;
+    struct logQueueEntry *entry;
+    int length = 0, available;
+    va_list arguments;
+
+    if(level > logLevel)
+    {
+        return;
+    }
+
+    position = __atomic_load_n(&logQueueHead, __ATOMIC_ACQUIRE);
+    do
+    {
+        if(position - __atomic_load_n(&logQueueTail, __ATOMIC_ACQUIRE) >= LOG_QUEUE_SIZE)
+        {
+            __atomic_add_fetch(&droppedLogMessages, 1, __ATOMIC_RELAXED);
+            return;
+        }
+    } while(!__atomic_compare_exchange_n(&logQueueHead, &position, position + 1, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE));
+
+    entry = &logQueue[position % LOG_QUEUE_SIZE];
+
+    // Leave room for the color reset at the end of the message.
+    available = MAXIMUM_LOG_MESSAGE_LENGTH - 4;
+    if(colorEnabled && color != NULL)
+    {
+        length = snprintf(entry->message, available, "%s", color);
+    }
+
+    va_start(arguments, format);
+    length += vsnprintf(entry->message + length, available - length, format, arguments);
+    va_end(arguments);
+
+    if(length > available - 1)
+    {
+        length = available - 1;
+    }
+
+    if(colorEnabled && color != NULL)
+    {
+        memcpy(entry->message + length, "\033[0m", 4);
+        length += 4;
+    }
+
+    entry->length = length;
+    __atomic_store_n(&entry->sequence, position + 1, __ATOMIC_RELEASE);
+}
+
+/*
+* Summary - This method will display the queued scheduler messages.
+* The published messages are written with one writev() per batch, after the pending stdio output, so that the order is kept.
+* Returns the number of messages that were displayed
+*/
+int flushLogQueue()
+{
+    // Declarations
+    struct iovec batch[LOG_QUEUE_SIZE];
+    unsigned long tail = __atomic_load_n(&logQueueTail, __ATOMIC_ACQUIRE);
+    unsigned long dropped;
+    int batchCount, firstPending, messageCount = 0;
+    ssize_t bytesWritten;
+    char droppedMessage[64];
+
+    fflush(stdout);
+
+    while(1)
+    {
+        batchCount = 0;
+        while(batchCount < LOG_QUEUE_SIZE
+        && __atomic_load_n(&logQueue[(tail + batchCount) % LOG_QUEUE_SIZE].sequence, __ATOMIC_ACQUIRE) == tail + batchCount + 1)
+        {
+            batch[batchCount].iov_base = logQueue[(tail + batchCount) % LOG_QUEUE_SIZE].message;
+            batch[batchCount].iov_len = logQueue[(tail + batchCount) % LOG_QUEUE_SIZE].length;
+            batchCount++;
+        }
+
+        if(batchCount == 0)
+        {
+            break;
+        }
+
+        // Write the batch, continuing after a partial write.
+        firstPending = 0;
+        while(firstPending < batchCount)
+        {
+            bytesWritten = writev(STDOUT_FILENO, batch + firstPending, batchCount - firstPending);
+            if(bytesWritten < 0)
+            {
+                if(errno == EINTR)
+                {
+                    continue;
+                }
+                break;
+            }
+            while(firstPending < batchCount && (size_t) bytesWritten >= batch[firstPending].iov_len)
+            {
+                bytesWritten -= batch[firstPending].iov_len;
+                firstPending++;
+            }
+            if(firstPending < batchCount)
+            {
+                batch[firstPending].iov_base = (char *) batch[firstPending].iov_base + bytesWritten;
+                batch[firstPending].iov_len -= bytesWritten;
+            }
+        }
+
+        tail += batchCount;
+        __atomic_store_n(&logQueueTail, tail, __ATOMIC_RELEASE);
+        messageCount += batchCount;
+    }
+
+    dropped = __atomic_exchange_n(&droppedLogMessages, 0, __ATOMIC_RELAXED);
+    if(dropped > 0)
+    {
+        write(STDOUT_FILENO, droppedMessage, snprintf(droppedMessage, sizeof(droppedMessage),
+        "(%lu scheduler messages were dropped)\n", dropped));
+        messageCount++;
+    }
+
+    return messageCount;
+}
+
+/*
+* Summary - This method will print the shell prompt.
+* The queued scheduler messages are displayed first.
+*/
+void printPrompt()
+{
+    flushLogQueue();
+
+    setOutputColor("\033[0;33m");
+    printf("shell 5500>>> ");
+    setOutputColor("\033[0m");
+
+    setOutputColor("\033[0;36m");
+    fflush(stdout);
+}
+
 /*
 * Summary - This method will capture the command and will process it.
+* The shell waits on the standard input and the output pipes of all the child processes together, so that
+* the output of the child processes is drained into their log files while the user is typing.
+* The pidfds of the re-adopted processes are waited on as well, as they become readable when the process exits.
 * 1. Take input from the user
 * 2. Extract the arguments from the given input
 * 3. Execute the requested command
@@ -1159,50 +6068,232 @@ void captureAndProcessInput(void)
     size_t inputLength = 0;
     int cmdExecutionStatus = 1;
     char buf[100];
+    struct pollfd pollDescriptors[MAXIMUM_NUMBER_OF_CHILD_PROCESSES + 2];
+    int pollProcessNumbers[MAXIMUM_NUMBER_OF_CHILD_PROCESSES + 2];
+    int counter, descriptorCount, readyCount, pollTimeout, replayWaitInMillis;
+    ssize_t bytesRead;
+
+    printPrompt();
 
     while(cmdExecutionStatus)
     {
-        printf("\033[0;33m");
-        printf("shell 5500>>> ");
-        printf("\033[0m");
+        // Keep the child processes within the memory budget, and create the ones waiting for memory, if it has been freed.
+        relieveMemoryPressure();
+        admitQueuedChildProcesses();
+
+        // Create the jobs of the replayed trace that have arrived, and wake up in time for the next one.
+        pollTimeout = memoryBudgetInKB > 0 ? MEMORY_SAMPLING_INTERVAL_IN_MILLISECS : METRICS_EXPORT_INTERVAL_IN_MILLISECS;
+        replayWaitInMillis = advanceTraceReplay();
+        if(replayWaitInMillis >= 0 && replayWaitInMillis < pollTimeout)
+        {
+            pollTimeout = replayWaitInMillis;
+        }
+        if(flushLogQueue() > 0)
+        {
+            printPrompt();
+        }
+
+        if(journalRecordCount >= JOURNAL_RECORDS_PER_SNAPSHOT)
+        {
+            writeStateSnapshot();
+        }
+
+        // Tune the quantum times on the basis of the time slices the alarm handler has switched since the last iteration.
+        readPendingTimeSliceStats();
+
+        if(getMonotonicTimeInMicros() - lastMetricsExportTimeInMicros >= METRICS_EXPORT_INTERVAL_IN_MILLISECS * 1000LL)
+        {
+            sampleProcessPlacement();
+            exportSchedulerMetrics();
+        }
+
+        pollDescriptors[0].fd = STDIN_FILENO;
+        pollDescriptors[0].events = POLLIN;
+        pollDescriptors[1].fd = handshakePipe[0];
+        pollDescriptors[1].events = POLLIN;
+        pollDescriptors[1].revents = 0;
+        descriptorCount = 2;
+
+        for(counter = 0; counter < childProcessCountTracker; counter++)
+        {
+            if(childProcesses.processAdded[counter] == 1 && childProcesses.outputPipe[counter] != -1)
+            {
+                pollDescriptors[descriptorCount].fd = childProcesses.outputPipe[counter];
+                pollDescriptors[descriptorCount].events = POLLIN;
+                pollProcessNumbers[descriptorCount] = counter;
+                descriptorCount++;
+            }
+            else if(childProcesses.processFileDescriptor[counter] != -1)
+            {
+                pollDescriptors[descriptorCount].fd = childProcesses.processFileDescriptor[counter];
+                pollDescriptors[descriptorCount].events = POLLIN;
+                pollProcessNumbers[descriptorCount] = counter;
+                descriptorCount++;
+            }
+        }
+
+        // Wake up at least once per export interval, to keep the metrics current.
+        readyCount = poll(pollDescriptors, descriptorCount, pollTimeout);
+
+        // The alarm handler has interrupted the wait, so display its messages and prompt again.
+        // With --quiet there might be nothing to display, and then the prompt is left as it is.
+        if(readyCount == -1)
+        {
+            if(flushLogQueue() > 0)
+            {
+                setOutputColor("\033[0m");
+                printf("\n");
+                printPrompt();
+            }
+            continue;
+        }
+
+        if(pollDescriptors[1].revents != 0)
+        {
+            readContinueHandshakes();
+        }
+
+        for(counter = 2; counter < descriptorCount; counter++)
+        {
+            if(pollDescriptors[counter].revents != 0 && pollDescriptors[counter].fd == childProcesses.processFileDescriptor[pollProcessNumbers[counter]])
+            {
+                // A re-adopted process has exited.
+                logSchedulerEvent(LogInfo, "\033[0;32m", "\nChild %d -> %s -> Terminated\n", childProcesses.processId[pollProcessNumbers[counter]],
+                getProcessState(childProcesses.state[pollProcessNumbers[counter]]));
+                setProcessState(pollProcessNumbers[counter], Terminated);
+                printPrompt();
+            }
+            else if(pollDescriptors[counter].revents != 0)
+            {
+                drainChildProcessOutput(pollProcessNumbers[counter]);
+
+                // The process might have exited on its own, and got reaped while its output was drained.
+                if(flushLogQueue() > 0)
+                {
+                    printPrompt();
+                }
+            }
+        }
+
+        if(pollDescriptors[0].revents == 0)
+        {
+            continue;
+        }
+
+        bytesRead = read(STDIN_FILENO, buf + inputLength, sizeof(buf) - 1 - inputLength);
+
+        // The input has ended, so exit the shell as if 'x' was entered.
+        if(bytesRead == 0)
+        {
+            char *exitArguments[] = {"x", NULL};
+            setOutputColor("\033[0m");
+            printf("\n");
+            exitApplication(exitArguments);
+        }
+
+        if(bytesRead < 0)
+        {
+            continue;
+        }
 
-        printf("\033[0;36m");
-        inputLine = fgets(buf, sizeof(buf), stdin);
-        printf("\033[0m");
+        inputLength += bytesRead;
+        buf[inputLength] = '\0';
 
-        if(inputLine != NULL)
+        // Execute every complete line that has been entered.
+        while(cmdExecutionStatus && (inputLine = strchr(buf, '\n')) != NULL)
         {
-            cmdArguments = extractArguments(inputLine);
+            *inputLine = '\0';
+            setOutputColor("\033[0m");
+
+            cmdArguments = extractArguments(buf);
             cmdExecutionStatus = executeCommand(cmdArguments);
             free(cmdArguments);
+
+            inputLength -= (inputLine + 1) - buf;
+            memmove(buf, inputLine + 1, inputLength + 1);
+
+            printPrompt();
         }
-        else
+
+        // A line longer than the buffer is executed as it is, like fgets would have returned it.
+        if(inputLength == sizeof(buf) - 1)
         {
-            printf("\n");
+            setOutputColor("\033[0m");
+            cmdArguments = extractArguments(buf);
+            cmdExecutionStatus = executeCommand(cmdArguments);
+            free(cmdArguments);
+            inputLength = 0;
+            printPrompt();
         }
     }
 }
 
-int main()
+int main(int argc, char *argv[])
 {
+    // Declarations
+    int argumentCounter;
+
+    for(argumentCounter = 1; argumentCounter < argc; argumentCounter++)
+    {
+        if(strcmp(argv[argumentCounter], "--quiet") == 0)
+        {
+            logLevel = LogWarning;
+        }
+        else if(strcmp(argv[argumentCounter], "--no-color") == 0)
+        {
+            colorEnabled = false;
+        }
+        else if(strcmp(argv[argumentCounter], "--log-level=warning") == 0)
+        {
+            logLevel = LogWarning;
+        }
+        else if(strcmp(argv[argumentCounter], "--log-level=info") == 0)
+        {
+            logLevel = LogInfo;
+        }
+        else if(strcmp(argv[argumentCounter], "--log-level=debug") == 0)
+        {
+            logLevel = LogDebug;
+        }
+        else
+        {
+            fprintf(stderr, "Usage: %s [--quiet] [--no-color] [--log-level=warning|info|debug]\n", argv[0]);
+            exit(1);
+        }
+    }
+
     // Register the control-c signal handler
+    // Both handlers change the process table, so each of them blocks the other one while it runs.
     struct sigaction controlCSignalAction =
     {
         .sa_handler = controlCHandler,
-        .sa_flags = 0,
-        .sa_mask = 0
+        .sa_flags = 0
     };
+    sigemptyset(&controlCSignalAction.sa_mask);
+    sigaddset(&controlCSignalAction.sa_mask, SIGALRM);
+    sigaddset(&controlCSignalAction.sa_mask, SIGINT);
     sigaction(SIGINT, &controlCSignalAction, NULL);
 
     // Register the alarm signal handler
     struct sigaction alarmSignalAction =
     {
         .sa_handler = alarmHandler,
-        .sa_flags = 0,
-        .sa_mask = 0
+        .sa_flags = 0
     };
+    sigemptyset(&alarmSignalAction.sa_mask);
+    sigaddset(&alarmSignalAction.sa_mask, SIGALRM);
+    sigaddset(&alarmSignalAction.sa_mask, SIGINT);
     sigaction(SIGALRM, &alarmSignalAction, NULL);
 
+    // Make room for the descriptors of the child processes.
+    raiseFileDescriptorLimit();
+
+    // Read the topology of the cpus before the child processes get placed on them.
+    readCpuTopology();
+
+    // Re-adopt the child processes left behind by a previous shell, if it died.
+    recoverSchedulerState();
+
     captureAndProcessInput();
 
     exit(0);
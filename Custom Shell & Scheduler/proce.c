@@ -1,30 +1,343 @@
 /*
 * Developer: Purnima Naik
 * Summary: The loop iteration number and process id are printed by this program's endless loop.
+* When the shell passes a handshake pipe as file descriptor 3, the time at which this process runs after receiving SIGCONT is
+* written into it, so that the shell can measure how long a dispatch takes.
+* When the shell passes a control page as file descriptor 4, the progress of this process is published into it, and the shell can
+* ask this process to yield the cpu through it. The process then waits on a futex in the page, without the shell sending any signal.
+* When the shell replays a trace, it runs this program as a synthetic job with --cpu=millisecs and --memory=MB. The process then
+* allocates and touches the memory of the job once it runs, burns the cpu time of the job instead of sleeping, and exits.
 */
+#define _GNU_SOURCE
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include <unistd.h>
 #include <signal.h>
+#include <time.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <stdint.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+
+#define HANDSHAKE_DESCRIPTOR 3 /* File descriptor of the handshake pipe, the same as in main.c */
+#define CONTROL_PAGE_DESCRIPTOR 4 /* File descriptor of the control page, the same as in main.c */
+#define ITERATION_TIME_IN_MILLISECS 1000 /* Time between two iterations of the loop, and the cpu time of an iteration of a synthetic job */
+#define CPU_CLOCK_CHECK_INTERVAL 10000 /* Iterations of the busy loop between two reads of the cpu time clock */
+
+/*
+* Struct continueHandshake
+* Record written into the handshake pipe, the same struct is declared in main.c.
+* processId - The process id
+* continuedTimeInMicros - Time of the monotonic clock at which the process was running again
+*/
+struct continueHandshake
+{
+    int processId;
+    long long continuedTimeInMicros;
+};
+
+/*
+* Enum Yield States
+* The futex word of the control page, the same enum is declared in main.c.
+* YieldNone - The process runs normally
+* YieldRequested - The shell has asked the process to yield the cpu
+* YieldParked - The process has yielded, and waits on the futex till the shell wakes it
+*/
+enum yieldStates
+{
+    YieldNone = 0,
+    YieldRequested = 1,
+    YieldParked = 2
+};
+
+/*
+* Struct controlPage
+* Page of shared memory between the shell and this process, the same struct is declared in main.c.
+* yieldState - Futex word, holding a value of enum yieldStates
+* processId - The process id, published once the process has started
+* startTimeInMicros - Time of the monotonic clock at which the process started, 0 until then
+* heartbeatTimeInMicros - Time of the monotonic clock at which the process last completed an iteration
+* iterationCount - Number of iterations completed by the process
+*/
+struct controlPage
+{
+    int yieldState;
+    int processId;
+    long long startTimeInMicros;
+    long long heartbeatTimeInMicros;
+    unsigned long long iterationCount;
+};
+
+/*
+* Summary - This method will get the current time of the monotonic clock.
+* Returns the time in microseconds
+*/
+long long getMonotonicTimeInMicros()
+{
+    // Declarations
+    struct timespec currentTime;
+
+    clock_gettime(CLOCK_MONOTONIC, &currentTime);
+    return (currentTime.tv_sec * 1000000LL) + (currentTime.tv_nsec / 1000);
+}
+
+static struct controlPage *control = NULL; /* The control page, NULL if the shell has not passed it */
+static long long cpuDemandInMillis = 0; /* Cpu time to burn before exiting, 0 to loop forever */
+static long memoryDemandInMB = 0; /* Memory to allocate and touch once the process runs */
+
+/*
+* Summary - This method will get the cpu time consumed by this process.
+* Returns the time in microseconds
+*/
+long long getCpuTimeInMicros()
+{
+    // Declarations
+    struct timespec cpuTime;
+
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &cpuTime);
+    return (cpuTime.tv_sec * 1000000LL) + (cpuTime.tv_nsec / 1000);
+}
+
+/*
+* Summary - This method is invoked when the process runs again after receiving SIGCONT, and reports it to the shell.
+* The heartbeat is refreshed as well, so that the process does not look stuck till it completes its next iteration.
+*/
+void continueHandler()
+{
+    // Declarations
+    struct continueHandshake handshake;
+    struct timespec currentTime;
+    int savedErrno = errno;
+
+    clock_gettime(CLOCK_MONOTONIC, &currentTime);
+    handshake.processId = getpid();
+    handshake.continuedTimeInMicros = (currentTime.tv_sec * 1000000LL) + (currentTime.tv_nsec / 1000);
+
+    if(control != NULL)
+    {
+        __atomic_store_n(&control->heartbeatTimeInMicros, handshake.continuedTimeInMicros, __ATOMIC_RELEASE);
+    }
+
+    // The pipe does not block, so the handshake is dropped if the shell is not reading it.
+    write(HANDSHAKE_DESCRIPTOR, &handshake, sizeof(handshake));
+
+    errno = savedErrno;
+}
+
+/*
+* Summary - This method will wait on the futex word of the control page, while it holds the expected value.
+* The page is shared with the shell through a file, so the futex can not be a private futex.
+* Param 1 - futexWord - the futex word
+* Param 2 - expectedValue - the value for which to wait
+* Param 3 - deadline - absolute time of the monotonic clock to wait till, NULL to wait till woken
+*/
+void waitOnFutex(int *futexWord, int expectedValue, struct timespec *deadline)
+{
+    syscall(SYS_futex, futexWord, FUTEX_WAIT_BITSET, expectedValue, deadline, NULL, FUTEX_BITSET_MATCH_ANY);
+}
+
+/*
+* Summary - If the shell has asked this process to yield the cpu, this method will acknowledge it and park the process on the
+* futex, till the shell wakes it up again.
+*/
+void parkIfYieldRequested()
+{
+    // Declarations
+    int yieldState = YieldRequested;
+
+    if(__atomic_compare_exchange_n(&control->yieldState, &yieldState, YieldParked, 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+    {
+        // Let the shell know that the cpu is yielded, and wait till it is given back.
+        syscall(SYS_futex, &control->yieldState, FUTEX_WAKE, INT32_MAX, NULL, NULL, 0);
+        while(__atomic_load_n(&control->yieldState, __ATOMIC_ACQUIRE) == YieldParked)
+        {
+            waitOnFutex(&control->yieldState, YieldParked, NULL);
+        }
+    }
+}
+
+/*
+* Summary - This method will wait till the next iteration is due. If the shell asks this process to yield the cpu meanwhile,
+* the process parks itself. Without the control page, the process just sleeps.
+*/
+void waitForNextIteration()
+{
+    // Declarations
+    struct timespec deadline;
+
+    if(control == NULL)
+    {
+        sleep(1);
+        return;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+    deadline.tv_sec += ITERATION_TIME_IN_MILLISECS / 1000;
+    deadline.tv_nsec += (ITERATION_TIME_IN_MILLISECS % 1000) * 1000000L;
+    if(deadline.tv_nsec >= 1000000000L)
+    {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000L;
+    }
+
+    // The wait ends early on a yield request, and also on a signal, so it is repeated till the deadline.
+    while(__atomic_load_n(&control->yieldState, __ATOMIC_ACQUIRE) == YieldNone
+    && getMonotonicTimeInMicros() < (deadline.tv_sec * 1000000LL) + (deadline.tv_nsec / 1000))
+    {
+        waitOnFutex(&control->yieldState, YieldNone, &deadline);
+    }
+
+    parkIfYieldRequested();
+}
+
+/*
+* Summary - This method will keep the cpu busy, till this process has consumed the given cpu time or the shell asks it to yield
+* the cpu. Then the process parks itself, if it was asked to yield.
+* Param 1 - cpuTimeInMicros - the cpu time of the process at which to stop
+*/
+void burnCpuTill(long long cpuTimeInMicros)
+{
+    // Declarations
+    volatile unsigned long spinCount = 0;
+
+    while(getCpuTimeInMicros() < cpuTimeInMicros
+    && (control == NULL || __atomic_load_n(&control->yieldState, __ATOMIC_ACQUIRE) == YieldNone))
+    {
+        for(spinCount = 0; spinCount < CPU_CLOCK_CHECK_INTERVAL; spinCount++);
+    }
+
+    if(control != NULL)
+    {
+        parkIfYieldRequested();
+    }
+}
+
+/*
+* Summary - This method will allocate the memory of a synthetic job, and write to every page of it, so that it is resident.
+* The process exits, if the memory can not be allocated, for example due to the address space limit given to 'c #'.
+*/
+void allocateMemoryDemand()
+{
+    // Declarations
+    char *memory;
+    size_t memorySize = (size_t) memoryDemandInMB * 1024 * 1024;
+
+    if(memorySize == 0)
+    {
+        return;
+    }
+
+    memory = malloc(memorySize);
+    if(memory == NULL)
+    {
+        fprintf(stderr, "Process %d could not allocate %ld MB.\n", getpid(), memoryDemandInMB);
+        exit(1);
+    }
+    memset(memory, 1, memorySize);
+}
 
 int main(int argc, char* argv[])
 {
     // Declarations
-    int loopCount;
+    int loopCount = 0, argumentCounter;
+    long long cpuTimeAtStartInMicros, nextCpuTimeInMicros;
+
+    for(argumentCounter = 1; argumentCounter < argc; argumentCounter++)
+    {
+        if(strncmp(argv[argumentCounter], "--cpu=", 6) == 0)
+        {
+            cpuDemandInMillis = atoll(argv[argumentCounter] + 6);
+        }
+        else if(strncmp(argv[argumentCounter], "--memory=", 9) == 0)
+        {
+            memoryDemandInMB = atol(argv[argumentCounter] + 9);
+        }
+        else
+        {
+            fprintf(stderr, "Usage: %s [--cpu=millisecs] [--memory=MB]\n", argv[0]);
+            exit(1);
+        }
+    }
+
+    // The output goes to a pipe that is drained by the shell, so flush it line by line.
+    setvbuf(stdout, NULL, _IOLBF, 0);
 
     // Ignore the signal SIGINT, as it will get propogated from parent to all its children.
     // The signal is handled in the parent, so it can be ignored here.
     signal(SIGINT, SIG_IGN);
 
+    // If the shell dies, its end of the output pipe is closed, and the process group of this process gets orphaned,
+    // so the kernel sends it SIGHUP and SIGCONT. Survive both without the output, so that a restarted shell can re-adopt this process.
+    signal(SIGPIPE, SIG_IGN);
+    signal(SIGHUP, SIG_IGN);
+
+    // Map the control page, if the shell has passed it, and publish that the process has started.
+    if(fcntl(CONTROL_PAGE_DESCRIPTOR, F_GETFD) != -1)
+    {
+        control = mmap(NULL, sizeof(struct controlPage), PROT_READ | PROT_WRITE, MAP_SHARED, CONTROL_PAGE_DESCRIPTOR, 0);
+        if(control == MAP_FAILED)
+        {
+            control = NULL;
+        }
+        else
+        {
+            control->processId = getpid();
+            control->heartbeatTimeInMicros = getMonotonicTimeInMicros();
+            __atomic_store_n(&control->startTimeInMicros, control->heartbeatTimeInMicros, __ATOMIC_RELEASE);
+        }
+    }
+
+    // Report every SIGCONT, if the shell has passed the handshake pipe or the control page.
+    if(fcntl(HANDSHAKE_DESCRIPTOR, F_GETFD) != -1 || control != NULL)
+    {
+        struct sigaction continueSignalAction =
+        {
+            .sa_handler = continueHandler,
+            .sa_flags = SA_RESTART
+        };
+        sigaction(SIGCONT, &continueSignalAction, NULL);
+    }
+
     // As soon as the process gets created, stop its execution.
     kill(getpid(), SIGSTOP);
 
+    // A synthetic job takes its memory once it runs, like the job it replays.
+    allocateMemoryDemand();
+    cpuTimeAtStartInMicros = getCpuTimeInMicros();
+
     // Print the loop iteration number and the process id
     while(1)
     {
         printf("\033[0m");
         printf("Process %d at iteration %d\n", getpid(), loopCount);
-        sleep(1);
         loopCount ++;
+        if(control != NULL)
+        {
+            __atomic_store_n(&control->iterationCount, loopCount, __ATOMIC_RELAXED);
+            __atomic_store_n(&control->heartbeatTimeInMicros, getMonotonicTimeInMicros(), __ATOMIC_RELEASE);
+        }
+
+        if(cpuDemandInMillis == 0)
+        {
+            waitForNextIteration();
+            continue;
+        }
+
+        // A synthetic job burns its cpu time an iteration at a time, and exits once all of it is consumed.
+        nextCpuTimeInMicros = cpuTimeAtStartInMicros + loopCount * ITERATION_TIME_IN_MILLISECS * 1000LL;
+        if(nextCpuTimeInMicros > cpuTimeAtStartInMicros + cpuDemandInMillis * 1000)
+        {
+            nextCpuTimeInMicros = cpuTimeAtStartInMicros + cpuDemandInMillis * 1000;
+        }
+        burnCpuTill(nextCpuTimeInMicros);
+        if(getCpuTimeInMicros() >= cpuTimeAtStartInMicros + cpuDemandInMillis * 1000)
+        {
+            printf("Process %d completed after %lld ms of cpu\n", getpid(), cpuDemandInMillis);
+            return 0;
+        }
     }
 
     return 0;
@@ -1,18 +1,68 @@
 /*
 * Developer: Purnima Naik
 * Summary: Program to implement to implement a simple blockchain.
+* Usage: ./blockChain [-n nodes] [-t transactions] [-b transactions] [-a transactions] [-w microseconds] [-Q votes] [-T milliseconds]
+* [-d difficulty] [-m miners] [-q] [-B] [-P threads]
+* -n nodes: Number of blockchain nodes (threads), DEFAULT_NUMBER_OF_BLOCKCHAIN_NODES by default
+* -t transactions: Number of transactions to carry out, DEFAULT_NUMBER_OF_ALLOWED_TRANSACTIONS by default
+* -b transactions: Number of transactions per block, DEFAULT_TRANSACTIONS_PER_BLOCK by default
+* -q: Do not display every transaction, nor pause before it, so that large networks can be load tested
+* -B: Measure the cost of recording a transaction as the ledger grows, instead of running the network
+* -a transactions: Number of transactions the sender sends in a batch, for which the validators vote once, 1 by default
+* -w microseconds: Time after which the sender sends a batch, even if it is not full, no limit by default
+* -Q votes: Number of validators that must accept a transaction to commit it, 2f + 1 of the 3f + 1 validators by default
+* -T milliseconds: Time after which a transaction without a quorum is declined, DEFAULT_ROUND_TIMEOUT_IN_MILLIS by default
+* -d difficulty: Mine every block, searching for a nonce that makes its hash start with the given number of zero bits
+* -m miners: Number of miner threads, the number of processors by default
+* -P threads: Carry out the transactions as concurrent transfers with 1, 2, 4, ... up to the given number of threads,
+* instead of running the network, and report the transactions per second for each number of threads
 */
 
+#define _GNU_SOURCE
 #include <pthread.h>
 #include <semaphore.h>
+#include <sched.h>
 #include <stdio.h>
 #include <time.h>
 #include <stdlib.h>
+#include <string.h>
 #include <unistd.h>
 #include <stdbool.h>
-
-#define MAXIMUM_NUMBER_OF_BLOCKCHAIN_NODES 7
-#define MAXIMUM_NUMBER_OF_ALLOWED_TRANSACTIONS 12
+#include <errno.h>
+#include <limits.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <immintrin.h>
+
+#define DEFAULT_NUMBER_OF_BLOCKCHAIN_NODES 7
+#define DEFAULT_NUMBER_OF_ALLOWED_TRANSACTIONS 12
+#define MINIMUM_NUMBER_OF_BLOCKCHAIN_NODES 2 // A transaction needs a sender and a receiver, the rest of the nodes are validators
+#define TRANSACTIONS_PER_SEGMENT 1024 // Transactions held by one segment of a transaction log
+#define ARENA_BLOCK_SIZE (1024 * 1024) // Size of the blocks of memory from which the segments are allocated
+#define MAXIMUM_NUMBER_OF_TRANSFER_THREADS 256
+#define CACHE_LINE_SIZE 64 // Data written by one transfer thread only is kept on cache lines of its own
+#define DEFAULT_TRANSACTIONS_PER_BLOCK 4
+#define SHA256_BLOCK_SIZE 64
+#define SHA256_DIGEST_SIZE 32
+#define MAXIMUM_BATCH_SIZE 65536
+#define DEFAULT_ROUND_TIMEOUT_IN_MILLIS 1000
+#define MAXIMUM_DIFFICULTY 32 // Zero bits a block hash must start with, at most the whole first word of the hash
+#define MAXIMUM_NUMBER_OF_MINERS 256
+#define NONCES_PER_MINING_BATCH 4096 // Nonces a miner takes at a time, dividing the 2^32 nonces evenly
+#define NONCE_OFFSET_IN_TAIL_BLOCK (offsetof(struct blockHeader, nonce) - SHA256_BLOCK_SIZE) // Offset of the nonce in the second block of a header
+
+#define ROTATE_RIGHT(x, n) (((x) >> (n)) | ((x) << (32 - (n))))
+#define SHA256_BIG_SIGMA0(x) (ROTATE_RIGHT(x, 2) ^ ROTATE_RIGHT(x, 13) ^ ROTATE_RIGHT(x, 22))
+#define SHA256_BIG_SIGMA1(x) (ROTATE_RIGHT(x, 6) ^ ROTATE_RIGHT(x, 11) ^ ROTATE_RIGHT(x, 25))
+#define SHA256_SMALL_SIGMA0(x) (ROTATE_RIGHT(x, 7) ^ ROTATE_RIGHT(x, 18) ^ ((x) >> 3))
+#define SHA256_SMALL_SIGMA1(x) (ROTATE_RIGHT(x, 17) ^ ROTATE_RIGHT(x, 19) ^ ((x) >> 10))
+
+// The same functions on the 8 lanes of an AVX2 vector
+#define ROTATE_RIGHT_X8(x, n) _mm256_or_si256(_mm256_srli_epi32(x, n), _mm256_slli_epi32(x, 32 - (n)))
+#define SHA256_BIG_SIGMA0_X8(x) _mm256_xor_si256(_mm256_xor_si256(ROTATE_RIGHT_X8(x, 2), ROTATE_RIGHT_X8(x, 13)), ROTATE_RIGHT_X8(x, 22))
+#define SHA256_BIG_SIGMA1_X8(x) _mm256_xor_si256(_mm256_xor_si256(ROTATE_RIGHT_X8(x, 6), ROTATE_RIGHT_X8(x, 11)), ROTATE_RIGHT_X8(x, 25))
+#define SHA256_SMALL_SIGMA0_X8(x) _mm256_xor_si256(_mm256_xor_si256(ROTATE_RIGHT_X8(x, 7), ROTATE_RIGHT_X8(x, 18)), _mm256_srli_epi32(x, 3))
+#define SHA256_SMALL_SIGMA1_X8(x) _mm256_xor_si256(_mm256_xor_si256(ROTATE_RIGHT_X8(x, 17), ROTATE_RIGHT_X8(x, 19)), _mm256_srli_epi32(x, 10))
 
 // Declarations
 struct blockChainNode
@@ -32,18 +82,213 @@ struct transaction
     int receiverPreviousAmount;
     int receiverBalanceAmount;
     int transactionAmount;
-    int transactionAdded;
+};
+
+// Block of memory of an arena. The memory is handed out by bumping usedSize, and is only freed with the whole arena.
+struct arenaBlock
+{
+    struct arenaBlock *previousBlock;
+    size_t usedSize;
+    size_t size;
+    char data[];
+};
+
+// Transaction log of a ledger. The transactions are appended to fixed size segments, so the log grows without ever moving
+// the transactions that are already in it. Only the small list of segments is reallocated, when it is full.
+struct transactionLog
+{
+    struct arenaBlock *arena;
+    struct transaction **segments;
+    int segmentCount;
+    int segmentCapacity;
+    long transactionCount;
+};
+
+// Header of a block. The hash of a block is the SHA-256d hash of its header, so it covers the block before it, and through the
+// Merkle root, every transaction of the block. With proof of work, the hash must start with difficulty zero bits.
+struct blockHeader
+{
+    unsigned char previousBlockHash[SHA256_DIGEST_SIZE];
+    unsigned char merkleRoot[SHA256_DIGEST_SIZE];
+    long long timestamp;
+    int blockNumber;
+    int transactionCount;
+    unsigned int nonce;
+    int difficulty;
+};
+
+// Block of a ledger, holding transactionCount transactions of the transaction log, from firstTransaction on.
+struct block
+{
+    struct blockHeader header;
+    unsigned char blockHash[SHA256_DIGEST_SIZE];
+    long firstTransaction;
+};
+
+// Search for the nonce of a block header. The first block of the header, holding the hashes, does not depend on the nonce,
+// so its hash state (the midstate) is computed once. Only the second block, holding the nonce, is hashed for every nonce.
+struct nonceSearch
+{
+    uint32_t midstate[8];
+    unsigned char tailBlock[SHA256_BLOCK_SIZE];
+    uint32_t tailWords[16];
+    int difficulty;
+};
+
+// Miner thread of the proof of work pool
+struct miner
+{
+    pthread_t thread;
+    long long hashCount;
+};
+
+// Proof of work pool. For every block, the block producer hands the nonce search to the miners and waits for them.
+struct miningPool
+{
+    struct miner *miners;
+    int minerCount;
+    struct nonceSearch search;
+    long long nextNonce;
+    bool isNonceFound;
+    uint32_t foundNonce;
+    long jobNumber;
+    int busyMinerCount;
+    bool isShuttingDown;
+    pthread_mutex_t lock;
+    pthread_cond_t jobStarted, jobFinished;
+    int minedBlockCount;
+    long long miningTimeInNanos;
+};
+
+// Batch of transactions that the sender sends to the receiver at once. The receiver accepts or declines every transaction
+// of the batch, but the validators vote once for the whole batch. The batch holding the last transaction ends the run.
+struct transactionBatch
+{
+    int *transactionIds;
+    int *amounts;
+    bool *isAccepted;
+    long long *submitTimesInNanos;
+    int transactionCount;
+    int acceptedAmount;
+    bool isLastBatch;
+};
+
+// How far a node has verified the blocks of the global ledger.
+struct chainVerifier
+{
+    int verifiedBlockCount;
+    unsigned char lastBlockHash[SHA256_DIGEST_SIZE];
 };
 
 // Datatype of global & local ledger
-// The data for the block chain nodes and a list of transactions that were successful will be kept in the ledger.
+// The data for the block chain nodes and a log of transactions that were successful will be kept in the ledger.
+// The successful transactions are also put into blocks, in the order of the log, although only the global ledger does so.
 struct blockChain
 {
-    struct blockChainNode nodes[MAXIMUM_NUMBER_OF_BLOCKCHAIN_NODES];
-    struct transaction transactions[MAXIMUM_NUMBER_OF_ALLOWED_TRANSACTIONS];
+    struct blockChainNode *nodes;
+    struct transactionLog transactions;
+    struct block *blocks;
+    int blockCount;
+    int blockCapacity;
+};
+
+// Account index, mapping a node id to the slot of the node in the nodes of a ledger. Every local ledger copies the nodes of
+// the global ledger in the same order, so a single index serves all the ledgers. It is an open addressing hash table with
+// linear probing, kept at most half full, so a lookup stays O(1) however many accounts there are.
+struct accountIndex
+{
+    int *nodeIds;
+    int *slots;
+    unsigned int mask;
+};
+
+// Worker thread of the parallel transaction engine (-P option). The ledger of a worker shares the nodes of the global
+// ledger, but has its own transaction log, so that workers only contend on the locks of the accounts they transfer between.
+// The clock is the position of the last transfer of the worker. A worker has cache lines of its own.
+struct transferWorker
+{
+    pthread_t thread;
+    unsigned int seed;
+    int clock;
+    long transferCount;
+    long committedCount;
+    struct blockChain ledger;
+} __attribute__((aligned(CACHE_LINE_SIZE)));
+
+// Lock of an account of the global ledger, used by the parallel transaction engine. The clock is the position of the last
+// transfer of the account. Every lock has a cache line of its own, so that transfers between other accounts do not slow
+// down the threads waiting for it.
+struct accountLock
+{
+    pthread_mutex_t mutex;
+    int clock;
+} __attribute__((aligned(CACHE_LINE_SIZE)));
+
+// Message from one node to another. The sender proposes a batch to the receiver, and the receiver proposes it to the
+// validators; a validator votes VALID or INVALID; the receiver commits the batch as ACCEPTED or DECLINED to the sender and
+// the validators. The round tells which transaction the message belongs to.
+struct message
+{
+    int type;
+    int round;
+    int fromNodeId;
+    int value;
+};
+
+// Bounded inbox of a node. Any node can post to it without taking a lock, and only the node itself reads from it. The
+// sequence of a slot tells a posting node that the slot is free, and the node that the message in it is complete.
+struct inbox
+{
+    struct message *messages;
+    unsigned int *sequences;
+    unsigned int mask;
+    unsigned int tail;
+    unsigned int head;
+    sem_t messageCount;
 };
 
 static struct blockChain _blockChainData;
+static struct accountIndex _accountIndex;
+static struct miningPool _miningPool;
+int _numberOfAddedNodes = 0;
+int _numberOfNodes = DEFAULT_NUMBER_OF_BLOCKCHAIN_NODES;
+int _numberOfTransactions = DEFAULT_NUMBER_OF_ALLOWED_TRANSACTIONS;
+int _transactionsPerBlock = DEFAULT_TRANSACTIONS_PER_BLOCK;
+int _batchSize = 1;
+int _quorum = 0;
+long _roundTimeoutInMillis = DEFAULT_ROUND_TIMEOUT_IN_MILLIS;
+long _batchWindowInMicros = 0;
+int _difficulty = 0;
+int _numberOfMiners = 0;
+bool _quiet = false;
+
+static const uint32_t sha256InitialState[8] =
+{
+    0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+};
+
+static const uint32_t sha256RoundConstants[64] =
+{
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+void sha256TransformScalar(uint32_t *state, const unsigned char *data, size_t blockCount);
+
+// SHA-256 compression function, and whether many messages are hashed 8 at a time, chosen by initializeSha256()
+void (*_sha256Transform)(uint32_t *state, const unsigned char *data, size_t blockCount) = sha256TransformScalar;
+bool _sha256MultiBuffer = false;
+const char *_sha256Implementation = "scalar";
+
+// Nonce search used by the miners, chosen by startMiningPool()
+bool (*_searchNonces)(const struct nonceSearch *search, uint32_t firstNonce, uint32_t nonceCount, uint32_t *foundNonce);
+const char *_miningImplementation;
 
 enum receiverTransactionValidation
 {
@@ -57,684 +302,2858 @@ enum transactionStatus
     DECLINED = 2
 };
 
-int _senderId, _receiverId, _transactionCounter, _countOfVotes, _loanAmount, _transactionId;
-int _countOfReaders, _countOfWriters;
+enum messageType
+{
+    PROPOSAL = 1,
+    VOTE = 2,
+    COMMIT = 3
+};
 
-// If the value of _receiverTransactionValidity is 1, it means the transaction is confirmed as valid by the receiver
-// If the value of _receiverTransactionValidity is 2, it means the transaction is confirmed as invalid by the receiver
-int _receiverTransactionValidity;
+int _transactionCounter, _transactionId;
 
-// If the value of _transactionStatus is 1, then it means the transaction is accepted and processed by the receiver.
-// If the value of _transactionStatus is 2, then it means the transaction is declined by the receiver
-int _transactionStatus;
+// Batch of every transaction the nodes may still be carrying out, by transaction number modulo the number of nodes
+struct transactionBatch *_batches;
 
-sem_t readerLock, writerLock;
-pthread_mutex_t transactionLock;
-pthread_cond_t newTransaction, validateTransaction, transactionStatus, transactionValidationStatusByReceiver, validatedTransaction;
+// Version of the global ledger. It is odd while a writer publishes a new version of the ledger, so that the nodes can read
+// the ledger without a lock, and read it again if a writer got in their way.
+unsigned _ledgerVersion;
 
+// Time from the sender making a transaction to the receiver committing it, over all the committed transactions
+long long _totalLatencyInNanos, _maximumLatencyInNanos;
+long _batchCount;
 
-/*
-* Summary - This method will check if the node data exists in the global ledger.
-* Param 1 - nodeId - the thread id
-* Returns 1, if the node exists, else returns 0.
-*/
-int nodeAlreadyExistsInGlobalLedger(int nodeId)
-{
-    // Declarations
-    int counter;
+// How the validation rounds ended, and the votes that came after their round was decided
+long _committedRoundCount, _rejectedRoundCount, _timedOutRoundCount, _lateVoteCount;
 
-    for(counter = 0; counter < MAXIMUM_NUMBER_OF_BLOCKCHAIN_NODES; counter++)
-    {
-        if(_blockChainData.nodes[counter].nodeId == nodeId)
-        {
-            return 1;
-        }
-    }
+// Lock of every account of the global ledger, by slot, used by the parallel transaction engine.
+struct accountLock *_accountLocks;
 
-    return 0;
-}
+// Inbox of every node, by node id - 1
+struct inbox *_inboxes;
+
+pthread_mutex_t ledgerWriterLock;
+pthread_barrier_t accountsRegistered;
 
 /*
-* Summary - This method will add the node's data in the global ledger.
-* Param 1 - nodeId - the thread id
-* Param 2 - totalAmount - the node's initial balance
+* Summary - This method will allocate memory from an arena. A new block is added to the arena when the current one is full.
+* Param 1 - arena - the newest block of the arena, updated when a block is added
+* Param 2 - size - the number of bytes to allocate
+* Returns the allocated memory, which is not initialized.
 */
-void addBlockchainNodeInGlobalLedger(int nodeId, int totalAmount)
+void *allocateFromArena(struct arenaBlock **arena, size_t size)
 {
     // Declarations
-    int counter = 0;
+    struct arenaBlock *block = *arena;
+    size_t blockSize = ARENA_BLOCK_SIZE;
 
-    while(counter < MAXIMUM_NUMBER_OF_BLOCKCHAIN_NODES)
+    // Keep every allocation aligned for any type.
+    size = (size + 15) & ~(size_t)15;
+
+    if(block == NULL || block->size - block->usedSize < size)
     {
-        if(_blockChainData.nodes[counter].nodeAdded == 0)
+        if(size > blockSize)
         {
-            _blockChainData.nodes[counter].nodeId = nodeId;
-            _blockChainData.nodes[counter].totalBitcoins = totalAmount;
-            _blockChainData.nodes[counter].nodeAdded = 1;
-            break;
+            blockSize = size;
         }
-        counter++;
+
+        block = malloc(sizeof(struct arenaBlock) + blockSize);
+        if(block == NULL)
+        {
+            fprintf(stderr, "The blockchain ran out of memory.\n");
+            exit(1);
+        }
+
+        block->previousBlock = *arena;
+        block->usedSize = 0;
+        block->size = blockSize;
+        *arena = block;
     }
+
+    block->usedSize += size;
+    return block->data + block->usedSize - size;
 }
 
 /*
-* Summary - This method will populate the local ledger of every node with the global ledger's _blockChainData data.
-* Param 1 - ledger - the local ledger of every node which is of type struct blockChain
-* Returns populated local ledger
+* Summary - This method will free all the blocks of an arena.
+* Param 1 - arena - the newest block of the arena
 */
-struct blockChain addNodesDataInLocalLedger(struct blockChain ledger)
+void releaseArena(struct arenaBlock *arena)
 {
     // Declarations
-    int counter = 0;
+    struct arenaBlock *previousBlock;
 
-    for(counter = 0; counter < MAXIMUM_NUMBER_OF_BLOCKCHAIN_NODES; counter ++)
+    while(arena != NULL)
     {
-        ledger.nodes[counter].nodeId = _blockChainData.nodes[counter].nodeId;
-        ledger.nodes[counter].totalBitcoins = _blockChainData.nodes[counter].totalBitcoins;
-        ledger.nodes[counter].nodeAdded = 1;
+        previousBlock = arena->previousBlock;
+        free(arena);
+        arena = previousBlock;
     }
-
-    return ledger;
 }
 
 /*
-* Summary - This method will be called to update the local and global ledgers after a successful transaction.
-* A new transaction will be added, and the new amount of the node will be updated.
-* Param 1 - ledger - the local of global ledger of type struct blockChain
-* Param 2 - senderId - sender id
-* Param 3 - receiverId - receiver id
-* Param 4 - skipSenderBalanceUpdate - if 1, do not calculate the sender's new balance amount.
-* Returns updated ledger
+* Summary - This method will add an empty transaction at the end of a transaction log.
+* Param 1 - log - the transaction log
+* Returns the added transaction, to be filled by the caller.
 */
-struct blockChain updateTransactionDataInLedger(struct blockChain ledger, int senderId, int receiverId, int skipSenderBalanceUpdate)
+struct transaction *appendTransaction(struct transactionLog *log)
 {
     // Declarations
-    int loopCounter = 0, counter = 0, senderPrevAmount, receiverPrevAmount, senderBalance, receiverBalance;
+    int slot = log->transactionCount % TRANSACTIONS_PER_SEGMENT;
 
-    // Update sender and receiver balance in the ledger
-    for(loopCounter = 0; loopCounter < MAXIMUM_NUMBER_OF_BLOCKCHAIN_NODES; loopCounter ++)
+    if(slot == 0 && log->transactionCount / TRANSACTIONS_PER_SEGMENT == log->segmentCount)
     {
-        if(ledger.nodes[loopCounter].nodeId == senderId)
+        if(log->segmentCount == log->segmentCapacity)
         {
-            if(skipSenderBalanceUpdate == 1)
+            log->segmentCapacity = log->segmentCapacity == 0 ? 16 : log->segmentCapacity * 2;
+            log->segments = realloc(log->segments, log->segmentCapacity * sizeof(struct transaction *));
+            if(log->segments == NULL)
             {
-                senderBalance = ledger.nodes[loopCounter].totalBitcoins;
-                senderPrevAmount = senderBalance + _loanAmount;
-            }
-            else
-            {
-                senderPrevAmount = ledger.nodes[loopCounter].totalBitcoins;
-                senderBalance = senderPrevAmount - _loanAmount;
-                ledger.nodes[loopCounter].totalBitcoins = senderBalance;
+                fprintf(stderr, "The blockchain ran out of memory.\n");
+                exit(1);
             }
         }
 
-        if(ledger.nodes[loopCounter].nodeId == receiverId)
-        {
-            receiverPrevAmount = ledger.nodes[loopCounter].totalBitcoins;
-            receiverBalance = receiverPrevAmount + _loanAmount;
-            ledger.nodes[loopCounter].totalBitcoins = receiverBalance;
-        }
+        log->segments[log->segmentCount] = allocateFromArena(&log->arena, TRANSACTIONS_PER_SEGMENT * sizeof(struct transaction));
+        log->segmentCount++;
     }
 
-    // Add a new transaction
-    while(counter < MAXIMUM_NUMBER_OF_ALLOWED_TRANSACTIONS)
-    {
-        if(ledger.transactions[counter].transactionAdded == 0)
-        {
-            ledger.transactions[counter].transactionId = _transactionId;
-            ledger.transactions[counter].senderId = senderId;
-            ledger.transactions[counter].receiverId = receiverId;
-            ledger.transactions[counter].senderPreviousAmount = senderPrevAmount;
-            ledger.transactions[counter].senderBalanceAmount = senderBalance;
-            ledger.transactions[counter].receiverBalanceAmount = receiverBalance;
-            ledger.transactions[counter].receiverPreviousAmount = receiverPrevAmount;
-            ledger.transactions[counter].transactionAmount = _loanAmount;
-            ledger.transactions[counter].transactionAdded = 1;
-            break;
-        }
-        counter++;
-    }
+    log->transactionCount++;
+    return &log->segments[(log->transactionCount - 1) / TRANSACTIONS_PER_SEGMENT][slot];
+}
 
-    return ledger;
+/*
+* Summary - This method will get a transaction from a transaction log.
+* Param 1 - log - the transaction log
+* Param 2 - index - the position of the transaction in the log, starting from 0
+* Returns the transaction.
+*/
+struct transaction *getTransaction(struct transactionLog *log, long index)
+{
+    return &log->segments[index / TRANSACTIONS_PER_SEGMENT][index % TRANSACTIONS_PER_SEGMENT];
 }
 
 /*
-* Summary - This method will block the nodes from reading the shared data while it is getting updated.
+* Summary - This method will get the length of a message once it is padded for SHA-256. The padding holds a 1 bit, and the
+* length of the message in bits as 8 bytes.
+* Param 1 - length - the length of the message in bytes
+* Returns the padded length in bytes.
 */
-void blockReaders()
+size_t getSha256PaddedLength(size_t length)
 {
-    _countOfWriters = _countOfWriters + 1;
-    if(_countOfWriters == 1)
-    {
-        sem_wait(&readerLock);
-    }
+    return (length + 8) / SHA256_BLOCK_SIZE * SHA256_BLOCK_SIZE + SHA256_BLOCK_SIZE;
 }
 
 /*
-* Summary - Once the nodes are done updating the shared data,
-* this method will allow the waiting nodes to read the shared data.
+* Summary - This method will copy the end of a message and pad it to a whole number of blocks, as SHA-256 requires.
+* Param 1 - paddedMessage - the padded end of the message, of getSha256PaddedLength(length) bytes
+* Param 2 - message - the end of the message
+* Param 3 - length - the length of the end of the message in bytes
+* Param 4 - messageLength - the length of the whole message in bytes
 */
-void allowReaders()
+void padSha256Message(unsigned char *paddedMessage, const void *message, size_t length, size_t messageLength)
 {
-    if(_countOfWriters == MAXIMUM_NUMBER_OF_BLOCKCHAIN_NODES)
+    // Declarations
+    size_t paddedLength = getSha256PaddedLength(length);
+    uint64_t bitLength = (uint64_t)messageLength * 8;
+    int counter;
+
+    memcpy(paddedMessage, message, length);
+    paddedMessage[length] = 0x80;
+    memset(paddedMessage + length + 1, 0, paddedLength - length - 1);
+    for(counter = 0; counter < 8; counter++)
     {
-        _countOfWriters = 0;
-        sem_post(&readerLock);
+        paddedMessage[paddedLength - 1 - counter] = (unsigned char)(bitLength >> (counter * 8));
     }
 }
 
 /*
-* Summary - This method will block the nodes from updating the shared data while it is getting read.
+* Summary - This method will store the hash state as a digest.
+* Param 1 - digest - the digest, of SHA256_DIGEST_SIZE bytes
+* Param 2 - state - the eight words of the hash state
 */
-void blockWriters()
+void storeSha256Digest(unsigned char *digest, const uint32_t *state)
 {
-    _countOfReaders = _countOfReaders + 1;
-    if(_countOfReaders == 1)
+    // Declarations
+    int counter;
+
+    for(counter = 0; counter < 8; counter++)
     {
-        sem_wait(&writerLock);
+        digest[counter * 4] = (unsigned char)(state[counter] >> 24);
+        digest[counter * 4 + 1] = (unsigned char)(state[counter] >> 16);
+        digest[counter * 4 + 2] = (unsigned char)(state[counter] >> 8);
+        digest[counter * 4 + 3] = (unsigned char)state[counter];
     }
 }
 
 /*
-* Summary - Once the nodes are done reading the shared data,
-* this method will allow the waiting writers to update the shared data.
+* Summary - This method will hash blocks of a message with the SHA-256 compression function, in plain C.
+* Param 1 - state - the eight words of the hash state, updated in place
+* Param 2 - data - the blocks, of SHA256_BLOCK_SIZE bytes each
+* Param 3 - blockCount - the number of blocks
 */
-void allowWriters()
+void sha256TransformScalar(uint32_t *state, const unsigned char *data, size_t blockCount)
 {
-    if(_countOfReaders == MAXIMUM_NUMBER_OF_BLOCKCHAIN_NODES)
+    // Declarations
+    uint32_t words[64], a, b, c, d, e, f, g, h, temp1, temp2;
+    int round;
+
+    while(blockCount-- > 0)
     {
-        _countOfReaders = 0;
-        sem_post(&writerLock);
+        for(round = 0; round < 16; round++)
+        {
+            words[round] = (uint32_t)data[round * 4] << 24 | (uint32_t)data[round * 4 + 1] << 16 |
+            (uint32_t)data[round * 4 + 2] << 8 | data[round * 4 + 3];
+        }
+        for(round = 16; round < 64; round++)
+        {
+            words[round] = words[round - 16] + SHA256_SMALL_SIGMA0(words[round - 15]) + words[round - 7] +
+            SHA256_SMALL_SIGMA1(words[round - 2]);
+        }
+
+        a = state[0];
+        b = state[1];
+        c = state[2];
+        d = state[3];
+        e = state[4];
+        f = state[5];
+        g = state[6];
+        h = state[7];
+        for(round = 0; round < 64; round++)
+        {
+            temp1 = h + SHA256_BIG_SIGMA1(e) + ((e & f) ^ (~e & g)) + sha256RoundConstants[round] + words[round];
+            temp2 = SHA256_BIG_SIGMA0(a) + ((a & b) ^ (a & c) ^ (b & c));
+            h = g;
+            g = f;
+            f = e;
+            e = d + temp1;
+            d = c;
+            c = b;
+            b = a;
+            a = temp1 + temp2;
+        }
+        state[0] += a;
+        state[1] += b;
+        state[2] += c;
+        state[3] += d;
+        state[4] += e;
+        state[5] += f;
+        state[6] += g;
+        state[7] += h;
+
+        data += SHA256_BLOCK_SIZE;
     }
 }
 
 /*
-* Summary - This method will check if the sender node is legitimate.
-* It determines its legitimacy by ascertaining whether the sender genuinely possesses the sum he intends to lend the recipient.
-* Param 1 - ledger - the local ledger of every node which is of type struct blockChain
-* Returns 1, if the sender is valid, else 0.
+* Summary - This method will hash blocks of a message with the SHA-256 compression function, using the SHA extensions
+* of the processor. Every sha256rnds2 instruction carries out two rounds.
+* Param 1 - state - the eight words of the hash state, updated in place
+* Param 2 - data - the blocks, of SHA256_BLOCK_SIZE bytes each
+* Param 3 - blockCount - the number of blocks
 */
-int isSenderNodeLegitimate(struct blockChain ledger)
+__attribute__((target("sha,sse4.1")))
+void sha256TransformShaNi(uint32_t *state, const unsigned char *data, size_t blockCount)
 {
     // Declarations
-    int loopCounter = 0;
+    const __m128i byteSwapMask = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+    __m128i abef, cdgh, savedAbef, savedCdgh, message, temp, words[4];
+    int group;
 
-    for(loopCounter = 0; loopCounter < MAXIMUM_NUMBER_OF_BLOCKCHAIN_NODES; loopCounter ++)
+    // The instructions keep the state as ABEF and CDGH, instead of ABCD and EFGH.
+    temp = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *)&state[0]), 0xB1);
+    cdgh = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *)&state[4]), 0x1B);
+    abef = _mm_alignr_epi8(temp, cdgh, 8);
+    cdgh = _mm_blend_epi16(cdgh, temp, 0xF0);
+
+    while(blockCount-- > 0)
     {
-        if(ledger.nodes[loopCounter].nodeId == _senderId)
+        savedAbef = abef;
+        savedCdgh = cdgh;
+
+        // Every group carries out 4 rounds, while the message schedule of the later groups is computed 4 words at a time.
+        // The loop is unrolled, so that the words stay in registers.
+        #pragma GCC unroll 16
+        for(group = 0; group < 16; group++)
         {
-            int senderAmount = ledger.nodes[loopCounter].totalBitcoins;
-            int senderBalance = senderAmount - _loanAmount;
-            if(senderBalance >= 0)
+            if(group < 4)
             {
-                return 1;
+                words[group] = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(data + group * 16)), byteSwapMask);
             }
-            else
+
+            message = _mm_add_epi32(words[group % 4], _mm_loadu_si128((const __m128i *)&sha256RoundConstants[group * 4]));
+            cdgh = _mm_sha256rnds2_epu32(cdgh, abef, message);
+            if(group >= 3 && group <= 14)
+            {
+                temp = _mm_alignr_epi8(words[group % 4], words[(group + 3) % 4], 4);
+                words[(group + 1) % 4] = _mm_add_epi32(words[(group + 1) % 4], temp);
+                words[(group + 1) % 4] = _mm_sha256msg2_epu32(words[(group + 1) % 4], words[group % 4]);
+            }
+            message = _mm_shuffle_epi32(message, 0x0E);
+            abef = _mm_sha256rnds2_epu32(abef, cdgh, message);
+            if(group >= 1 && group <= 12)
             {
-                return 0;
+                words[(group + 3) % 4] = _mm_sha256msg1_epu32(words[(group + 3) % 4], words[group % 4]);
             }
         }
+
+        abef = _mm_add_epi32(abef, savedAbef);
+        cdgh = _mm_add_epi32(cdgh, savedCdgh);
+        data += SHA256_BLOCK_SIZE;
     }
 
-    return 1;
+    temp = _mm_shuffle_epi32(abef, 0x1B);
+    cdgh = _mm_shuffle_epi32(cdgh, 0xB1);
+    _mm_storeu_si128((__m128i *)&state[0], _mm_blend_epi16(temp, cdgh, 0xF0));
+    _mm_storeu_si128((__m128i *)&state[4], _mm_alignr_epi8(cdgh, temp, 8));
 }
 
 /*
-* Summary - This function is executed by each thread or block chain node.
-* The thread will alternately act as a sender, receiver, or validator on each run.
-* Following the assignment of duties to each thread, they will all carry out a loan transaction
-* in which the sender thread lends money to the receiver thread, and the validator threads verify the transaction.
-* Param 1 - argumentsData - the thread arguments data
+* Summary - This method will hash one block of each of 8 messages with the SHA-256 compression function, using AVX2, every
+* message in one lane of the vectors.
+* Param 1 - states - the hash states, the word n of every message in states[n], updated in place
+* Param 2 - words - the message schedule, of 64 vectors, whose first 16 hold the words of the blocks
 */
-void *blockChainNode(void *argumentsData)
+__attribute__((target("avx2")))
+void sha256Transform8Avx2(__m256i *states, __m256i *words)
 {
     // Declarations
-    int nodeId = 0, loopCounter = 0, senderId = 0, receiverId = 0;
-    struct blockChain localBlockChainData;
-    int maxNodes = MAXIMUM_NUMBER_OF_BLOCKCHAIN_NODES;
-    bool isSender = false, isReceiver = false, isValidator = false;
-
-    // Step 1 - Get the node id
-    nodeId = (*((int *)argumentsData));
+    __m256i a, b, c, d, e, f, g, h, temp1, temp2;
+    int round;
 
-    while(1)
+    for(round = 16; round < 64; round++)
     {
-        sem_wait(&readerLock);
-        blockWriters();
+        words[round] = _mm256_add_epi32(_mm256_add_epi32(words[round - 16], SHA256_SMALL_SIGMA0_X8(words[round - 15])),
+        _mm256_add_epi32(words[round - 7], SHA256_SMALL_SIGMA1_X8(words[round - 2])));
+    }
 
-        // Step 2 - The program is made to carry out transactions up to the MAXIMUM_NUMBER_OF_ALLOWED_TRANSACTIONS.
-        // So verify how many transactions we have actually completed.
-        // Terminate the threads if we have reached that number.
-        if(_transactionCounter == MAXIMUM_NUMBER_OF_ALLOWED_TRANSACTIONS)
-        {
-            sem_post(&readerLock);
-            break;
-        }
+    a = states[0];
+    b = states[1];
+    c = states[2];
+    d = states[3];
+    e = states[4];
+    f = states[5];
+    g = states[6];
+    h = states[7];
+    for(round = 0; round < 64; round++)
+    {
+        temp1 = _mm256_add_epi32(_mm256_add_epi32(h, SHA256_BIG_SIGMA1_X8(e)),
+        _mm256_add_epi32(_mm256_xor_si256(_mm256_and_si256(e, f), _mm256_andnot_si256(e, g)),
+        _mm256_add_epi32(_mm256_set1_epi32(sha256RoundConstants[round]), words[round])));
+        temp2 = _mm256_add_epi32(SHA256_BIG_SIGMA0_X8(a),
+        _mm256_xor_si256(_mm256_and_si256(a, b), _mm256_and_si256(c, _mm256_xor_si256(a, b))));
+        h = g;
+        g = f;
+        f = e;
+        e = _mm256_add_epi32(d, temp1);
+        d = c;
+        c = b;
+        b = a;
+        a = _mm256_add_epi32(temp1, temp2);
+    }
+    states[0] = _mm256_add_epi32(states[0], a);
+    states[1] = _mm256_add_epi32(states[1], b);
+    states[2] = _mm256_add_epi32(states[2], c);
+    states[3] = _mm256_add_epi32(states[3], d);
+    states[4] = _mm256_add_epi32(states[4], e);
+    states[5] = _mm256_add_epi32(states[5], f);
+    states[6] = _mm256_add_epi32(states[6], g);
+    states[7] = _mm256_add_epi32(states[7], h);
+}
 
-        allowWriters();
-        sem_post(&readerLock);
+/*
+* Summary - This method will compute the SHA-256 hashes of 8 messages of the same length at once with AVX2, every message
+* in one lane of the vectors. The messages must already be padded.
+* Param 1 - messages - the padded messages
+* Param 2 - blockCount - the number of blocks of every message
+* Param 3 - digests - the hashes, of SHA256_DIGEST_SIZE bytes each
+*/
+__attribute__((target("avx2")))
+void sha256Hash8Avx2(const unsigned char **messages, size_t blockCount, unsigned char *digests)
+{
+    // Declarations
+    __m256i states[8], words[64];
+    size_t blockCounter;
+    int counter, lane;
+    uint32_t laneWords[8][8];
 
-        sem_wait(&writerLock);
-        blockReaders();
+    for(counter = 0; counter < 8; counter++)
+    {
+        states[counter] = _mm256_set1_epi32(sha256InitialState[counter]);
+    }
 
-        // Step 3 - Generate a positive random amount for each node, and add each node to the global ledger if it is not already there.
-        int isNodeAddedToGlobalLedger = nodeAlreadyExistsInGlobalLedger(nodeId);
-        if(isNodeAddedToGlobalLedger == 0)
+    for(blockCounter = 0; blockCounter < blockCount; blockCounter++)
+    {
+        for(counter = 0; counter < 16; counter++)
         {
-            int initialAmount;
-            while(initialAmount <= 0)
+            for(lane = 0; lane < 8; lane++)
             {
-                initialAmount = rand() % 20;
+                const unsigned char *word = messages[lane] + blockCounter * SHA256_BLOCK_SIZE + counter * 4;
+                laneWords[0][lane] = (uint32_t)word[0] << 24 | (uint32_t)word[1] << 16 | (uint32_t)word[2] << 8 | word[3];
             }
-            addBlockchainNodeInGlobalLedger(nodeId, initialAmount);
+            words[counter] = _mm256_loadu_si256((const __m256i *)laneWords[0]);
         }
+        sha256Transform8Avx2(states, words);
+    }
 
-        allowReaders();
-        sem_post(&writerLock);
-
-        sem_wait(&readerLock);
-        blockWriters();
-
-        // Step 4 - Update each node's local ledger with the global data after adding each node to the global ledger.
-        if(localBlockChainData.nodes[maxNodes - 1].nodeAdded != 1)
+    // Turn the word n of every lane into the 8 words of every lane.
+    for(counter = 0; counter < 8; counter++)
+    {
+        _mm256_storeu_si256((__m256i *)laneWords[counter], states[counter]);
+    }
+    for(lane = 0; lane < 8; lane++)
+    {
+        uint32_t state[8];
+        for(counter = 0; counter < 8; counter++)
         {
-            localBlockChainData = addNodesDataInLocalLedger(localBlockChainData);
+            state[counter] = laneWords[counter][lane];
         }
+        storeSha256Digest(digests + lane * SHA256_DIGEST_SIZE, state);
+    }
+}
+
+/*
+* Summary - This method will choose the fastest SHA-256 implementations the processor supports.
+*/
+void initializeSha256()
+{
+    __builtin_cpu_init();
+    if(__builtin_cpu_supports("sha") && __builtin_cpu_supports("sse4.1"))
+    {
+        _sha256Transform = sha256TransformShaNi;
+        _sha256Implementation = "SHA-NI";
+    }
+    else if(__builtin_cpu_supports("avx2"))
+    {
+        // A single message is still hashed in plain C, but many messages are hashed 8 at a time.
+        _sha256MultiBuffer = true;
+        _sha256Implementation = "AVX2 multi-buffer";
+    }
+}
 
-        allowWriters();
-        sem_post(&readerLock);
+/*
+* Summary - This method will compute the SHA-256 hash of a message.
+* Param 1 - message - the message
+* Param 2 - length - the length of the message in bytes
+* Param 3 - digest - the hash, of SHA256_DIGEST_SIZE bytes
+*/
+void sha256(const void *message, size_t length, unsigned char *digest)
+{
+    // Declarations
+    uint32_t state[8];
+    size_t wholeBlockCount = length / SHA256_BLOCK_SIZE;
+    size_t tailLength = length % SHA256_BLOCK_SIZE;
+    unsigned char tail[2 * SHA256_BLOCK_SIZE];
 
-        sem_wait(&writerLock);
+    memcpy(state, sha256InitialState, sizeof(state));
+    if(wholeBlockCount > 0)
+    {
+        _sha256Transform(state, message, wholeBlockCount);
+    }
 
-        // Step 5 - In its iteration, each thread will either take on the role of a sender, receiver, or validator.
-        if(_senderId == 0)
-        {
-            _senderId = nodeId;
+    // Only the last, partial block of the message needs to be copied to be padded.
+    padSha256Message(tail, (const unsigned char *)message + wholeBlockCount * SHA256_BLOCK_SIZE, tailLength, length);
+    _sha256Transform(state, tail, getSha256PaddedLength(tailLength) / SHA256_BLOCK_SIZE);
 
-            // Assign data to thread's local variables
-            senderId = _senderId;
-            isSender = true;
+    storeSha256Digest(digest, state);
+}
 
-            // Before initiating a new transaction, reset the global data
-            _loanAmount = 0;
-            _receiverTransactionValidity = 0;
-            _transactionStatus = 0;
-            _transactionId = 0;
-            _countOfVotes = 0;
-        }
-        else if(_receiverId == 0)
-        {
-            _receiverId = nodeId;
+/*
+* Summary - This method will compute the SHA-256 hashes of many messages of the same length, stored one after the other.
+* With AVX2 multi-buffer hashing, the messages are hashed 8 at a time. Every digest is only written once its message has
+* been read, so the digests may overwrite the messages, if they are at least SHA256_DIGEST_SIZE bytes long.
+* Param 1 - messages - the messages
+* Param 2 - length - the length of every message in bytes
+* Param 3 - messageCount - the number of messages
+* Param 4 - digests - the hashes, of SHA256_DIGEST_SIZE bytes each
+*/
+void sha256Many(const unsigned char *messages, size_t length, long messageCount, unsigned char *digests)
+{
+    // Declarations
+    size_t paddedLength = getSha256PaddedLength(length);
+    unsigned char *paddedMessages;
+    const unsigned char *lanes[8];
+    long messageCounter = 0;
+    int lane;
 
-            // Assign data to thread's local variables
-            isReceiver = true;
-            senderId = _senderId;
-            receiverId = _receiverId;
-        }
-        else
+    if(_sha256MultiBuffer && messageCount >= 8)
+    {
+        paddedMessages = malloc(8 * paddedLength);
+        if(paddedMessages == NULL)
         {
-            // Assign data to thread's local variables
-            isValidator = true;
-            senderId = _senderId;
-            receiverId = _receiverId;
+            fprintf(stderr, "The blockchain ran out of memory.\n");
+            exit(1);
         }
 
-        sem_post(&writerLock);
-
-        // Step 6 - Once the roles are assigned to the threads,
-        // they start a loan transaction in which the sender sends bitcoins to the receiver,
-        // the validator and the receiver verifies the transaction, and then the receiver accepts or declines the transaction.
-        // If the transaction is accepted by the receiver, the receiver writes transaction data in its local and global ledger,
-        // and notifies the other threads to update their local ledger with the transaction data.
-        if(isSender)
+        for(; messageCounter + 8 <= messageCount; messageCounter += 8)
         {
-            // Displays participating nodes and their initial amount from its local ledger.
-            printf("\n--------------Participating Nodes-------------\n");
-            printf("\033[0;36m");
-            printf("Node Id      Amount\n");
-            printf("\033[0m");
-            for(loopCounter = 0; loopCounter < maxNodes; loopCounter++)
+            for(lane = 0; lane < 8; lane++)
             {
-                printf("%d            %d\n", localBlockChainData.nodes[loopCounter].nodeId, localBlockChainData.nodes[loopCounter].totalBitcoins);
+                padSha256Message(paddedMessages + lane * paddedLength, messages + (messageCounter + lane) * length, length, length);
+                lanes[lane] = paddedMessages + lane * paddedLength;
             }
+            sha256Hash8Avx2(lanes, paddedLength / SHA256_BLOCK_SIZE, digests + messageCounter * SHA256_DIGEST_SIZE);
+        }
 
-            sleep(1);
+        free(paddedMessages);
+    }
 
-            pthread_mutex_lock(&transactionLock);
+    for(; messageCounter < messageCount; messageCounter++)
+    {
+        sha256(messages + messageCounter * length, length, digests + messageCounter * SHA256_DIGEST_SIZE);
+    }
+}
 
-            // Sender acquires the transaction lock and generates a transaction id
-            _transactionCounter = _transactionCounter + 1;
-            _transactionId = _transactionCounter;
+/*
+* Summary - This method will initialize an empty ledger, having room for the data of all the nodes.
+* Param 1 - ledger - the ledger
+*/
+void initializeLedger(struct blockChain *ledger)
+{
+    memset(ledger, 0, sizeof(struct blockChain));
+    ledger->nodes = calloc(_numberOfNodes, sizeof(struct blockChainNode));
+    if(ledger->nodes == NULL)
+    {
+        fprintf(stderr, "The blockchain ran out of memory.\n");
+        exit(1);
+    }
+}
 
-            // Generates a random loan amount
-            int loanAmount;
-            while(loanAmount <= 0)
-            {
-                // If the sender's thread ID is 2, it will make a loan amount that is not valid.
-                // This condition is added to get a failed transaction.
-                if(nodeId == 2)
-                {
-                    loanAmount = rand() % 5 + 100;
-                }
-                else
-                {
-                    loanAmount = rand() % 5;
-                }
-            }
+/*
+* Summary - This method will free the memory of a ledger.
+* Param 1 - ledger - the ledger
+*/
+void releaseLedger(struct blockChain *ledger)
+{
+    free(ledger->nodes);
+    free(ledger->transactions.segments);
+    releaseArena(ledger->transactions.arena);
+    free(ledger->blocks);
+    memset(ledger, 0, sizeof(struct blockChain));
+}
 
-            // Deduct loan amount from the sender's amount in his local ledger
-            int currentAmount, remainingAmount;
-            for(loopCounter = 0; loopCounter < maxNodes; loopCounter ++)
-            {
-                if(localBlockChainData.nodes[loopCounter].nodeId == nodeId)
-                {
-                    currentAmount = localBlockChainData.nodes[loopCounter].totalBitcoins;
-                    remainingAmount = currentAmount - loanAmount;
-                    localBlockChainData.nodes[loopCounter].totalBitcoins = remainingAmount;
-                    break;
-                }
-            }
+/*
+* Summary - This method will create an empty account index.
+* Param 1 - numberOfAccounts - the number of accounts the index must have room for
+*/
+void initializeAccountIndex(int numberOfAccounts)
+{
+    // Declarations
+    unsigned int capacity = 16;
 
-            printf("\033[0;33m");
-            printf("\n------------Starting Transaction %d------------\n", _transactionId);
-            printf("\033[0m");
+    while(capacity < 2u * numberOfAccounts)
+    {
+        capacity *= 2;
+    }
 
-            printf("Transaction Id: ");
-            printf("\033[0;36m");
-            printf("%d", _transactionId);
-            printf("\033[0m");
+    _accountIndex.nodeIds = calloc(capacity, sizeof(int));
+    _accountIndex.slots = calloc(capacity, sizeof(int));
+    if(_accountIndex.nodeIds == NULL || _accountIndex.slots == NULL)
+    {
+        fprintf(stderr, "The blockchain ran out of memory.\n");
+        exit(1);
+    }
+    _accountIndex.mask = capacity - 1;
+}
 
-            printf("\nSender Node Id: ");
-            printf("\033[0;36m");
-            printf("%d", nodeId);
-            printf("\033[0m");
+/*
+* Summary - This method will free the memory of the account index.
+*/
+void releaseAccountIndex()
+{
+    free(_accountIndex.nodeIds);
+    free(_accountIndex.slots);
+    memset(&_accountIndex, 0, sizeof(_accountIndex));
+}
 
-            printf("\nSender Initial Amount: ");
-            printf("\033[0;36m");
-            printf("%d", currentAmount);
-            printf("\033[0m");
+/*
+* Summary - This method will get the first position of the account index to probe for a node id.
+* Param 1 - nodeId - the node id
+* Returns the position.
+*/
+unsigned int getAccountIndexPosition(int nodeId)
+{
+    // Fibonacci hashing spreads the consecutive node ids over the whole table.
+    return ((unsigned int)nodeId * 2654435761u) & _accountIndex.mask;
+}
 
-            printf("\nTransaction Amount: ");
-            printf("\033[0;36m");
-            printf("%d", loanAmount);
-            printf("\033[0m");
+/*
+* Summary - This method will add a node to the account index. Node ids are positive, so 0 marks an empty position.
+* Param 1 - nodeId - the node id
+* Param 2 - slot - the slot of the node in the nodes of the ledgers
+*/
+void addAccountToIndex(int nodeId, int slot)
+{
+    // Declarations
+    unsigned int position = getAccountIndexPosition(nodeId);
 
-            _loanAmount = loanAmount;
-            receiverId = _receiverId;
+    while(_accountIndex.nodeIds[position] != 0 && _accountIndex.nodeIds[position] != nodeId)
+    {
+        position = (position + 1) & _accountIndex.mask;
+    }
 
-            // The sender informs the receiver about this new transaction.
-            pthread_cond_broadcast(&newTransaction);
+    _accountIndex.nodeIds[position] = nodeId;
+    _accountIndex.slots[position] = slot;
+}
 
-            // The sender waits for a transaction status from the receiver.
-            // As the sender is waiting on a condition, it will release the transactionLock.
-            // So that the waiting receiver, can proceed its execution with the help of this lock.
-            while(_transactionStatus == 0)
-            {
-                pthread_cond_wait(&transactionStatus, &transactionLock);
-            }
+/*
+* Summary - This method will find the slot of a node in the nodes of the ledgers.
+* Param 1 - nodeId - the node id
+* Returns the slot, or -1 if the node has not been added to the global ledger.
+*/
+int findAccountSlot(int nodeId)
+{
+    // Declarations
+    unsigned int position = getAccountIndexPosition(nodeId);
 
-            // If receiver declines the transaction, then rollback the transaction.
-            // Revert the changes performed above in the sender's local ledger
-            if(_transactionStatus == DECLINED)
-            {
-                for(loopCounter = 0; loopCounter < maxNodes; loopCounter ++)
-                {
-                    if(localBlockChainData.nodes[loopCounter].nodeId == nodeId)
-                    {
-                        localBlockChainData.nodes[loopCounter].totalBitcoins = remainingAmount + loanAmount;
-                        break;
-                    }
-                }
+    while(_accountIndex.nodeIds[position] != 0)
+    {
+        if(_accountIndex.nodeIds[position] == nodeId)
+        {
+            return _accountIndex.slots[position];
+        }
+        position = (position + 1) & _accountIndex.mask;
+    }
+
+    return -1;
+}
+
+/*
+* Summary - This method will check if the node data exists in the global ledger.
+* Param 1 - nodeId - the thread id
+* Returns 1, if the node exists, else returns 0.
+*/
+int nodeAlreadyExistsInGlobalLedger(int nodeId)
+{
+    return findAccountSlot(nodeId) != -1;
+}
+
+/*
+* Summary - This method will add the node's data in the global ledger.
+* Param 1 - nodeId - the thread id
+* Param 2 - totalAmount - the node's initial balance
+*/
+void addBlockchainNodeInGlobalLedger(int nodeId, int totalAmount)
+{
+    // Declarations
+    int slot = _numberOfAddedNodes;
+
+    // The nodes are added in the next free slot, and are never removed.
+    if(slot < _numberOfNodes)
+    {
+        _blockChainData.nodes[slot].nodeId = nodeId;
+        _blockChainData.nodes[slot].totalBitcoins = totalAmount;
+        _blockChainData.nodes[slot].nodeAdded = 1;
+        addAccountToIndex(nodeId, slot);
+        _numberOfAddedNodes++;
+    }
+}
+
+/*
+* Summary - This method will start publishing a new version of the global ledger. The writers publish their versions one at
+* a time, and the version stays odd till the new version is complete.
+*/
+void beginLedgerUpdate()
+{
+    pthread_mutex_lock(&ledgerWriterLock);
+    __atomic_store_n(&_ledgerVersion, _ledgerVersion + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+/*
+* Summary - This method will publish the new version of the global ledger, once the writer has updated it.
+*/
+void endLedgerUpdate()
+{
+    __atomic_store_n(&_ledgerVersion, _ledgerVersion + 1, __ATOMIC_RELEASE);
+    pthread_mutex_unlock(&ledgerWriterLock);
+}
+
+/*
+* Summary - This method will populate the local ledger of every node with the global ledger's _blockChainData data.
+* It is called once every node has joined the global ledger, and before any transaction is committed, so no writer can
+* change the accounts meanwhile. From then on, a node keeps its local ledger up to date from the commits it receives.
+* Param 1 - ledger - the local ledger of every node, populated in place
+*/
+void addNodesDataInLocalLedger(struct blockChain *ledger)
+{
+    // Declarations
+    int counter = 0;
+
+    for(counter = 0; counter < _numberOfNodes; counter ++)
+    {
+        ledger->nodes[counter].nodeId = _blockChainData.nodes[counter].nodeId;
+        ledger->nodes[counter].totalBitcoins = _blockChainData.nodes[counter].totalBitcoins;
+        ledger->nodes[counter].nodeAdded = 1;
+    }
+}
+
+/*
+* Summary - This method will read the number of blocks of the global ledger from a single version of it, without taking a
+* lock. A sealed block never changes, and the blocks of the global ledger do not move while the nodes run (see main), so
+* the blocks below that number can be read once it is read. If a writer is publishing a new version meanwhile, the reader
+* does not wait for it, and goes on with the blocks it already knows of.
+* Param 1 - knownBlockCount - the number of blocks the reader already knows of
+* Returns the number of blocks of the last version published, or knownBlockCount if a writer got in the way.
+*/
+int readPublishedBlockCount(int knownBlockCount)
+{
+    // Declarations
+    unsigned version = __atomic_load_n(&_ledgerVersion, __ATOMIC_ACQUIRE);
+    int blockCount = __atomic_load_n(&_blockChainData.blockCount, __ATOMIC_RELAXED);
+
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    if((version & 1) != 0 || version != __atomic_load_n(&_ledgerVersion, __ATOMIC_RELAXED))
+    {
+        return knownBlockCount;
+    }
+
+    return blockCount;
+}
+
+/*
+* Summary - This method will be called to update the local and global ledgers after a successful transaction.
+* A new transaction will be appended to the transaction log, and the new amount of the node will be updated, all in place,
+* so the cost of a transaction does not depend on the number of transactions already in the ledger.
+* Param 1 - ledger - the local or global ledger, updated in place
+* Param 2 - transactionId - transaction id
+* Param 3 - senderId - sender id
+* Param 4 - receiverId - receiver id
+* Param 5 - amount - the amount lent by the sender to the receiver
+* Param 6 - skipSenderBalanceUpdate - if 1, do not calculate the sender's new balance amount.
+*/
+void updateTransactionDataInLedger(struct blockChain *ledger, int transactionId, int senderId, int receiverId, int amount,
+int skipSenderBalanceUpdate)
+{
+    // Declarations
+    int senderSlot = findAccountSlot(senderId), receiverSlot = findAccountSlot(receiverId);
+    int senderPrevAmount = 0, receiverPrevAmount = 0, senderBalance = 0, receiverBalance = 0;
+    struct transaction *addedTransaction;
+
+    // Update sender and receiver balance in the ledger
+    if(senderSlot != -1)
+    {
+        if(skipSenderBalanceUpdate == 1)
+        {
+            senderBalance = ledger->nodes[senderSlot].totalBitcoins;
+            senderPrevAmount = senderBalance + amount;
+        }
+        else
+        {
+            senderPrevAmount = ledger->nodes[senderSlot].totalBitcoins;
+            senderBalance = senderPrevAmount - amount;
+            ledger->nodes[senderSlot].totalBitcoins = senderBalance;
+        }
+    }
+
+    if(receiverSlot != -1)
+    {
+        receiverPrevAmount = ledger->nodes[receiverSlot].totalBitcoins;
+        receiverBalance = receiverPrevAmount + amount;
+        ledger->nodes[receiverSlot].totalBitcoins = receiverBalance;
+    }
+
+    // Add a new transaction
+    addedTransaction = appendTransaction(&ledger->transactions);
+    addedTransaction->transactionId = transactionId;
+    addedTransaction->senderId = senderId;
+    addedTransaction->receiverId = receiverId;
+    addedTransaction->senderPreviousAmount = senderPrevAmount;
+    addedTransaction->senderBalanceAmount = senderBalance;
+    addedTransaction->receiverBalanceAmount = receiverBalance;
+    addedTransaction->receiverPreviousAmount = receiverPrevAmount;
+    addedTransaction->transactionAmount = amount;
+}
+
+/*
+* Summary - This method will get the current time of the monotonic clock.
+* Returns the time in nanoseconds
+*/
+long long getTimeInNanos()
+{
+    // Declarations
+    struct timespec currentTime;
+
+    clock_gettime(CLOCK_MONOTONIC, &currentTime);
+    return currentTime.tv_sec * 1000000000LL + currentTime.tv_nsec;
+}
+
+/*
+* Summary - This method will compute the SHA-256d hash of a message, that is the SHA-256 hash of its SHA-256 hash.
+* Param 1 - message - the message
+* Param 2 - length - the length of the message in bytes
+* Param 3 - digest - the hash, of SHA256_DIGEST_SIZE bytes
+*/
+void sha256d(const void *message, size_t length, unsigned char *digest)
+{
+    sha256(message, length, digest);
+    sha256(digest, SHA256_DIGEST_SIZE, digest);
+}
+
+/*
+* Summary - This method will count the zero bits a hash starts with.
+* Param 1 - hash - the hash, of SHA256_DIGEST_SIZE bytes
+* Returns the number of bits.
+*/
+int countLeadingZeroBits(const unsigned char *hash)
+{
+    // Declarations
+    int counter = 0;
+
+    while(counter < SHA256_DIGEST_SIZE && hash[counter] == 0)
+    {
+        counter++;
+    }
+    if(counter == SHA256_DIGEST_SIZE)
+    {
+        return SHA256_DIGEST_SIZE * 8;
+    }
+
+    return counter * 8 + __builtin_clz(hash[counter]) - 24;
+}
+
+/*
+* Summary - This method will prepare the search for the nonce of a block header. The first block of the header does not
+* depend on the nonce, so its hash state is computed here once, and only the second block is hashed for every nonce.
+* Param 1 - search - the search
+* Param 2 - header - the header, whose difficulty is set
+*/
+void prepareNonceSearch(struct nonceSearch *search, const struct blockHeader *header)
+{
+    // Declarations
+    int counter;
+
+    memcpy(search->midstate, sha256InitialState, sizeof(search->midstate));
+    _sha256Transform(search->midstate, (const unsigned char *)header, 1);
+
+    padSha256Message(search->tailBlock, (const unsigned char *)header + SHA256_BLOCK_SIZE,
+    sizeof(struct blockHeader) - SHA256_BLOCK_SIZE, sizeof(struct blockHeader));
+    for(counter = 0; counter < 16; counter++)
+    {
+        search->tailWords[counter] = (uint32_t)search->tailBlock[counter * 4] << 24 | (uint32_t)search->tailBlock[counter * 4 + 1] << 16 |
+        (uint32_t)search->tailBlock[counter * 4 + 2] << 8 | search->tailBlock[counter * 4 + 3];
+    }
+    search->difficulty = header->difficulty;
+}
+
+/*
+* Summary - This method will search nonces for one whose SHA-256d header hash has enough leading zero bits, a nonce at a
+* time, with the SHA-256 compression function chosen for the processor.
+* Param 1 - search - the search
+* Param 2 - firstNonce - the first nonce to try
+* Param 3 - nonceCount - the number of nonces to try
+* Param 4 - foundNonce - the nonce found
+* Returns true, if a nonce is found, else returns false.
+*/
+bool searchNonces(const struct nonceSearch *search, uint32_t firstNonce, uint32_t nonceCount, uint32_t *foundNonce)
+{
+    // Declarations
+    unsigned char tailBlock[SHA256_BLOCK_SIZE], hashBlock[SHA256_BLOCK_SIZE];
+    uint32_t state[8], nonce, counter;
+
+    // The first hash is hashed again, as a padded message of a single block.
+    memcpy(tailBlock, search->tailBlock, SHA256_BLOCK_SIZE);
+    memset(hashBlock, 0, SHA256_BLOCK_SIZE);
+    hashBlock[SHA256_DIGEST_SIZE] = 0x80;
+    hashBlock[SHA256_BLOCK_SIZE - 2] = (SHA256_DIGEST_SIZE * 8) >> 8;
+
+    for(counter = 0; counter < nonceCount; counter++)
+    {
+        nonce = firstNonce + counter;
+        memcpy(tailBlock + NONCE_OFFSET_IN_TAIL_BLOCK, &nonce, sizeof(nonce));
+        memcpy(state, search->midstate, sizeof(state));
+        _sha256Transform(state, tailBlock, 1);
+
+        storeSha256Digest(hashBlock, state);
+        memcpy(state, sha256InitialState, sizeof(state));
+        _sha256Transform(state, hashBlock, 1);
+
+        if(state[0] >> (32 - search->difficulty) == 0)
+        {
+            *foundNonce = nonce;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/*
+* Summary - This method will search nonces for one whose SHA-256d header hash has enough leading zero bits, 8 nonces at a
+* time with AVX2.
+* Param 1 - search - the search
+* Param 2 - firstNonce - the first nonce to try, a multiple of 8
+* Param 3 - nonceCount - the number of nonces to try, a multiple of 8
+* Param 4 - foundNonce - the nonce found
+* Returns true, if a nonce is found, else returns false.
+*/
+__attribute__((target("avx2")))
+bool searchNoncesAvx2(const struct nonceSearch *search, uint32_t firstNonce, uint32_t nonceCount, uint32_t *foundNonce)
+{
+    // Declarations
+    __m256i states[8], words[64], nonces, hashes;
+    const __m256i laneNumbers = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    const __m256i byteSwapMask = _mm256_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12,
+    3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+    uint32_t counter;
+    int counter2, foundLanes;
+
+    for(counter = 0; counter < nonceCount; counter += 8)
+    {
+        // The nonce is stored in the header in the byte order of the processor, but read by SHA-256 as a big endian word.
+        nonces = _mm256_add_epi32(_mm256_set1_epi32(firstNonce + counter), laneNumbers);
+        for(counter2 = 0; counter2 < 8; counter2++)
+        {
+            states[counter2] = _mm256_set1_epi32(search->midstate[counter2]);
+        }
+        for(counter2 = 0; counter2 < 16; counter2++)
+        {
+            words[counter2] = _mm256_set1_epi32(search->tailWords[counter2]);
+        }
+        words[NONCE_OFFSET_IN_TAIL_BLOCK / 4] = _mm256_shuffle_epi8(nonces, byteSwapMask);
+        sha256Transform8Avx2(states, words);
+
+        // The first hash is hashed again, as a padded message of a single block.
+        for(counter2 = 0; counter2 < 8; counter2++)
+        {
+            words[counter2] = states[counter2];
+            states[counter2] = _mm256_set1_epi32(sha256InitialState[counter2]);
+        }
+        words[8] = _mm256_set1_epi32(0x80000000);
+        for(counter2 = 9; counter2 < 15; counter2++)
+        {
+            words[counter2] = _mm256_setzero_si256();
+        }
+        words[15] = _mm256_set1_epi32(SHA256_DIGEST_SIZE * 8);
+        sha256Transform8Avx2(states, words);
+
+        hashes = _mm256_srli_epi32(states[0], 32 - search->difficulty);
+        foundLanes = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(hashes, _mm256_setzero_si256())));
+        if(foundLanes != 0)
+        {
+            *foundNonce = firstNonce + counter + __builtin_ctz(foundLanes);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/*
+* Summary - This method will measure how many nonces a single thread searches per second.
+* Param 1 - nonceSearcher - the search method
+* Param 2 - nonceCount - the number of nonces to search, a multiple of 8
+* Returns the number of hashes per second.
+*/
+long long measureNonceSearch(bool (*nonceSearcher)(const struct nonceSearch *, uint32_t, uint32_t, uint32_t *), uint32_t nonceCount)
+{
+    // Declarations
+    struct nonceSearch search;
+    struct blockHeader header;
+    uint32_t foundNonce;
+    long long startTime, elapsedTimeInNanos;
+
+    // A hash with 32 leading zero bits is so rare, that every nonce is hashed.
+    memset(&header, 0, sizeof(header));
+    header.difficulty = MAXIMUM_DIFFICULTY;
+    prepareNonceSearch(&search, &header);
+
+    startTime = getTimeInNanos();
+    nonceSearcher(&search, 0, nonceCount, &foundNonce);
+    elapsedTimeInNanos = getTimeInNanos() - startTime;
+
+    return elapsedTimeInNanos > 0 ? nonceCount * 1000000000LL / elapsedTimeInNanos : 0;
+}
+
+/*
+* Summary - This method will be executed by every miner of the proof of work pool. For every block, the miners take the
+* nonces in batches, till one of them finds a nonce or all the nonces are tried.
+* Param 1 - argumentsData - the miner
+*/
+void *mine(void *argumentsData)
+{
+    // Declarations
+    struct miner *miner = argumentsData;
+    long seenJobNumber = 0;
+    long long firstNonce;
+    uint32_t foundNonce;
+
+    while(1)
+    {
+        pthread_mutex_lock(&_miningPool.lock);
+        while(_miningPool.jobNumber == seenJobNumber && !_miningPool.isShuttingDown)
+        {
+            pthread_cond_wait(&_miningPool.jobStarted, &_miningPool.lock);
+        }
+        if(_miningPool.isShuttingDown)
+        {
+            pthread_mutex_unlock(&_miningPool.lock);
+            break;
+        }
+        seenJobNumber = _miningPool.jobNumber;
+        pthread_mutex_unlock(&_miningPool.lock);
+
+        while(!__atomic_load_n(&_miningPool.isNonceFound, __ATOMIC_ACQUIRE))
+        {
+            firstNonce = __atomic_fetch_add(&_miningPool.nextNonce, NONCES_PER_MINING_BATCH, __ATOMIC_RELAXED);
+            if(firstNonce > UINT32_MAX)
+            {
+                break;
+            }
+
+            if(_searchNonces(&_miningPool.search, (uint32_t)firstNonce, NONCES_PER_MINING_BATCH, &foundNonce))
+            {
+                miner->hashCount += foundNonce - firstNonce + 1;
+
+                pthread_mutex_lock(&_miningPool.lock);
+                if(!_miningPool.isNonceFound)
+                {
+                    _miningPool.foundNonce = foundNonce;
+                    __atomic_store_n(&_miningPool.isNonceFound, true, __ATOMIC_RELEASE);
+                }
+                pthread_mutex_unlock(&_miningPool.lock);
+                break;
+            }
+            miner->hashCount += NONCES_PER_MINING_BATCH;
+        }
+
+        pthread_mutex_lock(&_miningPool.lock);
+        _miningPool.busyMinerCount--;
+        if(_miningPool.busyMinerCount == 0)
+        {
+            pthread_cond_signal(&_miningPool.jobFinished);
+        }
+        pthread_mutex_unlock(&_miningPool.lock);
+    }
+
+    return NULL;
+}
+
+/*
+* Summary - This method will start the miners of the proof of work pool, and choose the faster way to search nonces on
+* this processor: a nonce at a time with the chosen SHA-256 compression function, or 8 at a time with AVX2.
+*/
+void startMiningPool()
+{
+    // Declarations
+    int counter;
+
+    _searchNonces = searchNonces;
+    _miningImplementation = _sha256Implementation;
+    if(__builtin_cpu_supports("avx2") && measureNonceSearch(searchNoncesAvx2, 65536) > measureNonceSearch(searchNonces, 65536))
+    {
+        _searchNonces = searchNoncesAvx2;
+        _miningImplementation = "AVX2 8-way";
+    }
+
+    memset(&_miningPool, 0, sizeof(_miningPool));
+    pthread_mutex_init(&_miningPool.lock, NULL);
+    pthread_cond_init(&_miningPool.jobStarted, NULL);
+    pthread_cond_init(&_miningPool.jobFinished, NULL);
+    _miningPool.minerCount = _numberOfMiners;
+    _miningPool.miners = calloc(_numberOfMiners, sizeof(struct miner));
+    if(_miningPool.miners == NULL)
+    {
+        fprintf(stderr, "The blockchain ran out of memory.\n");
+        exit(1);
+    }
+
+    for(counter = 0; counter < _numberOfMiners; counter++)
+    {
+        if(pthread_create(&_miningPool.miners[counter].thread, NULL, mine, &_miningPool.miners[counter]) != 0)
+        {
+            fprintf(stderr, "Miner %d could not be started, please use fewer miners.\n", counter + 1);
+            exit(1);
+        }
+    }
+}
+
+/*
+* Summary - This method will stop the miners of the proof of work pool, and report how fast they mined.
+*/
+void stopMiningPool()
+{
+    // Declarations
+    int counter;
+    long long hashCount = 0;
+    double hashesPerSecond;
+
+    pthread_mutex_lock(&_miningPool.lock);
+    _miningPool.isShuttingDown = true;
+    pthread_cond_broadcast(&_miningPool.jobStarted);
+    pthread_mutex_unlock(&_miningPool.lock);
+
+    for(counter = 0; counter < _miningPool.minerCount; counter++)
+    {
+        pthread_join(_miningPool.miners[counter].thread, NULL);
+        hashCount += _miningPool.miners[counter].hashCount;
+    }
+
+    hashesPerSecond = _miningPool.miningTimeInNanos > 0 ? hashCount * 1e9 / _miningPool.miningTimeInNanos : 0;
+    printf("\n------------Proof of Work------------\n");
+    printf("%d blocks mined at difficulty %d by %d miners (%s): %lld hashes in %.3f s\n", _miningPool.minedBlockCount,
+    _difficulty, _miningPool.minerCount, _miningImplementation, hashCount, _miningPool.miningTimeInNanos / 1e9);
+    printf("%.0f hashes/s, %.0f hashes/s per miner\n", hashesPerSecond, hashesPerSecond / _miningPool.minerCount);
+
+    pthread_mutex_destroy(&_miningPool.lock);
+    pthread_cond_destroy(&_miningPool.jobStarted);
+    pthread_cond_destroy(&_miningPool.jobFinished);
+    free(_miningPool.miners);
+}
+
+/*
+* Summary - This method will have the miners find a nonce for a block header, that makes its SHA-256d hash start with
+* _difficulty zero bits. If no nonce does, the timestamp is moved on by a second and the nonces are searched again.
+* Param 1 - header - the header, whose difficulty, nonce and timestamp are set
+*/
+void mineBlock(struct blockHeader *header)
+{
+    // Declarations
+    long long startTime = getTimeInNanos();
+    bool isNonceFound = false;
+
+    header->difficulty = _difficulty;
+    while(!isNonceFound)
+    {
+        pthread_mutex_lock(&_miningPool.lock);
+        prepareNonceSearch(&_miningPool.search, header);
+        _miningPool.nextNonce = 0;
+        _miningPool.isNonceFound = false;
+        _miningPool.busyMinerCount = _miningPool.minerCount;
+        _miningPool.jobNumber++;
+        pthread_cond_broadcast(&_miningPool.jobStarted);
+
+        while(_miningPool.busyMinerCount > 0)
+        {
+            pthread_cond_wait(&_miningPool.jobFinished, &_miningPool.lock);
+        }
+        isNonceFound = _miningPool.isNonceFound;
+        header->nonce = _miningPool.foundNonce;
+        pthread_mutex_unlock(&_miningPool.lock);
+
+        if(!isNonceFound)
+        {
+            header->timestamp++;
+        }
+    }
+
+    _miningPool.minedBlockCount++;
+    _miningPool.miningTimeInNanos += getTimeInNanos() - startTime;
+}
+
+/*
+* Summary - This method will get the number of transactions of a ledger that are not in a block yet.
+* Param 1 - ledger - the ledger
+* Returns the number of transactions.
+*/
+long getUnsealedTransactionCount(struct blockChain *ledger)
+{
+    // Declarations
+    struct block *lastBlock;
+
+    if(ledger->blockCount == 0)
+    {
+        return ledger->transactions.transactionCount;
+    }
+
+    lastBlock = &ledger->blocks[ledger->blockCount - 1];
+    return ledger->transactions.transactionCount - lastBlock->firstTransaction - lastBlock->header.transactionCount;
+}
+
+/*
+* Summary - This method will compute the Merkle root of transactions of a transaction log. The transactions are hashed,
+* then every pair of hashes is hashed together, level after level, till a single hash is left. The last hash of a level
+* with an odd number of hashes is paired with itself.
+* Param 1 - log - the transaction log
+* Param 2 - firstTransaction - the position of the first transaction in the log
+* Param 3 - transactionCount - the number of transactions, at least 1
+* Param 4 - merkleRoot - the Merkle root, of SHA256_DIGEST_SIZE bytes
+*/
+void computeMerkleRoot(struct transactionLog *log, long firstTransaction, int transactionCount, unsigned char *merkleRoot)
+{
+    // Declarations
+    unsigned char *hashes;
+    int counter, runLength, levelCount = transactionCount;
+    long position;
+
+    hashes = malloc((transactionCount + 1) * SHA256_DIGEST_SIZE);
+    if(hashes == NULL)
+    {
+        fprintf(stderr, "The blockchain ran out of memory.\n");
+        exit(1);
+    }
+
+    // The transactions are hashed straight from the log, one run of transactions of the same segment at a time.
+    for(counter = 0; counter < transactionCount; counter += runLength)
+    {
+        position = firstTransaction + counter;
+        runLength = TRANSACTIONS_PER_SEGMENT - position % TRANSACTIONS_PER_SEGMENT;
+        if(runLength > transactionCount - counter)
+        {
+            runLength = transactionCount - counter;
+        }
+        sha256Many((const unsigned char *)getTransaction(log, position), sizeof(struct transaction), runLength,
+        hashes + counter * SHA256_DIGEST_SIZE);
+    }
+
+    // The levels above are hashed in place.
+    while(levelCount > 1)
+    {
+        if(levelCount % 2 == 1)
+        {
+            memcpy(hashes + levelCount * SHA256_DIGEST_SIZE, hashes + (levelCount - 1) * SHA256_DIGEST_SIZE, SHA256_DIGEST_SIZE);
+            levelCount++;
+        }
+        sha256Many(hashes, 2 * SHA256_DIGEST_SIZE, levelCount / 2, hashes);
+        levelCount /= 2;
+    }
+
+    memcpy(merkleRoot, hashes, SHA256_DIGEST_SIZE);
+    free(hashes);
+}
+
+/*
+* Summary - This method will make room for a number of blocks in a ledger, so that its blocks do not move till it holds more.
+* Param 1 - ledger - the ledger
+* Param 2 - blockCapacity - the number of blocks
+*/
+void reserveBlocks(struct blockChain *ledger, int blockCapacity)
+{
+    if(blockCapacity <= ledger->blockCapacity)
+    {
+        return;
+    }
+
+    ledger->blocks = realloc(ledger->blocks, blockCapacity * sizeof(struct block));
+    if(ledger->blocks == NULL)
+    {
+        fprintf(stderr, "The blockchain ran out of memory.\n");
+        exit(1);
+    }
+    ledger->blockCapacity = blockCapacity;
+}
+
+/*
+* Summary - This method will put the oldest transactions of a ledger that are not in a block yet into a new block, chained
+* to the last block of the ledger.
+* Param 1 - ledger - the ledger
+* Param 2 - transactionCount - the number of transactions of the block
+*/
+void sealBlock(struct blockChain *ledger, int transactionCount)
+{
+    // Declarations
+    struct block *sealedBlock;
+
+    if(ledger->blockCount == ledger->blockCapacity)
+    {
+        reserveBlocks(ledger, ledger->blockCapacity == 0 ? 16 : ledger->blockCapacity * 2);
+    }
+
+    sealedBlock = &ledger->blocks[ledger->blockCount];
+    memset(sealedBlock, 0, sizeof(struct block));
+    sealedBlock->firstTransaction = ledger->transactions.transactionCount - getUnsealedTransactionCount(ledger);
+    if(ledger->blockCount > 0)
+    {
+        memcpy(sealedBlock->header.previousBlockHash, ledger->blocks[ledger->blockCount - 1].blockHash, SHA256_DIGEST_SIZE);
+    }
+    sealedBlock->header.timestamp = time(NULL);
+    sealedBlock->header.blockNumber = ledger->blockCount + 1;
+    sealedBlock->header.transactionCount = transactionCount;
+    computeMerkleRoot(&ledger->transactions, sealedBlock->firstTransaction, transactionCount, sealedBlock->header.merkleRoot);
+    if(_difficulty > 0)
+    {
+        mineBlock(&sealedBlock->header);
+    }
+    sha256d(&sealedBlock->header, sizeof(struct blockHeader), sealedBlock->blockHash);
+
+    ledger->blockCount++;
+}
+
+/*
+* Summary - This method will put the transactions of a ledger into blocks, as long as there are enough of them not in a
+* block yet to fill one.
+* Param 1 - ledger - the ledger
+*/
+void sealFullBlocks(struct blockChain *ledger)
+{
+    while(getUnsealedTransactionCount(ledger) >= _transactionsPerBlock)
+    {
+        sealBlock(ledger, _transactionsPerBlock);
+    }
+}
+
+/*
+* Summary - This method will verify the blocks of a ledger that a node has not verified yet. Every block must be chained to
+* the block before it, its Merkle root must match the transactions the node recorded itself, and its hash must match its
+* header and start with as many zero bits as its difficulty. Blocks holding transactions that the node has not recorded yet are left for later.
+* Param 1 - ledger - the ledger holding the blocks
+* Param 2 - blockCount - the number of blocks of the ledger to verify up to, sealed blocks only
+* Param 3 - recordedTransactions - the transaction log of the node
+* Param 4 - verifier - how far the node has verified the blocks, updated in place
+* Returns 1, if every verified block is valid, else returns 0.
+*/
+int verifyNewBlocks(struct blockChain *ledger, int blockCount, struct transactionLog *recordedTransactions, struct chainVerifier *verifier)
+{
+    // Declarations
+    struct block *verifiedBlock;
+    unsigned char hash[SHA256_DIGEST_SIZE];
+
+    while(verifier->verifiedBlockCount < blockCount)
+    {
+        verifiedBlock = &ledger->blocks[verifier->verifiedBlockCount];
+        if(verifiedBlock->firstTransaction + verifiedBlock->header.transactionCount > recordedTransactions->transactionCount)
+        {
+            break;
+        }
+
+        if(memcmp(verifiedBlock->header.previousBlockHash, verifier->lastBlockHash, SHA256_DIGEST_SIZE) != 0)
+        {
+            return 0;
+        }
+
+        computeMerkleRoot(recordedTransactions, verifiedBlock->firstTransaction, verifiedBlock->header.transactionCount, hash);
+        if(memcmp(verifiedBlock->header.merkleRoot, hash, SHA256_DIGEST_SIZE) != 0)
+        {
+            return 0;
+        }
+
+        sha256d(&verifiedBlock->header, sizeof(struct blockHeader), hash);
+        if(memcmp(verifiedBlock->blockHash, hash, SHA256_DIGEST_SIZE) != 0 || countLeadingZeroBits(hash) < verifiedBlock->header.difficulty)
+        {
+            return 0;
+        }
+
+        memcpy(verifier->lastBlockHash, hash, SHA256_DIGEST_SIZE);
+        verifier->verifiedBlockCount++;
+    }
+
+    return 1;
+}
+
+/*
+* Summary - This method will format a hash as hexadecimal text.
+* Param 1 - hash - the hash, of SHA256_DIGEST_SIZE bytes
+* Param 2 - text - the text, of 2 * SHA256_DIGEST_SIZE + 1 characters
+*/
+void formatHash(const unsigned char *hash, char *text)
+{
+    // Declarations
+    int counter;
+
+    for(counter = 0; counter < SHA256_DIGEST_SIZE; counter++)
+    {
+        sprintf(text + counter * 2, "%02x", hash[counter]);
+    }
+}
+
+/*
+* Summary - This method will allocate a batch for every transaction the nodes may be carrying out at once. A node that has
+* not finished a transaction yet receives one of the next transactions, as many as there are nodes, and the transaction after
+* that one can not start till the node has committed it, so one batch per node is always enough.
+*/
+void initializeBatches()
+{
+    // Declarations
+    int counter;
+
+    _batches = calloc(_numberOfNodes, sizeof(struct transactionBatch));
+    if(_batches == NULL)
+    {
+        fprintf(stderr, "The blockchain ran out of memory.\n");
+        exit(1);
+    }
+
+    for(counter = 0; counter < _numberOfNodes; counter++)
+    {
+        _batches[counter].transactionIds = malloc(_batchSize * sizeof(int));
+        _batches[counter].amounts = malloc(_batchSize * sizeof(int));
+        _batches[counter].isAccepted = malloc(_batchSize * sizeof(bool));
+        _batches[counter].submitTimesInNanos = malloc(_batchSize * sizeof(long long));
+        if(_batches[counter].transactionIds == NULL || _batches[counter].amounts == NULL ||
+        _batches[counter].isAccepted == NULL || _batches[counter].submitTimesInNanos == NULL)
+        {
+            fprintf(stderr, "The blockchain ran out of memory.\n");
+            exit(1);
+        }
+    }
+}
+
+/*
+* Summary - This method will free the batches, once the nodes are done.
+*/
+void releaseBatches()
+{
+    // Declarations
+    int counter;
+
+    for(counter = 0; counter < _numberOfNodes; counter++)
+    {
+        free(_batches[counter].transactionIds);
+        free(_batches[counter].amounts);
+        free(_batches[counter].isAccepted);
+        free(_batches[counter].submitTimesInNanos);
+    }
+    free(_batches);
+}
+
+/*
+* Summary - This method will allocate the inbox of every node. A node can fall behind by as many transactions as there are
+* nodes, and it gets at most a proposal and a commit for each of them, besides the votes of the transactions it receives,
+* so four times the number of nodes is always enough.
+*/
+void initializeInboxes()
+{
+    // Declarations
+    int counter;
+    unsigned int capacity = 1, slot;
+
+    while(capacity < 4 * (unsigned int)_numberOfNodes)
+    {
+        capacity *= 2;
+    }
+
+    _inboxes = calloc(_numberOfNodes, sizeof(struct inbox));
+    if(_inboxes == NULL)
+    {
+        fprintf(stderr, "The blockchain ran out of memory.\n");
+        exit(1);
+    }
+
+    for(counter = 0; counter < _numberOfNodes; counter++)
+    {
+        _inboxes[counter].messages = malloc(capacity * sizeof(struct message));
+        _inboxes[counter].sequences = malloc(capacity * sizeof(unsigned int));
+        if(_inboxes[counter].messages == NULL || _inboxes[counter].sequences == NULL)
+        {
+            fprintf(stderr, "The blockchain ran out of memory.\n");
+            exit(1);
+        }
+
+        // A slot is free for the message posted at the position equal to its sequence.
+        for(slot = 0; slot < capacity; slot++)
+        {
+            _inboxes[counter].sequences[slot] = slot;
+        }
+        _inboxes[counter].mask = capacity - 1;
+        sem_init(&_inboxes[counter].messageCount, 0, 0);
+    }
+}
+
+/*
+* Summary - This method will free the inboxes, once the nodes are done. The messages left in them are votes that came after
+* their transaction was decided, and are counted as late votes.
+*/
+void releaseInboxes()
+{
+    // Declarations
+    int counter;
+    struct inbox *nodeInbox;
+
+    for(counter = 0; counter < _numberOfNodes; counter++)
+    {
+        nodeInbox = &_inboxes[counter];
+        for(; nodeInbox->head != nodeInbox->tail; nodeInbox->head++)
+        {
+            if(nodeInbox->messages[nodeInbox->head & nodeInbox->mask].type == VOTE)
+            {
+                _lateVoteCount++;
+            }
+        }
+
+        sem_destroy(&nodeInbox->messageCount);
+        free(nodeInbox->messages);
+        free(nodeInbox->sequences);
+    }
+    free(_inboxes);
+}
+
+/*
+* Summary - This method will post a message to the inbox of a node, without taking a lock, and wake the node up if it is
+* waiting for a message. No other node is woken up.
+* Param 1 - toNodeId - the node the message is for
+* Param 2 - type - PROPOSAL, VOTE or COMMIT
+* Param 3 - round - the transaction the message belongs to
+* Param 4 - fromNodeId - the node posting the message
+* Param 5 - value - the amount of a proposal, VALID or INVALID for a vote, ACCEPTED or DECLINED for a commit
+*/
+void postMessage(int toNodeId, int type, int round, int fromNodeId, int value)
+{
+    // Declarations
+    struct inbox *nodeInbox = &_inboxes[toNodeId - 1];
+    unsigned int position = __atomic_load_n(&nodeInbox->tail, __ATOMIC_RELAXED);
+    unsigned int slot;
+    int difference;
+
+    // Claim the slot at the tail of the inbox, once the node has read the message that was in it a lap before.
+    while(1)
+    {
+        slot = position & nodeInbox->mask;
+        difference = (int)(__atomic_load_n(&nodeInbox->sequences[slot], __ATOMIC_ACQUIRE) - position);
+        if(difference == 0)
+        {
+            if(__atomic_compare_exchange_n(&nodeInbox->tail, &position, position + 1, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+            {
+                break;
+            }
+        }
+        else
+        {
+            // Either another node claimed the slot first, or the inbox is full till the node reads a message.
+            if(difference < 0)
+            {
+                sched_yield();
+            }
+            position = __atomic_load_n(&nodeInbox->tail, __ATOMIC_RELAXED);
+        }
+    }
+
+    nodeInbox->messages[slot].type = type;
+    nodeInbox->messages[slot].round = round;
+    nodeInbox->messages[slot].fromNodeId = fromNodeId;
+    nodeInbox->messages[slot].value = value;
+
+    // The message is complete once the sequence of its slot is one past its position.
+    __atomic_store_n(&nodeInbox->sequences[slot], position + 1, __ATOMIC_RELEASE);
+    sem_post(&nodeInbox->messageCount);
+}
+
+/*
+* Summary - This method will check, without waiting, whether a message of a transaction is waiting in the inbox of a node.
+* The messages of the transactions before it are dropped on the way, as receiveMessage does.
+* Param 1 - nodeId - the node whose inbox is checked
+* Param 2 - round - the transaction the node is carrying out
+* Returns true, if the node has a message of the transaction to read.
+*/
+bool hasMessage(int nodeId, int round)
+{
+    // Declarations
+    struct inbox *nodeInbox = &_inboxes[nodeId - 1];
+    unsigned int slot = nodeInbox->head & nodeInbox->mask;
+
+    while(__atomic_load_n(&nodeInbox->sequences[slot], __ATOMIC_ACQUIRE) == nodeInbox->head + 1)
+    {
+        if(nodeInbox->messages[slot].round == round)
+        {
+            return true;
+        }
+        if(nodeInbox->messages[slot].type == VOTE)
+        {
+            __atomic_add_fetch(&_lateVoteCount, 1, __ATOMIC_RELAXED);
+        }
+
+        // The message is complete, so the node is about to be woken up for it, if it has not been yet.
+        while(sem_wait(&nodeInbox->messageCount) != 0);
+        __atomic_store_n(&nodeInbox->sequences[slot], nodeInbox->head + nodeInbox->mask + 1, __ATOMIC_RELEASE);
+        nodeInbox->head++;
+        slot = nodeInbox->head & nodeInbox->mask;
+    }
+
+    return false;
+}
+
+/*
+* Summary - This method will wait for the next message of a transaction in the inbox of a node. The messages of the
+* transactions before it are dropped; they can only be votes that came after their transaction was decided.
+* Param 1 - nodeId - the node whose inbox is read
+* Param 2 - round - the transaction the node is carrying out
+* Param 3 - deadline - the time of the monotonic clock after which to stop waiting, or NULL to wait as long as it takes
+* Param 4 - receivedMessage - the message read
+* Returns true, if a message was read, or false, if the deadline passed first.
+*/
+bool receiveMessage(int nodeId, int round, const struct timespec *deadline, struct message *receivedMessage)
+{
+    // Declarations
+    struct inbox *nodeInbox = &_inboxes[nodeId - 1];
+    unsigned int slot;
+    int waitStatus;
+
+    while(1)
+    {
+        // Sleep till a message is posted to this node.
+        waitStatus = deadline == NULL ? sem_wait(&nodeInbox->messageCount) :
+        sem_clockwait(&nodeInbox->messageCount, CLOCK_MONOTONIC, deadline);
+        if(waitStatus != 0)
+        {
+            if(errno == ETIMEDOUT)
+            {
+                return false;
+            }
+            continue;
+        }
+
+        // The message counted by the semaphore may have been posted after the message at the head, which is still being written.
+        slot = nodeInbox->head & nodeInbox->mask;
+        while(__atomic_load_n(&nodeInbox->sequences[slot], __ATOMIC_ACQUIRE) != nodeInbox->head + 1)
+        {
+            sched_yield();
+        }
+        *receivedMessage = nodeInbox->messages[slot];
+
+        // Free the slot for the message posted a lap later.
+        __atomic_store_n(&nodeInbox->sequences[slot], nodeInbox->head + nodeInbox->mask + 1, __ATOMIC_RELEASE);
+        nodeInbox->head++;
+
+        if(receivedMessage->round == round)
+        {
+            return true;
+        }
+        if(receivedMessage->type == VOTE)
+        {
+            __atomic_add_fetch(&_lateVoteCount, 1, __ATOMIC_RELAXED);
+        }
+    }
+}
+
+/*
+* Summary - This method will post the commit of a transaction from its receiver to its sender and its validators.
+* Param 1 - round - the transaction that is committed
+* Param 2 - receiverId - the receiver of the transaction
+* Param 3 - status - ACCEPTED or DECLINED
+*/
+void postCommit(int round, int receiverId, int status)
+{
+    // Declarations
+    int counter;
+
+    // The nodes after the receiver are told first, so that no node is always the first to go on to the next transaction.
+    for(counter = 1; counter < _numberOfNodes; counter++)
+    {
+        postMessage((receiverId - 1 + counter) % _numberOfNodes + 1, COMMIT, round, receiverId, status);
+    }
+}
+
+/*
+* Summary - This method will check if the sender node is legitimate.
+* It determines its legitimacy by ascertaining whether the sender genuinely possesses the sum he intends to lend the recipient.
+* Param 1 - ledger - the local ledger of every node
+* Param 2 - senderId - sender id
+* Param 3 - amount - the amount the sender intends to lend
+* Returns 1, if the sender is valid, else 0.
+*/
+int isSenderNodeLegitimate(struct blockChain *ledger, int senderId, int amount)
+{
+    // Declarations
+    int senderSlot = findAccountSlot(senderId);
+
+    if(senderSlot != -1 && ledger->nodes[senderSlot].totalBitcoins - amount < 0)
+    {
+        return 0;
+    }
+
+    return 1;
+}
+
+/*
+* Summary - This function is executed by each thread or block chain node.
+* The thread will alternately act as a sender, receiver, or validator on each run.
+* Following the assignment of duties to each thread, they will all carry out a loan transaction
+* in which the sender thread lends money to the receiver thread, and the validator threads verify the transaction.
+* Param 1 - argumentsData - the thread arguments data
+*/
+void *blockChainNode(void *argumentsData)
+{
+    // Declarations
+    int nodeId = 0, loopCounter = 0, senderId = 0, receiverId = 0, round = 0;
+    struct blockChain localBlockChainData;
+    struct message receivedMessage;
+    struct chainVerifier verifier;
+    struct transactionBatch *batch;
+    int maxNodes = _numberOfNodes;
+    bool isSender = false, isReceiver = false, isValidator = false, isChainInvalid = false;
+
+    // Step 1 - Get the node id
+    nodeId = (*((int *)argumentsData));
+    initializeLedger(&localBlockChainData);
+    memset(&verifier, 0, sizeof(verifier));
+
+    // Step 2 - Generate a positive random amount for the node, and add the node to the global ledger, as a new version of it.
+    beginLedgerUpdate();
+    int isNodeAddedToGlobalLedger = nodeAlreadyExistsInGlobalLedger(nodeId);
+    if(isNodeAddedToGlobalLedger == 0)
+    {
+        int initialAmount = 0;
+        while(initialAmount <= 0)
+        {
+            initialAmount = rand() % 20;
+        }
+        addBlockchainNodeInGlobalLedger(nodeId, initialAmount);
+    }
+    endLedgerUpdate();
+
+    // Step 3 - Once every node is added to the global ledger, update the node's local ledger with the global data.
+    // This is the only time the nodes wait for each other: the receiver of the first transaction must not commit it
+    // before every node has copied the accounts, as no barrier holds the nodes back once they start.
+    pthread_barrier_wait(&accountsRegistered);
+    addNodesDataInLocalLedger(&localBlockChainData);
+    pthread_barrier_wait(&accountsRegistered);
+
+    while(1)
+    {
+        // Step 4 - Move on to the next transaction, once the node has finished the previous one.
+        // The roles go round the nodes: the node after the sender receives the transaction, and the receiver sends the next
+        // one, once it has committed this one. So every node knows its role from the number of the transaction, without
+        // waiting for the other nodes, and a slow validator can still be voting while the next transaction is made.
+        round++;
+        senderId = (round - 1) % maxNodes + 1;
+        receiverId = round % maxNodes + 1;
+
+        // Step 5 - In its iteration, each thread will either take on the role of a sender, receiver, or validator.
+        // The batch of the transaction is kept in a slot of its own, as the nodes may be carrying out several transactions.
+        isSender = nodeId == senderId;
+        isReceiver = nodeId == receiverId;
+        isValidator = !isSender && !isReceiver;
+        batch = &_batches[round % maxNodes];
+
+        // Step 6 - Once the roles are assigned to the threads,
+        // they start a loan transaction in which the sender sends bitcoins to the receiver,
+        // the validator and the receiver verifies the transaction, and then the receiver accepts or declines the transaction.
+        // If the transaction is accepted by the receiver, the receiver writes transaction data in its local and global ledger,
+        // and notifies the other threads to update their local ledger with the transaction data.
+        // The nodes only talk through the messages in their inboxes, and a node is only woken up by a message for it.
+        if(isSender)
+        {
+            // Displays participating nodes and their initial amount from its local ledger.
+            if(!_quiet)
+            {
+                printf("\n--------------Participating Nodes-------------\n");
+                printf("\033[0;36m");
+                printf("Node Id      Amount\n");
+                printf("\033[0m");
+                for(loopCounter = 0; loopCounter < maxNodes; loopCounter++)
+                {
+                    printf("%d            %d\n", localBlockChainData.nodes[loopCounter].nodeId, localBlockChainData.nodes[loopCounter].totalBitcoins);
+                }
+
+                sleep(1);
+            }
+
+            // The sender makes a batch of transactions for the receiver. The batch is sent once it holds _batchSize
+            // transactions, once _batchWindowInMicros have passed since its first transaction, or once all the transactions
+            // are made.
+            int nodeSlot = findAccountSlot(nodeId);
+            int initialAmount = localBlockChainData.nodes[nodeSlot].totalBitcoins;
+            int batchAmount = 0;
+            long long batchStartTime = getTimeInNanos();
+            // Only one sender makes transactions at a time, as the next one is the receiver of this batch.
+            batch->transactionCount = 0;
+            while(batch->transactionCount < _batchSize && _transactionCounter < _numberOfTransactions &&
+            (_batchWindowInMicros == 0 || batch->transactionCount == 0 || getTimeInNanos() - batchStartTime < _batchWindowInMicros * 1000))
+            {
+                // The sender generates a transaction id
+                int transactionId = ++_transactionCounter;
+
+                // Generates a random loan amount
+                int loanAmount = 0;
+                while(loanAmount <= 0)
+                {
+                    // If the sender's thread ID is 2, it will make a loan amount that is not valid.
+                    // This condition is added to get a failed transaction.
+                    if(nodeId == 2)
+                    {
+                        loanAmount = rand() % 5 + 100;
+                    }
+                    else
+                    {
+                        loanAmount = rand() % 5;
+                    }
+                }
+
+                // Deduct loan amount from the sender's amount in his local ledger
+                int currentAmount = localBlockChainData.nodes[nodeSlot].totalBitcoins;
+                int remainingAmount = currentAmount - loanAmount;
+                localBlockChainData.nodes[nodeSlot].totalBitcoins = remainingAmount;
+
+                if(!_quiet)
+                {
+                    printf("\033[0;33m");
+                    printf("\n------------Starting Transaction %d------------\n", transactionId);
+                    printf("\033[0m");
+
+                    printf("Transaction Id: ");
+                    printf("\033[0;36m");
+                    printf("%d", transactionId);
+                    printf("\033[0m");
+
+                    printf("\nSender Node Id: ");
+                    printf("\033[0;36m");
+                    printf("%d", nodeId);
+                    printf("\033[0m");
+
+                    printf("\nSender Initial Amount: ");
+                    printf("\033[0;36m");
+                    printf("%d", currentAmount);
+                    printf("\033[0m");
+
+                    printf("\nTransaction Amount: ");
+                    printf("\033[0;36m");
+                    printf("%d", loanAmount);
+                    printf("\033[0m");
+                }
+
+                batch->transactionIds[batch->transactionCount] = transactionId;
+                batch->amounts[batch->transactionCount] = loanAmount;
+                batch->submitTimesInNanos[batch->transactionCount] = getTimeInNanos();
+                batch->transactionCount++;
+                batchAmount += loanAmount;
+            }
+            batch->isLastBatch = _transactionCounter == _numberOfTransactions;
+
+            // The sender proposes this new transaction to the receiver.
+            postMessage(receiverId, PROPOSAL, round, nodeId, batchAmount);
+
+            // The sender waits for the receiver to commit the transaction.
+            do
+            {
+                receiveMessage(nodeId, round, NULL, &receivedMessage);
+            }
+            while(receivedMessage.type != COMMIT);
+
+            // Rollback the transactions, reverting the changes performed above in the sender's local ledger.
+            localBlockChainData.nodes[nodeSlot].totalBitcoins = initialAmount;
+
+            // If receiver accepts the transactions, then update the local ledger.
+            // Add the details of the accepted transactions in the local ledger, in the order the receiver committed them.
+            if(receivedMessage.value == ACCEPTED)
+            {
+                for(loopCounter = 0; loopCounter < batch->transactionCount; loopCounter++)
+                {
+                    if(batch->isAccepted[loopCounter])
+                    {
+                        updateTransactionDataInLedger(&localBlockChainData, batch->transactionIds[loopCounter], senderId, receiverId,
+                        batch->amounts[loopCounter], 0);
+                    }
+                }
+            }
+
+             // Reset the local data
+            isSender = false;
+            senderId = 0;
+            receiverId = 0;
+        }
+
+        if(isReceiver)
+        {
+            // The receiver waits for the proposal of the sender, that a new transaction has started.
+            // Once it gets the proposal from the sender, the sender waits for the receiver to commit the transaction,
+            // and the receiver starts validating the transaction.
+            do
+            {
+                receiveMessage(nodeId, round, NULL, &receivedMessage);
+            }
+            while(receivedMessage.type != PROPOSAL);
+
+            if(!_quiet)
+            {
+                printf("\nReceiver Node Id: ");
+                printf("\033[0;36m");
+                printf("%d", nodeId);
+                printf("\033[0m");
+            }
+
+            int receiverInitialAmount = localBlockChainData.nodes[findAccountSlot(nodeId)].totalBitcoins;
+
+            if(!_quiet)
+            {
+                printf("\nReceiver Initial Amount: ");
+                printf("\033[0;36m");
+                printf("%d", receiverInitialAmount);
+                printf("\033[0m");
+            }
+
+            // Validate the sender by using the localBlockChainData.
+            // Every transaction of the batch must be covered by what is left to the sender after the ones accepted before it.
+            int acceptedCount = 0;
+            batch->acceptedAmount = 0;
+            for(loopCounter = 0; loopCounter < batch->transactionCount; loopCounter++)
+            {
+                batch->isAccepted[loopCounter] = isSenderNodeLegitimate(&localBlockChainData, senderId,
+                batch->acceptedAmount + batch->amounts[loopCounter]) == 1;
+                if(batch->isAccepted[loopCounter])
+                {
+                    batch->acceptedAmount += batch->amounts[loopCounter];
+                    acceptedCount++;
+                }
+            }
+
+            bool isQuorumReached = false;
+            if(acceptedCount > 0)
+            {
+                // The sender is a valid node.
+                if(!_quiet)
+                {
+                    printf("\033[0;32m");
+                    printf("\nThe receiver validated that the transaction is legitimate.");
+                    if(acceptedCount < batch->transactionCount)
+                    {
+                        printf("\n%d of the %d transactions of the batch were declined.", batch->transactionCount - acceptedCount,
+                        batch->transactionCount);
+                    }
+                    printf("\nBroadcasting a request to other nodes to verify this transaction.\n");
+                    printf("\033[0m");
+                }
+
+                // Propose the transaction to the validators, as the sender is valid.
+                // So that the validators, can validate the transaction.
+                for(loopCounter = 1; loopCounter <= maxNodes; loopCounter++)
+                {
+                    if(loopCounter != senderId && loopCounter != nodeId)
+                    {
+                        postMessage(loopCounter, PROPOSAL, round, nodeId, batch->acceptedAmount);
+                    }
+                }
+
+                // As the sender is valid, the receiver waits till a quorum of the validators accepts the transaction, till so many
+                // of them reject it that a quorum can not be reached anymore, or till the round times out.
+                // The slowest validators do not hold up the commit, they vote after it.
+                int countOfValidators = maxNodes - 2, countOfAcceptVotes = 0, countOfRejectVotes = 0;
+                struct timespec roundDeadline;
+                clock_gettime(CLOCK_MONOTONIC, &roundDeadline);
+                roundDeadline.tv_sec += _roundTimeoutInMillis / 1000;
+                roundDeadline.tv_nsec += _roundTimeoutInMillis % 1000 * 1000000;
+                if(roundDeadline.tv_nsec >= 1000000000)
+                {
+                    roundDeadline.tv_sec++;
+                    roundDeadline.tv_nsec -= 1000000000;
+                }
+                while(countOfAcceptVotes < _quorum && countOfRejectVotes <= countOfValidators - _quorum &&
+                receiveMessage(nodeId, round, &roundDeadline, &receivedMessage))
+                {
+                    if(receivedMessage.type == VOTE && receivedMessage.value == VALID)
+                    {
+                        countOfAcceptVotes++;
+                    }
+                    else if(receivedMessage.type == VOTE)
+                    {
+                        countOfRejectVotes++;
+                    }
+                }
+
+                isQuorumReached = countOfAcceptVotes >= _quorum;
+                if(isQuorumReached)
+                {
+                    _committedRoundCount++;
+                }
+                else if(countOfRejectVotes > countOfValidators - _quorum)
+                {
+                    _rejectedRoundCount++;
+                }
+                else
+                {
+                    _timedOutRoundCount++;
+                }
+            }
+
+            if(isQuorumReached)
+            {
+                long long commitTime = getTimeInNanos();
+                // The accepted transactions of the batch, and the blocks sealed from them, are published as one new version of
+                // the global ledger.
+                beginLedgerUpdate();
+                for(loopCounter = 0; loopCounter < batch->transactionCount; loopCounter++)
+                {
+                    if(!batch->isAccepted[loopCounter])
+                    {
+                        continue;
+                    }
+
+                    // Once the transaction is validated by the validators, the receiver updates the transaction details in the local ledger.
+                    updateTransactionDataInLedger(&localBlockChainData, batch->transactionIds[loopCounter], senderId, receiverId,
+                    batch->amounts[loopCounter], 0);
+                    // Then the receiver, updates the transaction details in the global ledger.
+                    updateTransactionDataInLedger(&_blockChainData, batch->transactionIds[loopCounter], senderId, receiverId,
+                    batch->amounts[loopCounter], 0);
+
+                    long long latency = commitTime - batch->submitTimesInNanos[loopCounter];
+                    _totalLatencyInNanos += latency;
+                    if(latency > _maximumLatencyInNanos)
+                    {
+                        _maximumLatencyInNanos = latency;
+                    }
+                }
+                _batchCount++;
+                // Put the transactions of the global ledger into a block, once there are enough of them.
+                sealFullBlocks(&_blockChainData);
+                endLedgerUpdate();
+
+                // The receiver informs the sender and the validators that the transaction is valid,
+                // and hence it is accepted and processed by the receiver.
+                postCommit(round, nodeId, ACCEPTED);
+
+                int sendBalAmt = localBlockChainData.nodes[findAccountSlot(senderId)].totalBitcoins;
+                int recBalAmt = localBlockChainData.nodes[findAccountSlot(receiverId)].totalBitcoins;
+
+                if(!_quiet)
+                {
+                    printf("Receiver Balance Amount: ");
+                    printf("\033[0;36m");
+                    printf("%d", recBalAmt);
+                    printf("\033[0m");
+
+                    printf("\nSender Balance Amount: ");
+                    printf("\033[0;36m");
+                    printf("%d", sendBalAmt);
+                    printf("\033[0m");
+
+                    printf("\033[0;33m");
+                    printf("\n------------------SUCCESS---------------------\n");
+                    printf("\033[0m");
+                }
+
+                // Reset the data
+                isReceiver = false;
+                senderId = 0;
+                receiverId = 0;
+            }
+            else
+            {
+                // It will come here, if the sender node is invalid, or if the validators did not reach a quorum.
+                // The receiver informs the sender and the validators that the transaction is declined.
+                // If the sender is invalid, the validators were not asked to vote, and only learn that the transaction is declined.
+                postCommit(round, nodeId, DECLINED);
+
+                if(!_quiet)
+                {
+                    printf("\033[0;31m");
+                    if(acceptedCount > 0)
+                    {
+                        printf("\nThe validators did not reach a quorum of %d votes, and so the recipient has denied the bitcoins.", _quorum);
+                    }
+                    else
+                    {
+                        printf("\nThe recipient has verified that this is a fraudulent transaction and has consequently denied the bitcoins.");
+                    }
+                    printf("\033[0m");
+                    printf("\033[0;33m");
+                    printf("\n------------------FAILED---------------------\n");
+                    printf("\033[0m");
+                }
+
+                _batchCount++;
+
+                // Reset the local data
+                isReceiver = false;
+                senderId = 0;
+                receiverId = 0;
+            }
+        }
+
+        if(isValidator)
+        {
+            // When a thread will become a validator, it will just wait for the receiver to propose the transaction.
+            // If the receiver commits the transaction as declined instead, the sender is invalid,
+            // and the validator just needs to reset the data and participate in another transaction.
+            receiveMessage(nodeId, round, NULL, &receivedMessage);
+
+            // If the receiver proposed the transaction, the validator will validate the sender,
+            // and will vote for or against the transaction.
+            if(receivedMessage.type == PROPOSAL)
+            {
+                // Validate the sender
+                // The validator votes once for all the transactions of the batch the receiver accepted, unless the receiver
+                // already committed the transaction without its vote, the only message that can follow the proposal.
+                if(hasMessage(nodeId, round))
+                {
+                    __atomic_add_fetch(&_lateVoteCount, 1, __ATOMIC_RELAXED);
+                }
+                else if(isSenderNodeLegitimate(&localBlockChainData, senderId, batch->acceptedAmount) == 1)
+                {
+                    postMessage(receiverId, VOTE, round, nodeId, VALID);
+                    if(!_quiet)
+                    {
+                        flockfile(stdout);
+                        printf("\033[0;32m");
+                        printf("+ ");
+                        printf("\033[0m");
+                        printf("Node %d confirmed the transaction as valid.\n", nodeId);
+                        funlockfile(stdout);
+                    }
+                }
+                else
+                {
+                    postMessage(receiverId, VOTE, round, nodeId, INVALID);
+                    if(!_quiet)
+                    {
+                        flockfile(stdout);
+                        printf("\033[0;31m");
+                        printf("- ");
+                        printf("\033[0m");
+                        printf("Node %d rejected the transaction as invalid.\n", nodeId);
+                        funlockfile(stdout);
+                    }
+                }
+
+                // Whatever the vote of the validator, the transaction is committed if the quorum accepted it, and so the
+                // local ledger of the validator must record it. Wait for the receiver to commit the transaction.
+                do
+                {
+                    receiveMessage(nodeId, round, NULL, &receivedMessage);
+                }
+                while(receivedMessage.type != COMMIT);
+
+                // If the trasaction is accepted and processed, then update the local ledger with the transaction details
+                if(receivedMessage.value == ACCEPTED)
+                {
+                    // Update the local ledger
+                    for(loopCounter = 0; loopCounter < batch->transactionCount; loopCounter++)
+                    {
+                        if(batch->isAccepted[loopCounter])
+                        {
+                            updateTransactionDataInLedger(&localBlockChainData, batch->transactionIds[loopCounter], senderId,
+                            receiverId, batch->amounts[loopCounter], 0);
+                        }
+                    }
+                    // Verify the blocks the node has not verified yet, against the transactions of its local ledger. The blocks are
+                    // read from the last version of the global ledger published, while the next receivers may seal new ones.
+                    // Once a block is invalid, the blocks after it can not be trusted either.
+                    if(!isChainInvalid && verifyNewBlocks(&_blockChainData, readPublishedBlockCount(verifier.verifiedBlockCount),
+                    &localBlockChainData.transactions, &verifier) == 0)
+                    {
+                        isChainInvalid = true;
+                        fprintf(stderr, "Node %d found block %d of the global ledger invalid.\n", nodeId, verifier.verifiedBlockCount + 1);
+                    }
+                }
+            }
+
+            // Reset the local data
+            isValidator = false;
+            senderId = 0;
+            receiverId = 0;
+        }
+
+        // Step 7 - The program is made to carry out transactions up to the _numberOfTransactions.
+        // The sender marks the batch that holds the last of them, and every node terminates once it has finished that transaction.
+        if(batch->isLastBatch)
+        {
+            break;
+        }
+    }
+
+    releaseLedger(&localBlockChainData);
+    pthread_exit(0);
+}
+
+/*
+* Summary - This method will measure the cost of recording a transaction as the ledger grows (-B option).
+* Updating the ledger in place is compared with the earlier API, which took the ledger by value and returned it, and so
+* copied all of its nodes and transactions into and out of every call. The earlier ledger is mimicked by a flat copy of
+* the nodes and the transactions, that is copied twice for every transaction.
+*/
+void runLedgerBenchmark()
+{
+    // Declarations
+    long ledgerSizes[] = {1024, 16384, 131072, 1048576};
+    int sizeCount = sizeof(ledgerSizes) / sizeof(ledgerSizes[0]);
+    int sizeCounter, counter;
+    long iteration, iterationCount;
+    size_t imageSize;
+    char *ledgerImage, *copiedImage;
+    struct blockChain ledger;
+    struct transaction *flatTransactions;
+    long long startTime, byValueTimeInNanos, inPlaceTimeInNanos;
+
+    printf("\033[0;36m");
+    printf("Transactions   By value (ns/txn)   In place (ns/txn)   Speedup\n");
+    printf("\033[0m");
+
+    for(sizeCounter = 0; sizeCounter < sizeCount; sizeCounter++)
+    {
+        // The earlier API: the whole ledger is copied into the call, updated, and copied back out of it.
+        imageSize = _numberOfNodes * sizeof(struct blockChainNode) + ledgerSizes[sizeCounter] * sizeof(struct transaction);
+        ledgerImage = calloc(1, imageSize);
+        copiedImage = malloc(imageSize);
+        if(ledgerImage == NULL || copiedImage == NULL)
+        {
+            fprintf(stderr, "The blockchain ran out of memory.\n");
+            exit(1);
+        }
+
+        // Copy about 1 GB per ledger size, so that every size takes a similar time.
+        iterationCount = (1L << 30) / (2 * imageSize);
+        if(iterationCount < 4)
+        {
+            iterationCount = 4;
+        }
+
+        startTime = getTimeInNanos();
+        for(iteration = 0; iteration < iterationCount; iteration++)
+        {
+            memcpy(copiedImage, ledgerImage, imageSize);
+            flatTransactions = (struct transaction *)(copiedImage + _numberOfNodes * sizeof(struct blockChainNode));
+            flatTransactions[iteration % ledgerSizes[sizeCounter]].transactionId = iteration;
+            flatTransactions[iteration % ledgerSizes[sizeCounter]].transactionAmount = 1;
+            memcpy(ledgerImage, copiedImage, imageSize);
+        }
+        byValueTimeInNanos = (getTimeInNanos() - startTime) / iterationCount;
+
+        free(ledgerImage);
+        free(copiedImage);
+
+        // The current API: the ledger is filled to the size, then more transactions are appended to it in place.
+        initializeLedger(&ledger);
+        initializeAccountIndex(_numberOfNodes);
+        for(counter = 0; counter < _numberOfNodes; counter++)
+        {
+            ledger.nodes[counter].nodeId = counter + 1;
+            ledger.nodes[counter].totalBitcoins = INT_MAX / 2;
+            ledger.nodes[counter].nodeAdded = 1;
+            addAccountToIndex(counter + 1, counter);
+        }
+        for(iteration = 0; iteration < ledgerSizes[sizeCounter]; iteration++)
+        {
+            updateTransactionDataInLedger(&ledger, iteration + 1, 1, 2, 1, 0);
+        }
+
+        iterationCount = 1000000;
+        startTime = getTimeInNanos();
+        for(iteration = 0; iteration < iterationCount; iteration++)
+        {
+            updateTransactionDataInLedger(&ledger, ledgerSizes[sizeCounter] + iteration + 1, 2, 1, 1, 0);
+        }
+        inPlaceTimeInNanos = (getTimeInNanos() - startTime) / iterationCount;
+        if(inPlaceTimeInNanos == 0)
+        {
+            inPlaceTimeInNanos = 1;
+        }
+
+        releaseLedger(&ledger);
+        releaseAccountIndex();
+
+        printf("%-14ld %-19lld %-19lld %.0fx\n", ledgerSizes[sizeCounter], byValueTimeInNanos, inPlaceTimeInNanos,
+        (double)byValueTimeInNanos / inPlaceTimeInNanos);
+    }
+}
+
+/*
+* Summary - This method will measure the cost of finding an account as the number of accounts grows (-B option).
+* Scanning the nodes for the node id, as the ledger did before the account index, is compared with the account index.
+*/
+void runAccountIndexBenchmark()
+{
+    // Declarations
+    int accountCounts[] = {16, 1024, 16384, 131072};
+    int accountCountCount = sizeof(accountCounts) / sizeof(accountCounts[0]);
+    int countCounter, counter, lookupCounter, nodeId;
+    long iterationCount, iteration;
+    long long startTime, scanTimeInNanos, indexTimeInNanos;
+    struct blockChainNode *nodes;
+    volatile long slotSum = 0;
+
+    printf("\033[0;36m");
+    printf("\nAccounts       Scan (ns/lookup)    Index (ns/lookup)   Speedup\n");
+    printf("\033[0m");
+
+    for(countCounter = 0; countCounter < accountCountCount; countCounter++)
+    {
+        nodes = malloc(accountCounts[countCounter] * sizeof(struct blockChainNode));
+        if(nodes == NULL)
+        {
+            fprintf(stderr, "The blockchain ran out of memory.\n");
+            exit(1);
+        }
+        initializeAccountIndex(accountCounts[countCounter]);
+        for(counter = 0; counter < accountCounts[countCounter]; counter++)
+        {
+            nodes[counter].nodeId = counter + 1;
+            addAccountToIndex(counter + 1, counter);
+        }
+
+        // Scan about 1G nodes per account count, so that every count takes a similar time.
+        iterationCount = (1L << 30) / accountCounts[countCounter];
+        startTime = getTimeInNanos();
+        for(iteration = 0; iteration < iterationCount; iteration++)
+        {
+            nodeId = (int)(iteration * 7919 % accountCounts[countCounter]) + 1;
+            for(lookupCounter = 0; lookupCounter < accountCounts[countCounter]; lookupCounter++)
+            {
+                if(nodes[lookupCounter].nodeId == nodeId)
+                {
+                    slotSum += lookupCounter;
+                    break;
+                }
             }
+        }
+        scanTimeInNanos = (getTimeInNanos() - startTime) / iterationCount;
+
+        iterationCount = 10000000;
+        startTime = getTimeInNanos();
+        for(iteration = 0; iteration < iterationCount; iteration++)
+        {
+            nodeId = (int)(iteration * 7919 % accountCounts[countCounter]) + 1;
+            slotSum += findAccountSlot(nodeId);
+        }
+        indexTimeInNanos = (getTimeInNanos() - startTime) / iterationCount;
+        if(indexTimeInNanos == 0)
+        {
+            indexTimeInNanos = 1;
+        }
+
+        releaseAccountIndex();
+        free(nodes);
+
+        printf("%-14d %-19lld %-19lld %.0fx\n", accountCounts[countCounter], scanTimeInNanos, indexTimeInNanos,
+        (double)scanTimeInNanos / indexTimeInNanos);
+    }
+}
 
-            // If receiver accepts the transaction, then update the local ledger.
-            // Add new transaction details in the local ledger.
-            if(_transactionStatus == ACCEPTED)
-            {
-                // Update the local ledger
-                localBlockChainData = updateTransactionDataInLedger(localBlockChainData, senderId, receiverId, 1);
-            }
+/*
+* Summary - This method will measure how fast every SHA-256 implementation the processor supports hashes pairs of hashes, as
+* the Merkle roots do, and how long the Merkle root of a million transactions takes with the chosen one (-B option).
+*/
+void runHashBenchmark()
+{
+    // Declarations
+    const char *implementations[] = {"scalar", "SHA-NI", "AVX2 multi-buffer"};
+    bool supported[] = {true, __builtin_cpu_supports("sha") && __builtin_cpu_supports("sse4.1"), __builtin_cpu_supports("avx2")};
+    long messageCount = 1 << 20, counter;
+    int implementationCounter;
+    unsigned char *messages;
+    long long startTime, elapsedTimeInNanos;
+    struct transactionLog log;
+    struct transaction *addedTransaction;
+    unsigned char merkleRoot[SHA256_DIGEST_SIZE];
+
+    messages = malloc(messageCount * 2 * SHA256_DIGEST_SIZE);
+    if(messages == NULL)
+    {
+        fprintf(stderr, "The blockchain ran out of memory.\n");
+        exit(1);
+    }
 
-             // Reset the global and local data
-            _senderId = 0;
-            isSender = false;
-            senderId = 0;
-            receiverId = 0;
+    printf("\033[0;36m");
+    printf("\nSHA-256              Hashes/s       MB/s\n");
+    printf("\033[0m");
 
-            pthread_mutex_unlock(&transactionLock);
+    for(implementationCounter = 0; implementationCounter < 3; implementationCounter++)
+    {
+        if(!supported[implementationCounter])
+        {
+            printf("%-20s not supported by the processor\n", implementations[implementationCounter]);
+            continue;
         }
 
-        if(isReceiver)
+        _sha256Transform = implementationCounter == 1 ? sha256TransformShaNi : sha256TransformScalar;
+        _sha256MultiBuffer = implementationCounter == 2;
+
+        for(counter = 0; counter < messageCount * 2 * SHA256_DIGEST_SIZE; counter++)
         {
-            pthread_mutex_lock(&transactionLock);
+            messages[counter] = (unsigned char)counter;
+        }
+        startTime = getTimeInNanos();
+        sha256Many(messages, 2 * SHA256_DIGEST_SIZE, messageCount, messages);
+        elapsedTimeInNanos = getTimeInNanos() - startTime;
 
-            // The receiver waits for a signal from the sender that a new transaction has started.
-            // Once it gets the signal from the sender, the sender waits for a signal from the receiver about the status of the transaction,
-            // and the receiver starts validating the transaction.
-            while(_loanAmount == 0)
-            {
-                pthread_cond_wait(&newTransaction, &transactionLock);
-            }
+        printf("%-20s %-14lld %.0f\n", implementations[implementationCounter], messageCount * 1000000000LL / elapsedTimeInNanos,
+        messageCount * 2 * SHA256_DIGEST_SIZE * 1000.0 / elapsedTimeInNanos);
+    }
 
-            printf("\nReceiver Node Id: ");
-            printf("\033[0;36m");
-            printf("%d", nodeId);
-            printf("\033[0m");
+    // Go back to the implementation chosen for the processor.
+    _sha256Transform = sha256TransformScalar;
+    _sha256MultiBuffer = false;
+    initializeSha256();
 
-            int receiverInitialAmount;
-            for(loopCounter = 0; loopCounter < maxNodes; loopCounter ++)
-            {
-                if(localBlockChainData.nodes[loopCounter].nodeId == nodeId)
-                {
-                    receiverInitialAmount = localBlockChainData.nodes[loopCounter].totalBitcoins;
-                    break;
-                }
-            }
+    memset(&log, 0, sizeof(log));
+    for(counter = 0; counter < 1000000; counter++)
+    {
+        addedTransaction = appendTransaction(&log);
+        memset(addedTransaction, 0, sizeof(struct transaction));
+        addedTransaction->transactionId = counter + 1;
+    }
+    startTime = getTimeInNanos();
+    computeMerkleRoot(&log, 0, 1000000, merkleRoot);
+    elapsedTimeInNanos = getTimeInNanos() - startTime;
+    printf("Merkle root of 1000000 transactions with %s: %.1f ms\n", _sha256Implementation, elapsedTimeInNanos / 1000000.0);
+
+    free(log.segments);
+    releaseArena(log.arena);
+    free(messages);
+}
 
-            printf("\nReceiver Initial Amount: ");
-            printf("\033[0;36m");
-            printf("%d", receiverInitialAmount);
-            printf("\033[0m");
+/*
+* Summary - This method will measure how many SHA-256d header hashes a single core searches per second, for every way of
+* searching nonces the processor supports (-B option). Multiplied by the number of cores, it gives the hashes per second
+* of a host.
+*/
+void runMiningBenchmark()
+{
+    printf("\033[0;36m");
+    printf("\nProof of work        Hashes/s per core\n");
+    printf("\033[0m");
 
-            // Validate the sender by using the localBlockChainData
-            int senderNodeLegitimate = isSenderNodeLegitimate(localBlockChainData);
+    _sha256Transform = sha256TransformScalar;
+    printf("%-20s %lld\n", "scalar", measureNonceSearch(searchNonces, 1 << 20));
+    if(__builtin_cpu_supports("sha") && __builtin_cpu_supports("sse4.1"))
+    {
+        _sha256Transform = sha256TransformShaNi;
+        printf("%-20s %lld\n", "SHA-NI", measureNonceSearch(searchNonces, 1 << 22));
+    }
+    if(__builtin_cpu_supports("avx2"))
+    {
+        printf("%-20s %lld\n", "AVX2 8-way", measureNonceSearch(searchNoncesAvx2, 1 << 22));
+    }
 
-            if(senderNodeLegitimate == 1)
-            {
-                // The sender is a valid node.
-                printf("\033[0;32m");
-                printf("\nThe receiver validated that the transaction is legitimate.");
-                printf("\nBroadcasting a request to other nodes to verify this transaction.\n");
-                printf("\033[0m");
+    // Go back to the implementation chosen for the processor.
+    _sha256Transform = sha256TransformScalar;
+    initializeSha256();
+}
 
-                // Inform the waiting validators, that the sender is valid.
-                // So that the validators, can validate the transaction.
-                _receiverTransactionValidity = VALID;
-                pthread_cond_broadcast(&transactionValidationStatusByReceiver);
+/*
+* Summary - This method will transfer an amount between two accounts of the global ledger, if the sender can afford it.
+* The locks of both accounts are taken in slot order, so that two transfers between the same accounts can not deadlock.
+* A committed transfer is logged at a position after the last transfers of both its accounts and of the worker, like a
+* Lamport clock, so that the transfers of an account are ordered without a counter shared by all the workers.
+* Param 1 - worker - the worker carrying out the transfer, whose log records it
+* Param 2 - senderId - the node id of the sender
+* Param 3 - receiverId - the node id of the receiver
+* Param 4 - amount - the amount to transfer
+* Returns 1, if the transfer is committed, else returns 0.
+*/
+int executeTransfer(struct transferWorker *worker, int senderId, int receiverId, int amount)
+{
+    // Declarations
+    int senderSlot = findAccountSlot(senderId), receiverSlot = findAccountSlot(receiverId);
+    int firstSlot = senderSlot < receiverSlot ? senderSlot : receiverSlot;
+    int secondSlot = senderSlot < receiverSlot ? receiverSlot : senderSlot;
+    int isCommitted = 0, position;
 
-                // As the sender is valid, the receiver waits to get transaction validation status response
-                // from all the validators.
-                int countOfValidators = maxNodes - 2;
-                while(countOfValidators != _countOfVotes)
-                {
-                    pthread_cond_wait(&validatedTransaction, &transactionLock);
-                }
+    pthread_mutex_lock(&_accountLocks[firstSlot].mutex);
+    pthread_mutex_lock(&_accountLocks[secondSlot].mutex);
 
-                // Once the transaction is validated by the validators, the receiver updates the transaction details in the local ledger.
-                localBlockChainData = updateTransactionDataInLedger(localBlockChainData, senderId, receiverId, 0);
-                // Then the receiver, updates the transaction details in the global ledger.
-                _blockChainData = updateTransactionDataInLedger(_blockChainData, senderId, receiverId, 0);
+    if(isSenderNodeLegitimate(&worker->ledger, senderId, amount) == 1)
+    {
+        position = worker->clock;
+        if(_accountLocks[firstSlot].clock > position)
+        {
+            position = _accountLocks[firstSlot].clock;
+        }
+        if(_accountLocks[secondSlot].clock > position)
+        {
+            position = _accountLocks[secondSlot].clock;
+        }
+        position++;
+        _accountLocks[firstSlot].clock = position;
+        _accountLocks[secondSlot].clock = position;
+        worker->clock = position;
 
-                int sendBalAmt, recBalAmt;
-                for(loopCounter = 0; loopCounter < maxNodes; loopCounter ++)
-                {
-                    if(localBlockChainData.nodes[loopCounter].nodeId == senderId)
-                    {
-                        sendBalAmt = localBlockChainData.nodes[loopCounter].totalBitcoins;
-                    }
+        updateTransactionDataInLedger(&worker->ledger, position, senderId, receiverId, amount, 0);
+        isCommitted = 1;
+    }
 
-                    if(localBlockChainData.nodes[loopCounter].nodeId == receiverId)
-                    {
-                        recBalAmt = localBlockChainData.nodes[loopCounter].totalBitcoins;
-                    }
-                }
+    pthread_mutex_unlock(&_accountLocks[secondSlot].mutex);
+    pthread_mutex_unlock(&_accountLocks[firstSlot].mutex);
 
-                printf("Receiver Balance Amount: ");
-                printf("\033[0;36m");
-                printf("%d", recBalAmt);
-                printf("\033[0m");
+    return isCommitted;
+}
 
-                printf("\nSender Balance Amount: ");
-                printf("\033[0;36m");
-                printf("%d", sendBalAmt);
-                printf("\033[0m");
+/*
+* Summary - This method will be executed by every worker of the parallel transaction engine. It carries out transfers of a
+* random amount between two random accounts.
+* Param 1 - argumentsData - the worker
+*/
+void *transferWorker(void *argumentsData)
+{
+    // Declarations
+    struct transferWorker *worker = argumentsData;
+    int senderId, receiverId, amount;
+    long counter;
 
-                printf("\033[0;33m");
-                printf("\n------------------SUCCESS---------------------\n");
-                printf("\033[0m");
+    for(counter = 0; counter < worker->transferCount; counter++)
+    {
+        senderId = rand_r(&worker->seed) % _numberOfNodes + 1;
+        receiverId = rand_r(&worker->seed) % (_numberOfNodes - 1) + 1;
+        if(receiverId >= senderId)
+        {
+            receiverId++;
+        }
+        amount = rand_r(&worker->seed) % 4 + 1;
 
-                // The sender informs the waiting sender, and the waiting validators that the transaction is valid,
-                // and hence it is accepted and processed by the receiver.
-                _transactionStatus = ACCEPTED;
-                pthread_cond_broadcast(&transactionStatus);
+        worker->committedCount += executeTransfer(worker, senderId, receiverId, amount);
+    }
 
-                // Reset the data
-                isReceiver = false;
-                _receiverId = 0;
-                senderId = 0;
-                receiverId = 0;
+    return NULL;
+}
 
-                pthread_mutex_unlock(&transactionLock);
-            }
-            else
+/*
+* Summary - This method will merge the transaction logs of the workers of the parallel transaction engine into the log of
+* the global ledger, in the order of the positions the transfers were logged at, and free them. The positions of the
+* transfers of an account grow one after the other, so in this order the logged balances of every account follow each other
+* as in a serial run; transfers at the same position have no account in common. The transfers get their ids in this order.
+* Param 1 - workers - the workers, each having logged its transfers in the order of their positions
+* Param 2 - workerCount - the number of workers
+*/
+void mergeTransferLogs(struct transferWorker *workers, int workerCount)
+{
+    // Declarations
+    long *positions;
+    int workerCounter, nextWorker;
+    struct transaction *nextTransaction = NULL, *candidateTransaction, *mergedTransaction;
+
+    positions = calloc(workerCount, sizeof(long));
+    if(positions == NULL)
+    {
+        fprintf(stderr, "The blockchain ran out of memory.\n");
+        exit(1);
+    }
+
+    while(1)
+    {
+        nextWorker = -1;
+        for(workerCounter = 0; workerCounter < workerCount; workerCounter++)
+        {
+            if(positions[workerCounter] < workers[workerCounter].ledger.transactions.transactionCount)
             {
-                // It will come here, if the sender node is invalid.
-                printf("\033[0;31m");
-                printf("\nThe recipient has verified that this is a fraudulent transaction and has consequently denied the bitcoins.");
-                printf("\033[0m");
-                printf("\033[0;33m");
-                printf("\n------------------FAILED---------------------\n");
-                printf("\033[0m");
+                candidateTransaction = getTransaction(&workers[workerCounter].ledger.transactions, positions[workerCounter]);
+                if(nextWorker == -1 || candidateTransaction->transactionId < nextTransaction->transactionId)
+                {
+                    nextWorker = workerCounter;
+                    nextTransaction = candidateTransaction;
+                }
+            }
+        }
+        if(nextWorker == -1)
+        {
+            break;
+        }
 
-                // The receiver informs the waiting validators, that the transaction is invalid.
-                _receiverTransactionValidity = INVALID;
-                pthread_cond_broadcast(&transactionValidationStatusByReceiver);
+        mergedTransaction = appendTransaction(&_blockChainData.transactions);
+        *mergedTransaction = *nextTransaction;
+        mergedTransaction->transactionId = ++_transactionId;
+        positions[nextWorker]++;
+    }
 
-                // The receiver informs the waiting sender that the transaction is declined.
-                _transactionStatus = DECLINED;
-                pthread_cond_broadcast(&transactionStatus);
+    // The nodes are shared with the global ledger, so only the transaction log of a worker is its own.
+    for(workerCounter = 0; workerCounter < workerCount; workerCounter++)
+    {
+        free(workers[workerCounter].ledger.transactions.segments);
+        releaseArena(workers[workerCounter].ledger.transactions.arena);
+    }
+    free(positions);
+}
 
-                // Reset the local and global data
-                isReceiver = false;
-                _receiverId = 0;
-                senderId = 0;
-                receiverId = 0;
+/*
+* Summary - This method will carry out the transactions as concurrent transfers between the nodes (-P option), once for
+* every number of threads from 1 up to the given maximum, doubling it every time. Every run starts from the same balances
+* and carries out the same number of transfers, and checks that no amount was created or lost. After every run, the logs
+* of the workers are merged into the global ledger and sealed into blocks, and the chain is verified.
+* Param 1 - maximumThreads - the largest number of threads
+*/
+void runTransferEngine(int maximumThreads)
+{
+    // Declarations
+    int *initialAmounts;
+    int counter, threadCount, workerCounter;
+    long long startTime, elapsedTimeInNanos, totalAmount, expectedTotalAmount = 0, baseTransfersPerSecond = 0;
+    long long transfersPerSecond;
+    long committedCount;
+    struct transferWorker *workers;
+    struct chainVerifier verifier;
+
+    initializeLedger(&_blockChainData);
+    initializeAccountIndex(_numberOfNodes);
+    initialAmounts = malloc(_numberOfNodes * sizeof(int));
+    _accountLocks = aligned_alloc(CACHE_LINE_SIZE, _numberOfNodes * sizeof(struct accountLock));
+    workers = aligned_alloc(CACHE_LINE_SIZE, maximumThreads * sizeof(struct transferWorker));
+    if(initialAmounts == NULL || _accountLocks == NULL || workers == NULL)
+    {
+        fprintf(stderr, "The blockchain ran out of memory.\n");
+        exit(1);
+    }
 
-                pthread_mutex_unlock(&transactionLock);
-            }
+    srand(time(NULL));
+    for(counter = 0; counter < _numberOfNodes; counter++)
+    {
+        initialAmounts[counter] = rand() % 19 + 1;
+        expectedTotalAmount += initialAmounts[counter];
+        addBlockchainNodeInGlobalLedger(counter + 1, initialAmounts[counter]);
+        pthread_mutex_init(&_accountLocks[counter].mutex, NULL);
+    }
+    if(_difficulty > 0)
+    {
+        startMiningPool();
+    }
+
+    printf("%d nodes, %d transactions per run\n", _numberOfNodes, _numberOfTransactions);
+    printf("\033[0;36m");
+    printf("Threads   Committed   Declined    Transactions/s   Speedup   Blocks\n");
+    printf("\033[0m");
+
+    for(threadCount = 1; ; threadCount *= 2)
+    {
+        if(threadCount > maximumThreads)
+        {
+            threadCount = maximumThreads;
         }
 
-        if(isValidator)
+        for(counter = 0; counter < _numberOfNodes; counter++)
         {
-            pthread_mutex_lock(&transactionLock);
+            _blockChainData.nodes[counter].totalBitcoins = initialAmounts[counter];
+            _accountLocks[counter].clock = 0;
+        }
+        _transactionId = 0;
 
-            // When a thread will become a validator, it will just wait to get the transaction validation status from the receiver.
-            // If the transaction validation status is INVALID, it means the transaction is declined by the receiver,
-            // and the validator just needs to reset the data and participate in another transaction.
-            while(_receiverTransactionValidity == 0)
+        // Every run starts a new chain.
+        free(_blockChainData.transactions.segments);
+        releaseArena(_blockChainData.transactions.arena);
+        memset(&_blockChainData.transactions, 0, sizeof(struct transactionLog));
+        _blockChainData.blockCount = 0;
+
+        for(workerCounter = 0; workerCounter < threadCount; workerCounter++)
+        {
+            memset(&workers[workerCounter], 0, sizeof(struct transferWorker));
+            workers[workerCounter].seed = rand();
+            workers[workerCounter].transferCount = _numberOfTransactions / threadCount +
+            (workerCounter < _numberOfTransactions % threadCount ? 1 : 0);
+            workers[workerCounter].ledger.nodes = _blockChainData.nodes;
+        }
+
+        startTime = getTimeInNanos();
+        for(workerCounter = 0; workerCounter < threadCount; workerCounter++)
+        {
+            if(pthread_create(&workers[workerCounter].thread, NULL, transferWorker, &workers[workerCounter]) != 0)
             {
-                pthread_cond_wait(&transactionValidationStatusByReceiver, &transactionLock);
+                fprintf(stderr, "Transfer thread %d could not be started, please use fewer threads.\n", workerCounter + 1);
+                exit(1);
             }
+        }
 
-            // If the transaction validation status is VALID, the validator will validate the sender,
-            // and will signal the receiver, that it has completed its validation.
-            if(_receiverTransactionValidity == VALID)
-            {
-                // Validate the sender
-                int senderNodeLegitimate = isSenderNodeLegitimate(localBlockChainData);
-                if(senderNodeLegitimate == 1)
-                {
-                    _countOfVotes = _countOfVotes + 1;
-                    printf("\033[0;32m");
-                    printf("+ ");
-                    printf("\033[0m");
-                    printf("Node %d confirmed the transaction as valid.\n", nodeId);
+        committedCount = 0;
+        for(workerCounter = 0; workerCounter < threadCount; workerCounter++)
+        {
+            pthread_join(workers[workerCounter].thread, NULL);
+            committedCount += workers[workerCounter].committedCount;
+        }
+        elapsedTimeInNanos = getTimeInNanos() - startTime;
 
-                    // Signal the receiver that trasaction is validated and it is valid.
-                    pthread_cond_signal(&validatedTransaction);
+        mergeTransferLogs(workers, threadCount);
+        sealFullBlocks(&_blockChainData);
+        if(getUnsealedTransactionCount(&_blockChainData) > 0)
+        {
+            sealBlock(&_blockChainData, getUnsealedTransactionCount(&_blockChainData));
+        }
+        memset(&verifier, 0, sizeof(verifier));
+        if(verifyNewBlocks(&_blockChainData, _blockChainData.blockCount, &_blockChainData.transactions, &verifier) == 0)
+        {
+            fprintf(stderr, "Block %d of the chain is invalid after the transfers.\n", verifier.verifiedBlockCount + 1);
+            exit(1);
+        }
 
-                    // Wait for the transaction status from the receiver.
-                    while(_transactionStatus == 0)
-                    {
-                        pthread_cond_wait(&transactionStatus, &transactionLock);
-                    }
+        totalAmount = 0;
+        for(counter = 0; counter < _numberOfNodes; counter++)
+        {
+            totalAmount += _blockChainData.nodes[counter].totalBitcoins;
+        }
+        if(totalAmount != expectedTotalAmount)
+        {
+            fprintf(stderr, "The nodes hold %lld bitcoins after the transfers, instead of %lld.\n", totalAmount, expectedTotalAmount);
+            exit(1);
+        }
 
-                    // If the trasaction is accepted and processed, then update the local ledger with the transaction details
-                    if(_transactionStatus == ACCEPTED)
-                    {
-                        // Update the local ledger
-                        localBlockChainData = updateTransactionDataInLedger(localBlockChainData, senderId, receiverId, 0);
-                    }
-                }
-            }
+        transfersPerSecond = elapsedTimeInNanos > 0 ? _numberOfTransactions * 1000000000LL / elapsedTimeInNanos : 0;
+        if(threadCount == 1)
+        {
+            baseTransfersPerSecond = transfersPerSecond > 0 ? transfersPerSecond : 1;
+        }
 
-            pthread_mutex_unlock(&transactionLock);
+        printf("%-9d %-11ld %-11ld %-16lld %-9.2f %d\n", threadCount, committedCount, _numberOfTransactions - committedCount,
+        transfersPerSecond, (double)transfersPerSecond / baseTransfersPerSecond, _blockChainData.blockCount);
 
-            // Reset the local data
-            isValidator = false;
-            senderId = 0;
-            receiverId = 0;
+        if(threadCount == maximumThreads)
+        {
+            break;
         }
     }
 
-    pthread_exit(0);
+    if(_difficulty > 0)
+    {
+        stopMiningPool();
+    }
+    for(counter = 0; counter < _numberOfNodes; counter++)
+    {
+        pthread_mutex_destroy(&_accountLocks[counter].mutex);
+    }
+    free(_accountLocks);
+    free(workers);
+    free(initialAmounts);
+    releaseAccountIndex();
+    releaseLedger(&_blockChainData);
 }
 
-int main()
+/*
+* Summary - This method will parse a number given as a command line option.
+* Param 1 - text - the option value
+* Param 2 - minimumValue - the smallest value allowed
+* Returns the number, or -1 if it is not a number of atleast minimumValue.
+*/
+int parseOptionValue(char *text, int minimumValue)
 {
     // Declarations
-    int counter;
-    pthread_t participatingNodes[MAXIMUM_NUMBER_OF_BLOCKCHAIN_NODES];
-    int nodeIds[MAXIMUM_NUMBER_OF_BLOCKCHAIN_NODES];
+    char *textEnd;
+    long value;
+
+    value = strtol(text, &textEnd, 10);
+    if(textEnd == text || *textEnd != '\0' || value < minimumValue || value > INT_MAX)
+    {
+        return -1;
+    }
+
+    return value;
+}
+
+int main(int argc, char *argv[])
+{
+    // Declarations
+    int counter, option;
+    bool runBenchmark = false;
+    int transferThreads = 0;
+    pthread_t *participatingNodes;
+    int *nodeIds;
+    long long startTime, elapsedTimeInNanos;
+
+    while((option = getopt(argc, argv, "n:t:b:a:w:Q:T:d:m:qBP:")) != -1)
+    {
+        if(option == 'n' && (_numberOfNodes = parseOptionValue(optarg, MINIMUM_NUMBER_OF_BLOCKCHAIN_NODES)) != -1)
+        {
+            continue;
+        }
+        if(option == 't' && (_numberOfTransactions = parseOptionValue(optarg, 1)) != -1)
+        {
+            continue;
+        }
+        if(option == 'b' && (_transactionsPerBlock = parseOptionValue(optarg, 1)) != -1)
+        {
+            continue;
+        }
+        if(option == 'a' && (_batchSize = parseOptionValue(optarg, 1)) != -1 && _batchSize <= MAXIMUM_BATCH_SIZE)
+        {
+            continue;
+        }
+        if(option == 'w' && (_batchWindowInMicros = parseOptionValue(optarg, 1)) != -1)
+        {
+            continue;
+        }
+        if(option == 'Q' && (_quorum = parseOptionValue(optarg, 1)) != -1)
+        {
+            continue;
+        }
+        if(option == 'T' && (_roundTimeoutInMillis = parseOptionValue(optarg, 1)) != -1)
+        {
+            continue;
+        }
+        if(option == 'd' && (_difficulty = parseOptionValue(optarg, 1)) != -1 && _difficulty <= MAXIMUM_DIFFICULTY)
+        {
+            continue;
+        }
+        if(option == 'm' && (_numberOfMiners = parseOptionValue(optarg, 1)) != -1 && _numberOfMiners <= MAXIMUM_NUMBER_OF_MINERS)
+        {
+            continue;
+        }
+        if(option == 'q')
+        {
+            _quiet = true;
+            continue;
+        }
+        if(option == 'B')
+        {
+            runBenchmark = true;
+            continue;
+        }
+        if(option == 'P' && (transferThreads = parseOptionValue(optarg, 1)) != -1 && transferThreads <= MAXIMUM_NUMBER_OF_TRANSFER_THREADS)
+        {
+            continue;
+        }
+
+        fprintf(stderr, "Usage: %s [-n nodes] [-t transactions] [-b transactions] [-a transactions] [-w microseconds] [-Q votes] [-T milliseconds]\n"
+        "[-d difficulty] [-m miners] [-q] [-B] [-P threads]\n"
+        "There must be atleast %d nodes, 1 transaction, 1 transaction per block, 1 to %d transactions per batch, a window of\n"
+        "atleast 1 microsecond, a quorum of atleast 1 vote, a timeout of atleast 1 millisecond, a difficulty of 1 to %d,\n"
+        "1 to %d miners, and 1 to %d threads.\n", argv[0], MINIMUM_NUMBER_OF_BLOCKCHAIN_NODES,
+        MAXIMUM_BATCH_SIZE, MAXIMUM_DIFFICULTY, MAXIMUM_NUMBER_OF_MINERS, MAXIMUM_NUMBER_OF_TRANSFER_THREADS);
+        exit(1);
+    }
+
+    // With 3f + 1 validators, a quorum of 2f + 1 of them still commits if f of them fail or lie.
+    if(_quorum == 0)
+    {
+        _quorum = _numberOfNodes - 2 == 0 ? 0 : (_numberOfNodes - 3) / 3 * 2 + 1;
+    }
+    if(_quorum > _numberOfNodes - 2)
+    {
+        fprintf(stderr, "The quorum can not be larger than the %d validators.\n", _numberOfNodes - 2);
+        exit(1);
+    }
+
+    initializeSha256();
+    if(_numberOfMiners == 0)
+    {
+        _numberOfMiners = sysconf(_SC_NPROCESSORS_ONLN) > MAXIMUM_NUMBER_OF_MINERS ? MAXIMUM_NUMBER_OF_MINERS : sysconf(_SC_NPROCESSORS_ONLN);
+    }
+
+    if(runBenchmark)
+    {
+        runLedgerBenchmark();
+        runAccountIndexBenchmark();
+        runHashBenchmark();
+        runMiningBenchmark();
+        return 0;
+    }
+
+    if(transferThreads > 0)
+    {
+        runTransferEngine(transferThreads);
+        return 0;
+    }
+
+    participatingNodes = malloc(_numberOfNodes * sizeof(pthread_t));
+    nodeIds = malloc(_numberOfNodes * sizeof(int));
+    if(participatingNodes == NULL || nodeIds == NULL)
+    {
+        fprintf(stderr, "The blockchain ran out of memory.\n");
+        exit(1);
+    }
+    initializeLedger(&_blockChainData);
+    initializeAccountIndex(_numberOfNodes);
+
+    // The validators read the blocks of the global ledger without a lock, while the receivers seal new ones, so room is made
+    // for every block the nodes can seal, and the blocks never move while the nodes run.
+    reserveBlocks(&_blockChainData, _numberOfTransactions / _transactionsPerBlock + 1);
 
     srand(time(NULL));
 
-    // Initialize the mutex, conditional variable, semaphore
-    pthread_cond_init(&newTransaction, NULL);
-    pthread_cond_init(&validateTransaction, NULL);
-    pthread_cond_init(&transactionValidationStatusByReceiver, NULL);
-    pthread_cond_init(&transactionStatus, NULL);
-    pthread_cond_init(&validatedTransaction, NULL);
-    pthread_mutex_init(&transactionLock, NULL);
-    sem_init(&readerLock, 0, 1);
-    sem_init(&writerLock, 0, 1);
+    // Initialize the mutex, barrier, inboxes
+    pthread_mutex_init(&ledgerWriterLock, NULL);
+    pthread_barrier_init(&accountsRegistered, NULL, _numberOfNodes);
+    initializeInboxes();
+    initializeBatches();
+    if(_difficulty > 0)
+    {
+        startMiningPool();
+    }
 
-    for(counter = 0; counter < MAXIMUM_NUMBER_OF_BLOCKCHAIN_NODES; counter++)
+    for(counter = 0; counter < _numberOfNodes; counter++)
     {
         nodeIds[counter] = counter + 1;
     }
 
-    for(counter = 0; counter < MAXIMUM_NUMBER_OF_BLOCKCHAIN_NODES; counter++)
+    startTime = getTimeInNanos();
+    for(counter = 0; counter < _numberOfNodes; counter++)
     {
-        pthread_create(&participatingNodes[counter], NULL, (void *)blockChainNode, (void *)&nodeIds[counter]);
+        if(pthread_create(&participatingNodes[counter], NULL, (void *)blockChainNode, (void *)&nodeIds[counter]) != 0)
+        {
+            // The roles go round all the nodes, so the network can not run without all of them.
+            fprintf(stderr, "Node %d could not be started, please use fewer nodes.\n", nodeIds[counter]);
+            exit(1);
+        }
     }
 
-    for(counter = 0; counter < MAXIMUM_NUMBER_OF_BLOCKCHAIN_NODES; counter++)
+    for(counter = 0; counter < _numberOfNodes; counter++)
     {
         pthread_join(participatingNodes[counter], NULL);
     }
+    elapsedTimeInNanos = getTimeInNanos() - startTime;
 
-    // Destroy the mutex, conditional variable, semaphore
-    sem_destroy(&readerLock);
-    sem_destroy(&writerLock);
-
-    pthread_mutex_destroy(&transactionLock);
-    pthread_cond_destroy(&newTransaction);
-    pthread_cond_destroy(&validateTransaction);
-    pthread_cond_destroy(&transactionValidationStatusByReceiver);
-    pthread_cond_destroy(&transactionStatus);
-    pthread_cond_destroy(&validatedTransaction);
+    // Destroy the mutex, barrier, inboxes
+    pthread_mutex_destroy(&ledgerWriterLock);
+    pthread_barrier_destroy(&accountsRegistered);
+    releaseInboxes();
+    releaseBatches();
 
     printf("\033[0;35m");
     printf("\n----------- ALL TRANSACTIONS ARE EXECUTED -----------\n");
@@ -748,32 +3167,86 @@ int main()
     printf("\033[0m");
 
     int loopCounter;
-    for(loopCounter = 0; loopCounter < MAXIMUM_NUMBER_OF_BLOCKCHAIN_NODES; loopCounter++)
+    struct transaction *loggedTransaction;
+    struct chainVerifier verifier;
+    char hashText[2 * SHA256_DIGEST_SIZE + 1];
+    for(loopCounter = 0; loopCounter < _numberOfNodes; loopCounter++)
     {
         printf("%d            %d\n", _blockChainData.nodes[loopCounter].nodeId, _blockChainData.nodes[loopCounter].totalBitcoins);
     }
 
     printf("\n------------Transaction Data------------\n");
-    printf("\033[0;36m");
-    printf("Id - SId - RId - SPrevAmt - TransAmt - SBalAmt - RPrevAmt - RBalAmt\n");
-    printf("\033[0m");
-
-    for(loopCounter = 0; loopCounter < MAXIMUM_NUMBER_OF_ALLOWED_TRANSACTIONS; loopCounter++)
+    printf("%ld of %d transactions were successful.\n", _blockChainData.transactions.transactionCount, _numberOfTransactions);
+    printf("%ld batches of up to %d transactions: %.0f transactions/s decided, %.0f committed,\n", _batchCount, _batchSize,
+    _transactionCounter * 1e9 / elapsedTimeInNanos, _blockChainData.transactions.transactionCount * 1e9 / elapsedTimeInNanos);
+    printf("committed after %.1f us on average, %.1f us at most.\n",
+    _blockChainData.transactions.transactionCount > 0 ? _totalLatencyInNanos / 1000.0 / _blockChainData.transactions.transactionCount : 0,
+    _maximumLatencyInNanos / 1000.0);
+    printf("Quorum of %d of %d validators: %ld rounds committed, %ld rejected, %ld timed out, %ld late votes.\n", _quorum,
+    _numberOfNodes - 2, _committedRoundCount, _rejectedRoundCount, _timedOutRoundCount, _lateVoteCount);
+
+    if(!_quiet)
     {
-        if(_blockChainData.transactions[loopCounter].transactionAdded == 1)
+        printf("\033[0;36m");
+        printf("Id - SId - RId - SPrevAmt - TransAmt - SBalAmt - RPrevAmt - RBalAmt\n");
+        printf("\033[0m");
+
+        for(loopCounter = 0; loopCounter < _blockChainData.transactions.transactionCount; loopCounter++)
         {
+            loggedTransaction = getTransaction(&_blockChainData.transactions, loopCounter);
             printf("%d - %d - %d - %d - %d - %d - %d - %d\n",
-            _blockChainData.transactions[loopCounter].transactionId,
-            _blockChainData.transactions[loopCounter].senderId,
-            _blockChainData.transactions[loopCounter].receiverId,
-            _blockChainData.transactions[loopCounter].senderPreviousAmount,
-            _blockChainData.transactions[loopCounter].transactionAmount,
-            _blockChainData.transactions[loopCounter].senderBalanceAmount,
-            _blockChainData.transactions[loopCounter].receiverPreviousAmount,
-            _blockChainData.transactions[loopCounter].receiverBalanceAmount);
+            loggedTransaction->transactionId,
+            loggedTransaction->senderId,
+            loggedTransaction->receiverId,
+            loggedTransaction->senderPreviousAmount,
+            loggedTransaction->transactionAmount,
+            loggedTransaction->senderBalanceAmount,
+            loggedTransaction->receiverPreviousAmount,
+            loggedTransaction->receiverBalanceAmount);
+        }
+    }
+
+    // The last transactions go into a block of their own, even if it is not full.
+    if(getUnsealedTransactionCount(&_blockChainData) > 0)
+    {
+        sealBlock(&_blockChainData, getUnsealedTransactionCount(&_blockChainData));
+    }
+
+    printf("\n------------Blocks------------\n");
+    memset(&verifier, 0, sizeof(verifier));
+    if(verifyNewBlocks(&_blockChainData, _blockChainData.blockCount, &_blockChainData.transactions, &verifier) == 1)
+    {
+        printf("The chain of %d blocks is valid, hashed with the %s SHA-256 implementation.\n", _blockChainData.blockCount, _sha256Implementation);
+    }
+    else
+    {
+        printf("Block %d of the chain is invalid.\n", verifier.verifiedBlockCount + 1);
+    }
+
+    if(!_quiet)
+    {
+        printf("\033[0;36m");
+        printf("Block - Transactions - Nonce - Hash\n");
+        printf("\033[0m");
+
+        for(loopCounter = 0; loopCounter < _blockChainData.blockCount; loopCounter++)
+        {
+            formatHash(_blockChainData.blocks[loopCounter].blockHash, hashText);
+            printf("%d - %d - %u - %s\n", _blockChainData.blocks[loopCounter].header.blockNumber,
+            _blockChainData.blocks[loopCounter].header.transactionCount, _blockChainData.blocks[loopCounter].header.nonce, hashText);
         }
     }
 
+    if(_difficulty > 0)
+    {
+        stopMiningPool();
+    }
+
+    releaseLedger(&_blockChainData);
+    releaseAccountIndex();
+    free(participatingNodes);
+    free(nodeIds);
+
     return 0;
 }
 